@@ -0,0 +1,96 @@
+#include "Benchmark.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <ctime>
+#include <algorithm>
+
+volatile char Benchmark::sink = 0;
+
+Benchmark::Benchmark() : minTime(1.0), minRuns(3), maxRuns(1000) {}
+
+
+bool Benchmark::enabled(const string& name) const {
+    return filter.empty() || name.find(filter) != string::npos;
+}
+
+
+void Benchmark::run(const string& name, size_t items, const function<void()>& body,
+                    const function<void()>& setup, size_t bytes) {
+    if (!enabled(name)) return;
+
+    vector<double> samples;     // ms por execução
+    double total = 0.0;
+
+    while ((int)samples.size() < maxRuns && ((int)samples.size() < minRuns || total < minTime * 1000.0)) {
+        if (setup) setup();
+
+        auto start = chrono::steady_clock::now();
+        body();
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        samples.push_back(ms);
+        total += ms;
+    }
+
+    sort(samples.begin(), samples.end());
+
+    Result result;
+    result.name = name;
+    result.items = items;
+    result.bytes = bytes;
+    result.runs = (int)samples.size();
+    result.minMs = samples.front();
+    result.maxMs = samples.back();
+    result.meanMs = total / samples.size();
+    size_t middle = samples.size() / 2;
+    result.medianMs = samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) * 0.5;
+    result.itemsPerSecond = result.medianMs > 0.0 ? items / (result.medianMs / 1000.0) : 0.0;
+    results.push_back(result);
+
+    cout << left << setw(48) << name << right << fixed << setprecision(3)
+         << setw(12) << result.medianMs << " ms" << setw(14) << setprecision(0) << result.itemsPerSecond
+         << " itens/s  (" << result.runs << " execucoes";
+    if (bytes > 0) cout << ", " << setprecision(1) << bytes / (result.medianMs / 1000.0) / (1024.0 * 1024.0) << " MB/s";
+    cout << ")" << endl;
+}
+
+
+bool Benchmark::writeJSON(const string& path) const {
+    ofstream file(path);
+    if (!file) {
+        cerr << "Falha ao gravar " << path << endl;
+        return false;
+    }
+
+    time_t now = time(nullptr);
+    char date[32];
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+#ifdef __OPTIMIZE__
+    const char* optimized = "true";
+#else
+    const char* optimized = "false";
+#endif
+
+    file << "{\n  \"version\": 1,\n  \"date\": \"" << date << "\",\n";
+#ifdef __VERSION__
+    file << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+#endif
+    file << "  \"optimized\": " << optimized << ",\n  \"results\": [";
+
+    file << setprecision(6) << fixed;
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        file << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name << "\", \"items\": " << r.items
+             << ", \"bytes\": " << r.bytes << ", \"runs\": " << r.runs
+             << ", \"min_ms\": " << r.minMs << ", \"median_ms\": " << r.medianMs
+             << ", \"mean_ms\": " << r.meanMs << ", \"max_ms\": " << r.maxMs
+             << ", \"items_per_second\": " << setprecision(1) << r.itemsPerSecond << setprecision(6) << "}";
+    }
+    file << "\n  ]\n}\n";
+
+    cout << results.size() << " resultados gravados em " << path << endl;
+    return true;
+}
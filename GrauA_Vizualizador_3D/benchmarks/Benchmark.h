@@ -0,0 +1,58 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+using namespace std;
+
+// Executor dos microbenchmarks: repete cada caso até atingir o tempo mínimo (e o número mínimo de
+// execuções), guarda mínimo/mediana/média/máximo por execução e grava tudo em JSON
+// (comparado entre versões por compare_benchmarks.py)
+class Benchmark {
+public:
+    struct Result {
+        string name;            // "Classe::metodo/parametro"
+        size_t items;           // itens processados por execução (faces, vértices, raios...)
+        size_t bytes;           // bytes lidos por execução (0 = não se aplica)
+        int runs;
+        double minMs, medianMs, meanMs, maxMs;
+        double itemsPerSecond;  // pela mediana
+    };
+
+    double minTime;     // segundos medidos por caso (padrão 1 s)
+    int minRuns;        // execuções mínimas por caso, mesmo que passem do tempo (padrão 3)
+    int maxRuns;        // limite para casos muito rápidos (padrão 1000)
+    string filter;      // só executa os casos cujo nome contém este texto
+
+    vector<Result> results;
+
+    Benchmark();
+
+    // true se o caso deve ser executado (filtro); use antes de preparar dados caros
+    bool enabled(const string& name) const;
+
+    // Mede "body"; cada chamada processa "items" itens. "setup", se houver, roda antes de cada
+    // execução, fora da medida (ex.: limpar vetores preenchidos pela execução anterior)
+    void run(const string& name, size_t items, const function<void()>& body,
+             const function<void()>& setup = nullptr, size_t bytes = 0);
+
+    bool writeJSON(const string& path) const;
+
+    // Impede o compilador de descartar um resultado que não é usado depois
+    template <typename T>
+    static inline void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r"(&value) : "memory");
+#else
+        sink = *reinterpret_cast<const volatile char*>(&value);
+#endif
+    }
+
+private:
+    static volatile char sink;
+};
+
+#endif
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+# Compara dois resultados dos microbenchmarks (JSON gravado por "benchmarks --out")
+# e sinaliza os casos que ficaram mais lentos que o limite.
+#
+# Uso: python3 compare_benchmarks.py base.json novo.json [--threshold 10] [--metric median_ms]
+# Código de saída 1 se algum caso regrediu acima do limite (para uso em scripts de CI).
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as file:
+        data = json.load(file)
+    return data, {result["name"]: result for result in data["results"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compara resultados dos microbenchmarks")
+    parser.add_argument("base")
+    parser.add_argument("novo")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="regressao maxima aceita, em porcentagem (padrao 10)")
+    parser.add_argument("--metric", default="median_ms", choices=["median_ms", "min_ms", "mean_ms"],
+                        help="tempo comparado (padrao median_ms; min_ms e menos sensivel a ruido)")
+    args = parser.parse_args()
+
+    baseData, base = load(args.base)
+    newData, new = load(args.novo)
+
+    for key in ("compiler", "optimized"):
+        if baseData.get(key) != newData.get(key):
+            print(f"Aviso: {key} diferente ({baseData.get(key)} x {newData.get(key)})")
+
+    regressions = 0
+    print(f"{'caso':<48} {'base':>12} {'novo':>12} {'variacao':>10}")
+    for name, result in new.items():
+        if name not in base:
+            print(f"{name:<48} {'-':>12} {result[args.metric]:>9.3f} ms {'novo':>10}")
+            continue
+
+        before = base[name][args.metric]
+        after = result[args.metric]
+        change = (after - before) / before * 100.0 if before > 0 else 0.0
+
+        flag = ""
+        if change > args.threshold:
+            flag = "  << REGRESSAO"
+            regressions += 1
+        elif change < -args.threshold:
+            flag = "  melhora"
+
+        print(f"{name:<48} {before:>9.3f} ms {after:>9.3f} ms {change:>+9.1f}%{flag}")
+
+    for name in base:
+        if name not in new:
+            print(f"{name:<48} ausente no resultado novo")
+
+    if regressions:
+        print(f"{regressions} caso(s) acima do limite de {args.threshold:.1f}% ({args.metric})")
+        return 1
+    print(f"Nenhuma regressao acima de {args.threshold:.1f}% ({args.metric})")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
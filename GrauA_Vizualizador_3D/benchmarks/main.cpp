@@ -0,0 +1,720 @@
+/***   Microbenchmarks do Visualizador 3D (sem contexto OpenGL)   ***/
+
+/*** Mede os caminhos quentes de CPU do carregamento, da geometria e das colisões:
+        * OBJReader::readFileOBJ em arquivos sintéticos (100k e 1M faces por padrão)
+        * decodificação de 200 texturas com stb_image, em série e em um ThreadPool (carga da cena)
+        * MipChain::build (mipmaps na CPU, filtros box e Kaiser)
+        * BlockCompression::encode (vazão do encoder BC1/BC3/BC7 do TextureCooker)
+        * leitura e carga "a frio" de uma cena gerada: arquivos soltos x AssetPack (com e sem LZ4)
+        * LZ4Block::decompress (entradas comprimidas do AssetPack)
+        * leitura em lote (FileReader: io_uring, pread) x ifstream, só os bytes e na carga do AssetLoader
+        * Face::triangulate em polígonos de n lados
+        * Group::buildVertexData (parte de CPU de Group::setupBuffers)
+        * Mesh::calculateBoundingBox e Mesh::rayIntersect
+        * OBJ3D::getTransformedBoundingBox e OBJ3D::rayIntersect
+        * JobSystem: custo por job (x ThreadPool) e escala do parallelFor no culling (1 a 8 threads)
+        * Log: custo de uma mensagem na thread que registra (anel + thread de fundo) x ofstream com endl
+     Resultados em JSON (--out), comparáveis com compare_benchmarks.py
+***/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <set>
+#include <algorithm>
+#include <filesystem>
+#include <stb_image.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "Benchmark.h"
+#include "OBJReader.h"
+#include "Face.h"
+#include "Group.h"
+#include "Mesh.h"
+#include "OBJ3D.h"
+#include "ThreadPool.h"
+#include "MipChain.h"
+#include "BlockCompression.h"
+#include "SceneGenerator.h"
+#include "AssetPack.h"
+#include "LZ4Block.h"
+#include "FileReader.h"
+#include "AssetLoader.h"
+#include "JobSystem.h"
+#include "Frustum.h"
+#include "Log.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace std;
+
+namespace {
+
+    // Gera um OBJ com "faceCount" triângulos sobre uma grade (v, vt e vn por vértice, grupos de 65536 faces),
+    // no formato dos modelos da pasta models/
+    bool generateOBJ(const string& path, size_t faceCount, size_t& fileSize) {
+        FILE* file = fopen(path.c_str(), "w");
+        if (!file) {
+            cerr << "Falha ao criar " << path << endl;
+            return false;
+        }
+
+        size_t columns = 1;
+        while (columns * columns * 2 < faceCount) columns++;
+        size_t rows = (faceCount + columns * 2 - 1) / (columns * 2);
+
+        fprintf(file, "# OBJ sintetico: %zu faces\n", faceCount);
+        for (size_t row = 0; row <= rows; row++) {
+            for (size_t column = 0; column <= columns; column++) {
+                float x = (float)column / columns, z = (float)row / rows;
+                fprintf(file, "v %.6f %.6f %.6f\n", x * 10.0f - 5.0f, 0.25f * x * z, z * 10.0f - 5.0f);
+                fprintf(file, "vt %.6f %.6f\n", x, z);
+                fprintf(file, "vn %.6f %.6f %.6f\n", -0.25f * z, 1.0f, -0.25f * x);
+            }
+        }
+
+        size_t written = 0;
+        for (size_t row = 0; row < rows && written < faceCount; row++) {
+            for (size_t column = 0; column < columns && written < faceCount; column++) {
+                // índices do OBJ começam em 1
+                size_t a = row * (columns + 1) + column + 1, b = a + 1;
+                size_t c = a + columns + 1, d = c + 1;
+                size_t triangles[2][3] = { { a, b, d }, { a, d, c } };
+
+                for (int t = 0; t < 2 && written < faceCount; t++, written++) {
+                    if (written % 65536 == 0) fprintf(file, "g parte_%zu\n", written / 65536);
+                    fprintf(file, "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n",
+                            triangles[t][0], triangles[t][0], triangles[t][0],
+                            triangles[t][1], triangles[t][1], triangles[t][1],
+                            triangles[t][2], triangles[t][2], triangles[t][2]);
+                }
+            }
+        }
+
+        fileSize = (size_t)ftell(file);
+        fclose(file);
+        return true;
+    }
+
+
+    // Polígono de "sides" lados com índices de textura e normal
+    Face makePolygon(unsigned int first, unsigned int sides) {
+        Face face;
+        for (unsigned int i = 0; i < sides; i++) {
+            face.vertexIndices.push_back(first + i);
+            face.textureIndices.push_back(first + i);
+            face.normalIndices.push_back(1);
+        }
+        return face;
+    }
+
+
+    // Grade de quads (triangulados por Group::addFace) com posições, coordenadas de textura e normais
+    void buildGrid(unsigned int columns, unsigned int rows, Group& group,
+                   vector<glm::vec3>& vertices, vector<glm::vec2>& texCoords, vector<glm::vec3>& normals) {
+        for (unsigned int row = 0; row <= rows; row++) {
+            for (unsigned int column = 0; column <= columns; column++) {
+                vertices.emplace_back((float)column, 0.0f, (float)row);
+                texCoords.emplace_back((float)column / columns, (float)row / rows);
+            }
+        }
+        normals.emplace_back(0.0f, 1.0f, 0.0f);
+
+        for (unsigned int row = 0; row < rows; row++) {
+            for (unsigned int column = 0; column < columns; column++) {
+                unsigned int a = row * (columns + 1) + column + 1, b = a + 1;
+                unsigned int c = a + columns + 1, d = c + 1;
+                group.addFace(Face({ a, b, d, c }, { a, b, d, c }, { 1, 1, 1, 1 }));
+            }
+        }
+    }
+
+
+    vector<size_t> parseSizes(const string& list) {
+        vector<size_t> sizes;
+        stringstream stream(list);
+        string item;
+        while (getline(stream, item, ',')) {
+            if (!item.empty()) sizes.push_back((size_t)strtoull(item.c_str(), nullptr, 10));
+        }
+        return sizes;
+    }
+
+
+    vector<string> parseList(const string& list) {
+        vector<string> items;
+        stringstream stream(list);
+        string item;
+        while (getline(stream, item, ',')) {
+            if (!item.empty()) items.push_back(item);
+        }
+        return items;
+    }
+
+
+    size_t fileSize(const string& path) {
+        ifstream file(path, ios::binary | ios::ate);
+        return file ? (size_t)file.tellg() : 0;
+    }
+
+
+    // Decodifica uma imagem como o AssetLoader (canais do arquivo) e descarta os pixels
+    void decodeTexture(const string& path) {
+        int width, height, channels;
+        unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+        if (data) stbi_image_free(data);
+    }
+
+
+    // Tira o arquivo do cache de páginas do sistema: a próxima leitura vem do disco (carga "a frio").
+    // Sem equivalente sem privilégios no Windows; lá os casos de carga medem o cache quente
+    void evictFromCache(const string& path) {
+#if !defined(_WIN32) && defined(POSIX_FADV_DONTNEED)
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+#endif
+    }
+
+
+    // Configuração da cena e os modelos e texturas que ela usa (sem repetição), lidos como em
+    // System::readFileConfiguration: do pacote montado ou do disco
+    vector<string> sceneFiles(const string& scenePath) {
+        vector<string> files = { scenePath };
+        set<string> seen = { scenePath };
+
+        AssetStream scene(scenePath);
+        string line;
+        while (getline(scene, line)) {
+            if (line.empty() || line[0] == '#') continue;
+
+            // Nome Path posX posY posZ rotX rotY rotZ scaleX scaleY scaleZ eliminável textura
+            istringstream fields(line);
+            string name, model, texture;
+            float value;
+            int eliminable;
+            fields >> name >> model;
+            for (int i = 0; i < 9; i++) fields >> value;
+            fields >> eliminable >> texture;
+
+            if (seen.insert(model).second) files.push_back(model);
+            if (!texture.empty() && seen.insert(texture).second) files.push_back(texture);
+        }
+        return files;
+    }
+
+
+    // Só a leitura dos bytes de cada arquivo (sem OBJReader nem stb_image): do pacote montado ou do disco
+    size_t readFiles(const vector<string>& files) {
+        size_t checksum = 0;
+        vector<char> buffer;
+        for (const string& path : files) {
+            AssetView view;
+            if (AssetPack::find(path, view)) {
+                for (size_t i = 0; i < view.size; i += 4096) checksum += view.data[i];   // toca cada página
+                continue;
+            }
+            ifstream file(path, ios::binary | ios::ate);
+            buffer.resize((size_t)file.tellg());
+            file.seekg(0);
+            file.read(buffer.data(), buffer.size());
+            checksum += buffer.empty() ? 0 : (unsigned char)buffer[0];
+        }
+        return checksum;
+    }
+
+
+    // Carga da cena sem OpenGL: configuração, cada malha (OBJReader) e cada textura decodificada
+    void loadScene(const string& scenePath) {
+        vector<string> files = sceneFiles(scenePath);
+        for (size_t i = 1; i < files.size(); i++) {
+            const string& path = files[i];
+            if (path.size() > 4 && path.compare(path.size() - 4, 4, ".obj") == 0) {
+                vector<glm::vec3> vertices, normals;
+                vector<glm::vec2> texCoords;
+                vector<Group> groups;
+                OBJReader::readFileOBJ(path, vertices, texCoords, normals, groups);
+            } else {
+                int width, height, channels;
+                unsigned char* data = AssetPack::loadImage(path, &width, &height, &channels, 0);
+                if (data) stbi_image_free(data);
+            }
+        }
+    }
+}
+
+
+int main(int argc, char** argv) {
+    Benchmark bench;
+    string outputPath = "benchmark_results.json";
+    string tempDirectory = ".";
+    vector<size_t> objSizes = { 100000, 1000000 };     // 10M faces (minutos por execução) só com --obj-faces
+    // texturas da pasta textures/ de até 1024x1024, repetidas até "textureCount" arquivos
+    vector<string> texturePaths = { "textures/woodTexture.jpg", "textures/vulcan.png", "textures/gold.png" };
+    size_t textureCount = 200;
+    unsigned int decodeThreads = 0;
+
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (argument == "--out" && hasValue) {
+            outputPath = argv[++i];
+        } else if (argument == "--filter" && hasValue) {
+            bench.filter = argv[++i];
+        } else if (argument == "--min-time" && hasValue) {
+            bench.minTime = atof(argv[++i]);
+        } else if (argument == "--min-runs" && hasValue) {
+            bench.minRuns = max(1, atoi(argv[++i]));
+        } else if (argument == "--obj-faces" && hasValue) {
+            objSizes = parseSizes(argv[++i]);
+        } else if (argument == "--tmp" && hasValue) {
+            tempDirectory = argv[++i];
+        } else if (argument == "--textures" && hasValue) {
+            texturePaths = parseList(argv[++i]);
+        } else if (argument == "--texture-count" && hasValue) {
+            textureCount = (size_t)max(1, atoi(argv[++i]));
+        } else if (argument == "--decode-threads" && hasValue) {
+            decodeThreads = (unsigned int)max(0, atoi(argv[++i]));
+        } else {
+            cerr << "Uso: benchmarks [--out resultados.json] [--filter texto] [--min-time segundos] [--min-runs N]"
+                 << " [--obj-faces 100000,1000000] [--tmp diretorio]"
+                 << " [--textures a.jpg,b.png] [--texture-count 200] [--decode-threads N]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // os arquivos temporários (OBJs, cena, packs, log) vão para "--tmp": cria o diretório se faltar
+    error_code tempError;
+    filesystem::create_directories(tempDirectory, tempError);
+    if (tempError || !filesystem::is_directory(tempDirectory)) {
+        cerr << "Falha ao criar o diretorio temporario " << tempDirectory
+             << (tempError ? " (" + tempError.message() + ")" : string()) << endl;
+        return EXIT_FAILURE;
+    }
+
+#ifndef __OPTIMIZE__
+    cout << "Aviso: build sem otimizacao (use -O2 para resultados comparaveis)" << endl;
+#endif
+
+    // Leitura de OBJ: o arquivo é gerado uma vez por tamanho e apagado no final
+    for (size_t faceCount : objSizes) {
+        string name = "OBJReader::readFileOBJ/" + to_string(faceCount);
+        if (!bench.enabled(name)) continue;
+
+        string path = tempDirectory + "/benchmark_" + to_string(faceCount) + ".obj";
+        size_t fileSize = 0;
+        if (!generateOBJ(path, faceCount, fileSize)) return EXIT_FAILURE;
+
+        vector<glm::vec3> vertices, normals;
+        vector<glm::vec2> texCoords;
+        vector<Group> groups;
+
+        bench.run(name, faceCount,
+                  [&]() { OBJReader::readFileOBJ(path, vertices, texCoords, normals, groups); },
+                  [&]() { groups.clear(); },    // libera as faces da execução anterior fora da medida
+                  fileSize);
+
+        remove(path.c_str());
+    }
+
+    // Decodificação das texturas da cena na carga: em série (como Texture::loadTexture) e no ThreadPool
+    // do AssetLoader, com todos os núcleos (a thread principal só espera)
+    string serialName = "TextureDecode::serial/" + to_string(textureCount);
+    string parallelName = "TextureDecode::parallel/" + to_string(textureCount);
+    if ((bench.enabled(serialName) || bench.enabled(parallelName)) && !texturePaths.empty()) {
+        vector<string> paths;
+        size_t totalBytes = 0;
+        for (size_t i = 0; i < textureCount; i++) {
+            paths.push_back(texturePaths[i % texturePaths.size()]);
+            totalBytes += fileSize(paths.back());
+        }
+
+        if (bench.enabled(serialName)) {
+            bench.run(serialName, textureCount, [&]() {
+                for (const string& path : paths) decodeTexture(path);
+            }, nullptr, totalBytes);
+        }
+
+        if (bench.enabled(parallelName)) {
+            unsigned int threads = decodeThreads > 0 ? decodeThreads : max(1u, thread::hardware_concurrency());
+            ThreadPool pool;
+            pool.start(threads, "decode");
+            bench.run(parallelName, textureCount, [&]() {
+                for (const string& path : paths) pool.submit([&path]() { decodeTexture(path); });
+                pool.wait();
+            }, nullptr, totalBytes);
+            pool.stop();
+        }
+    }
+
+    // Cadeia de mipmaps de uma imagem RGBA 1024x1024 (nível 0 de uma camada do texture array)
+    for (MipFilter filter : { MIP_FILTER_BOX, MIP_FILTER_KAISER }) {
+        string name = string("MipChain::build/") + MipChain::filterName(filter) + "/1024";
+        if (!bench.enabled(name)) continue;
+
+        mt19937 noise(7);
+        vector<unsigned char> image((size_t)1024 * 1024 * 4);
+        for (auto& value : image) value = (unsigned char)(noise() & 255);
+
+        vector<MipLevel> levels;
+        bench.run(name, (size_t)1024 * 1024, [&]() {
+            MipChain::build(image.data(), 1024, 1024, 4, filter, levels);
+            Benchmark::keep(levels);
+        }, nullptr, image.size());
+    }
+
+    // Compressão em blocos de uma imagem RGBA 1024x1024: gradiente com ruído leve (perto de uma foto;
+    // ruído puro seria o pior caso do encoder) e alfa variável para o BC3/BC7
+    for (BlockFormat format : { BLOCK_BC1, BLOCK_BC3, BLOCK_BC7 }) {
+        string name = string("BlockCompression::encode/") + BlockCompression::formatName(format) + "/1024";
+        if (!bench.enabled(name)) continue;
+
+        mt19937 noise(11);
+        vector<unsigned char> image((size_t)1024 * 1024 * 4);
+        for (size_t y = 0; y < 1024; y++) {
+            for (size_t x = 0; x < 1024; x++) {
+                unsigned char* texel = &image[(y * 1024 + x) * 4];
+                texel[0] = (unsigned char)min(255u, (unsigned int)(x / 4) + (unsigned int)(noise() % 8));
+                texel[1] = (unsigned char)min(255u, (unsigned int)(y / 4) + (unsigned int)(noise() % 8));
+                texel[2] = (unsigned char)min(255u, (unsigned int)((x + y) / 8) + (unsigned int)(noise() % 8));
+                texel[3] = (unsigned char)(255 - (x ^ y) % 64);
+            }
+        }
+
+        vector<unsigned char> blocks;
+        bench.run(name, (size_t)1024 * 1024, [&]() {
+            BlockCompression::encode(image.data(), 1024, 1024, format, blocks);
+            Benchmark::keep(blocks);
+        }, nullptr, image.size());
+    }
+
+    // Carga "a frio" de uma cena gerada (muitos arquivos pequenos): arquivos soltos x pacote mapeado,
+    // com e sem LZ4. Antes de cada execução, todos os arquivos saem do cache de páginas
+    vector<string> sceneCases = { "LZ4Block::decompress/obj" };
+    for (string stage : { "read", "startup" }) {
+        for (string source : { "loose", "pack", "pack-lz4" }) sceneCases.push_back("AssetPack::" + stage + "/" + source);
+    }
+    for (ReadBackend backend : { READ_BACKEND_STREAM, READ_BACKEND_PREAD, READ_BACKEND_URING }) {
+        sceneCases.push_back(string("FileReader::read/") + FileReader::backendName(backend));
+        sceneCases.push_back(string("AssetLoader::startup/") + FileReader::backendName(backend));
+    }
+    if (any_of(sceneCases.begin(), sceneCases.end(), [&](const string& name) { return bench.enabled(name); })) {
+        SceneGeneratorOptions scene;
+        scene.directory = tempDirectory + "/benchmark_scene";
+        scene.objects = 1000;
+        scene.meshes = 200;
+        scene.meshFaces = 2000;
+        scene.textures = 100;
+        scene.textureSize = 256;
+        scene.instancing = 0.0f;
+        scene.seed = 3;
+        string scenePath = scene.directory + "/cena.txt";
+        string packPath = tempDirectory + "/benchmark_scene.pack";
+        string compressedPackPath = tempDirectory + "/benchmark_scene_lz4.pack";
+
+        if (!SceneGenerator::generate(scene)) return EXIT_FAILURE;
+        vector<string> files = sceneFiles(scenePath);
+        if (!AssetPack::build(packPath, files, false) || !AssetPack::build(compressedPackPath, files, true)) {
+            return EXIT_FAILURE;
+        }
+
+        size_t totalBytes = 0;
+        for (const string& path : files) totalBytes += fileSize(path);
+        auto evictAll = [&]() {
+            for (const string& path : files) evictFromCache(path);
+            evictFromCache(packPath);
+            evictFromCache(compressedPackPath);
+        };
+
+        // "read": só a entrada/saída; "startup": a carga inteira (leitura + OBJReader + stb_image)
+        string suffix = "/" + to_string(files.size());
+        for (string stage : { "read", "startup" }) {
+            auto body = [&]() {
+                if (stage == "read") Benchmark::keep(readFiles(files));
+                else loadScene(scenePath);
+            };
+
+            string looseName = "AssetPack::" + stage + "/loose" + suffix;
+            if (bench.enabled(looseName)) bench.run(looseName, files.size(), body, evictAll, totalBytes);
+
+            for (const string& pack : { packPath, compressedPackPath }) {
+                string name = "AssetPack::" + stage + (pack == packPath ? "/pack" : "/pack-lz4") + suffix;
+                if (!bench.enabled(name)) continue;
+                bench.run(name, files.size(), [&]() {
+                    AssetPack::mount(pack);
+                    body();
+                    AssetPack::unmount();
+                }, evictAll, totalBytes);
+            }
+        }
+
+        // Descompressão de uma malha OBJ (texto) comprimida pelo empacotador
+        string objName = "LZ4Block::decompress/obj";
+        if (bench.enabled(objName)) {
+            ifstream file(files[1], ios::binary);
+            vector<unsigned char> source((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+            vector<unsigned char> compressed, output(source.size());
+            LZ4Block::compress(source.data(), source.size(), compressed);
+            bench.run(objName, source.size(), [&]() {
+                LZ4Block::decompress(compressed.data(), compressed.size(), output.data(), output.size());
+                Benchmark::keep(output);
+            }, nullptr, source.size());
+        }
+
+        // Leitura em lote (FileReader) x um ifstream por arquivo: só os bytes e a carga assíncrona inteira
+        // (AssetLoader com as threads de trabalho, como System::loadSceneObjects), com o disco frio
+        for (ReadBackend backend : { READ_BACKEND_STREAM, READ_BACKEND_PREAD, READ_BACKEND_URING }) {
+            string backendName = FileReader::backendName(backend);
+
+            string readName = "FileReader::read/" + backendName + suffix;
+            if (bench.enabled(readName)) {
+                bench.run(readName, files.size(), [&]() {
+                    if (backend == READ_BACKEND_STREAM) {
+                        Benchmark::keep(readFiles(files));
+                        return;
+                    }
+                    FileReader reader;
+                    reader.start(backend);
+                    for (const string& path : files) reader.read(path, [](vector<unsigned char>&, bool) {});
+                    reader.wait();
+                }, evictAll, totalBytes);
+            }
+
+            string loaderName = "AssetLoader::startup/" + backendName + suffix;
+            if (bench.enabled(loaderName)) {
+                bench.run(loaderName, files.size(), [&]() {
+                    JobSystem::start(decodeThreads > 0 ? decodeThreads : max(1u, thread::hardware_concurrency()));
+                    {
+                        AssetLoader loader;
+                        loader.start(backend);
+                        for (size_t i = 1; i < files.size(); i++) {
+                            const string& path = files[i];
+                            if (path.compare(path.size() - 4, 4, ".obj") == 0) loader.loadMesh(path);
+                            else loader.loadImage(path, false);
+                        }
+                        loader.wait();
+
+                        vector<LoadedMesh> meshes;
+                        vector<LoadedImage> images;
+                        loader.collect(meshes, images);
+                        for (LoadedImage& image : images) AssetLoader::release(image);
+                    }
+                    JobSystem::stop();
+                }, evictAll, totalBytes);
+            }
+        }
+
+        error_code error;
+        filesystem::remove_all(scene.directory, error);
+        remove(packPath.c_str());
+        remove(compressedPackPath.c_str());
+    }
+
+    // Triangulação em leque: ~1M triângulos por execução
+    for (unsigned int sides : { 4u, 8u, 32u, 256u }) {
+        string name = "Face::triangulate/" + to_string(sides);
+        if (!bench.enabled(name)) continue;
+
+        vector<Face> polygons;
+        size_t triangles = 0;
+        for (unsigned int i = 0; triangles < 1000000; i++) {
+            polygons.push_back(makePolygon(i * sides + 1, sides));
+            triangles += sides - 2;
+        }
+
+        bench.run(name, triangles, [&]() {
+            for (const Face& polygon : polygons) {
+                vector<Face> result = polygon.triangulate();
+                Benchmark::keep(result);
+            }
+        });
+    }
+
+    // Expansão dos vértices de um grupo (deduplicação posição/textura/normal e índices)
+    if (bench.enabled("Group::buildVertexData")) {
+        Group group("grade");
+        vector<glm::vec3> vertices, normals;
+        vector<glm::vec2> texCoords;
+        buildGrid(512, 512, group, vertices, texCoords, normals);
+
+        bench.run("Group::buildVertexData/" + to_string(group.faces.size()), group.faces.size(),
+                  [&]() { group.buildVertexData(vertices, texCoords, normals); });
+    }
+
+    // sementes fixas, uma por conjunto de dados: os mesmos dados em todas as execuções, com qualquer filtro
+    uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    // Bounding box de 1M vértices
+    if (bench.enabled("Mesh::calculateBoundingBox")) {
+        mt19937 random(42);
+        Mesh mesh;
+        for (int i = 0; i < 1000000; i++) {
+            mesh.vertices.emplace_back(unit(random) * 3.0f, unit(random) * 2.0f, unit(random));
+        }
+        bench.run("Mesh::calculateBoundingBox/1000000", mesh.vertices.size(), [&]() {
+            mesh.calculateBoundingBox();
+            Benchmark::keep(mesh.boundingBox);
+        });
+    }
+
+    // Raios aleatórios contra a caixa [-1, 1]: parte acerta, parte não (como os projéteis);
+    // gerados só se algum caso de raios passar pelo filtro
+    const size_t rayCount = 1000000;
+    const size_t boxCount = 1000000;
+    string meshRayName = "Mesh::rayIntersect/" + to_string(rayCount);
+    string boxName = "OBJ3D::getTransformedBoundingBox/" + to_string(boxCount);
+    string objectRayName = "OBJ3D::rayIntersect/" + to_string(rayCount);
+
+    vector<glm::vec3> origins, directions;
+    if (bench.enabled(meshRayName) || bench.enabled(objectRayName)) {
+        mt19937 random(43);
+        for (size_t i = 0; i < rayCount; i++) {
+            origins.emplace_back(unit(random) * 5.0f, unit(random) * 5.0f, unit(random) * 5.0f);
+            directions.push_back(glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) + 0.001f));
+        }
+    }
+
+    auto sceneMesh = make_shared<Mesh>();
+    sceneMesh->vertices = { glm::vec3(-1.0f), glm::vec3(1.0f) };
+    sceneMesh->calculateBoundingBox();
+
+    if (bench.enabled(meshRayName)) {
+        bench.run(meshRayName, rayCount, [&]() {
+            unsigned int hits = 0;
+            float distance;
+            for (size_t i = 0; i < rayCount; i++) {
+                hits += sceneMesh->rayIntersect(origins[i], directions[i], distance) ? 1 : 0;
+            }
+            Benchmark::keep(hits);
+        });
+    }
+
+    // Objetos com posição, rotação e escala diferentes compartilhando a mesma malha (também no culling abaixo)
+    mt19937 random(44);
+    vector<unique_ptr<OBJ3D>> objects;
+    for (int i = 0; i < 1024; i++) {
+        unique_ptr<OBJ3D> object(new OBJ3D());
+        object->setMesh(sceneMesh, "benchmark");
+        object->setPosition(glm::vec3(unit(random), unit(random), unit(random)) * 20.0f);
+        object->setRotation(glm::vec3(unit(random), unit(random), unit(random)) * 3.14159f);
+        object->setScale(glm::vec3(1.0f + unit(random) * 0.5f));
+        objects.push_back(move(object));
+    }
+
+    if (bench.enabled(boxName)) {
+        bench.run(boxName, boxCount, [&]() {
+            for (size_t i = 0; i < boxCount; i++) {
+                BoundingBox box = objects[i & 1023]->getTransformedBoundingBox();
+                Benchmark::keep(box);
+            }
+        });
+    }
+
+    if (bench.enabled(objectRayName)) {
+        bench.run(objectRayName, rayCount, [&]() {
+            unsigned int hits = 0;
+            float distance;
+            for (size_t i = 0; i < rayCount; i++) {
+                hits += objects[i & 1023]->rayIntersect(origins[i] * 4.0f, directions[i], distance) ? 1 : 0;
+            }
+            Benchmark::keep(hits);
+        });
+    }
+
+    // Custo de um job: enfileirar (anel da thread, deque de Chase-Lev) e executar/roubar jobs vazios,
+    // comparado com uma tarefa do ThreadPool (std::function + fila com trava)
+    const size_t jobCount = 100000;
+    string jobName = "JobSystem::submit/" + to_string(jobCount);
+    if (bench.enabled(jobName)) {
+        JobSystem::start(decodeThreads);
+        atomic<size_t> executed(0);
+        bench.run(jobName, jobCount, [&]() {
+            JobCounter counter;
+            for (size_t i = 0; i < jobCount; i++) {
+                JobSystem::submit(counter, [&executed]() { executed.fetch_add(1, memory_order_relaxed); });
+            }
+            JobSystem::wait(counter);
+        });
+        JobSystem::stop();
+        Benchmark::keep(executed.load());
+    }
+
+    string poolName = "ThreadPool::submit/" + to_string(jobCount);
+    if (bench.enabled(poolName)) {
+        ThreadPool pool;
+        pool.start(decodeThreads, "benchmark");
+        atomic<size_t> executed(0);
+        bench.run(poolName, jobCount, [&]() {
+            for (size_t i = 0; i < jobCount; i++) {
+                pool.submit([&executed]() { executed.fetch_add(1, memory_order_relaxed); });
+            }
+            pool.wait();
+        });
+        pool.stop();
+        Benchmark::keep(executed.load());
+    }
+
+    // Escala do parallelFor com o culling de StaticBatch::render (bounding box transformada + teste de
+    // frustum) em 1, 2, 4 e 8 threads (1 = JobSystem parado, laço em série)
+    Frustum frustum(glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+                    glm::lookAt(glm::vec3(0.0f, 0.0f, 30.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+    vector<uint8_t> visibility(boxCount);
+    for (unsigned int threads : { 1u, 2u, 4u, 8u }) {
+        string name = "JobSystem::parallelFor/" + to_string(threads) + "-threads/" + to_string(boxCount);
+        if (!bench.enabled(name)) continue;
+
+        if (threads > 1) JobSystem::start(threads - 1);
+        bench.run(name, boxCount, [&]() {
+            JobSystem::parallelFor(boxCount, 64, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    visibility[i] = frustum.intersects(objects[i & 1023]->getTransformedBoundingBox()) ? 1 : 0;
+                }
+            });
+            Benchmark::keep(visibility);
+        });
+        JobSystem::stop();
+    }
+
+    // Custo de uma mensagem de colisão para quem a registra: registro no anel da thread (a thread de fundo
+    // formata e escreve em um arquivo) x formatação e escrita na hora com endl, como o cout fazia antes
+    const size_t messageCount = 256;    // cabe no anel; o setup esvazia o anel fora da medida
+    const string objectName = "Target3";
+    string logPath = tempDirectory + "/benchmark_log.txt";
+    string logName = "Log::write/" + to_string(messageCount);
+    if (bench.enabled(logName)) {
+        ofstream logFile(logPath);
+        uint32_t rateLimit = Log::rateLimit;
+        Log::rateLimit = 0;
+        Log::start(logFile, logFile);
+        bench.run(logName, messageCount, [&]() {
+            for (size_t i = 0; i < messageCount; i++) LOG_INFO("Objeto \"{}\" eliminado! ({})", objectName, i);
+        }, []() { Log::flush(); });
+        Log::stop();
+        Log::rateLimit = rateLimit;
+    }
+
+    string endlName = "ofstream+endl/" + to_string(messageCount);
+    if (bench.enabled(endlName)) {
+        ofstream logFile(logPath);
+        bench.run(endlName, messageCount, [&]() {
+            for (size_t i = 0; i < messageCount; i++) {
+                logFile << "Objeto \"" << objectName << "\" eliminado! (" << i << ")" << endl;
+            }
+        });
+    }
+    remove(logPath.c_str());
+
+    if (bench.results.empty()) {
+        cerr << "Nenhum benchmark corresponde ao filtro \"" << bench.filter << "\"" << endl;
+        return EXIT_FAILURE;
+    }
+
+    return bench.writeJSON(outputPath) ? 0 : EXIT_FAILURE;
+}
@@ -0,0 +1,92 @@
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "Mesh.h"
+#include "JobSystem.h"
+#include "MPSCQueue.h"
+#include "MipChain.h"
+#include "TextureCooker.h"
+#include "FileReader.h"
+
+using namespace std;
+
+// Malha lida por uma thread de trabalho: vértices, grupos (com os dados dos vértices já
+// gerados) e bounding box, faltando apenas o envio para a OpenGL (UploadQueue)
+struct LoadedMesh {
+    string path;
+    unique_ptr<Mesh> mesh;  // nullptr = falha na leitura
+};
+
+// Imagem decodificada por uma thread de trabalho (ou a sua versão cozida, já comprimida)
+struct LoadedImage {
+    string path;
+    unsigned char* data;    // pixels do stb_image (nullptr = falha ou textura cozida); liberar com AssetLoader::release
+    int width, height, channels;
+    vector<unsigned char> layerPixels;  // camada do texture array já convertida (ver TextureArray::prepareLayer)
+    int layerSize;                      // 0 = camada não preparada
+    vector<MipLevel> mips;              // níveis 1..n gerados na CPU (vazio = glGenerateMipmap)
+    vector<MipLevel> layerMips;         // idem, da camada do texture array
+    bool compressed;                    // true = a imagem não foi decodificada, os níveis estão em "cooked"
+    CookedTexture cooked;
+
+    LoadedImage() : data(nullptr), width(0), height(0), channels(0), layerSize(0), compressed(false) {}
+};
+
+// Carregamento assíncrono dos recursos da cena: leitura do arquivo, parsing do OBJ, geração dos
+// vértices e decodificação das imagens rodam como tarefas de fundo do JobSystem (as mesmas threads
+// do culling e das colisões); os resultados ficam em filas sem
+// trava (MPSCQueue) até a thread principal coletá-los (collect) e entregá-los à UploadQueue.
+// Assim o primeiro frame é desenhado logo depois de ler a configuração da cena, e os objetos
+// aparecem à medida que suas malhas e texturas ficam prontas (ver System::updateLoading).
+class AssetLoader {
+public:
+    AssetLoader();
+    ~AssetLoader();
+
+    // Com um backend de leitura em lote, inicia o FileReader: os arquivos são lidos todos de uma vez e
+    // as tarefas só interpretam/decodificam. Sem JobSystem::start as tarefas executam na hora
+    void start(ReadBackend readBackend = READ_BACKEND_STREAM);
+
+    // Enfileira a leitura de um .obj / a decodificação de uma imagem (cada caminho uma vez).
+    // Com um filtro de CPU, a imagem (e a camada) já saem com a cadeia de mipmaps (ver MipChain);
+    // uma textura cozida atualizada, num formato suportado pelo contexto, é lida no lugar da imagem
+    // (ver TextureCooker)
+    void loadMesh(const string& path);
+    void loadImage(const string& path, bool prepareArrayLayer, MipFilter mipFilter = MIP_FILTER_GPU);
+
+    // Move os resultados prontos desde a última chamada (thread principal, uma vez por frame)
+    void collect(vector<LoadedMesh>& meshes, vector<LoadedImage>& images);
+
+    // Espera as tarefas enfileiradas terminarem (os resultados ainda precisam ser coletados)
+    void wait();
+
+    void stop();
+
+    static void release(LoadedImage& image);
+
+    // Transfere os pixels da imagem para um ponteiro compartilhado (liberado com stbi_image_free)
+    static shared_ptr<unsigned char> takeData(LoadedImage& image);
+
+    size_t requestedCount() const { return requested; }
+    size_t collectedCount() const { return collected; }
+    bool isDone() const { return collected == requested; }
+    ReadBackend readBackend() const { return reader.backend(); }
+    size_t bytesRead() const { return reader.bytesRead(); }
+
+private:
+    JobCounter tasks;       // tarefas enfileiradas no JobSystem e ainda não terminadas
+    atomic<bool> cancelled; // stop: as tarefas ainda não iniciadas retornam sem fazer nada
+    FileReader reader;
+    MPSCQueue<LoadedMesh> readyMeshes;
+    MPSCQueue<LoadedImage> readyImages;
+    size_t requested;
+    size_t collected;
+
+    bool readsAhead(const string& path, bool image) const;
+    static void prepareImage(LoadedImage& result, bool prepareArrayLayer, MipFilter mipFilter);
+};
+
+#endif
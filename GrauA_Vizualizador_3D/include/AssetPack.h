@@ -0,0 +1,84 @@
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <fstream>
+#include <cstdint>
+
+using namespace std;
+
+// Conteúdo de um arquivo do pacote: aponta direto para o mapeamento (sem cópia) ou, se a entrada
+// estiver comprimida, para "buffer" com os dados já descomprimidos
+struct AssetView {
+    const unsigned char* data;
+    size_t size;
+    vector<unsigned char> buffer;
+
+    AssetView() : data(nullptr), size(0) {}
+};
+
+// Pacote de recursos: um único arquivo com a configuração da cena, os modelos e as texturas, aberto
+// uma vez e mapeado em memória (mmap / MapViewOfFile). Evita abrir e posicionar um arquivo por recurso,
+// que domina o tempo de carga em disco frio ou em pasta de rede.
+//
+// Formato: cabeçalho, índice (entradas ordenadas pelo hash FNV-1a do caminho, busca binária), tabela de
+// nomes e os conteúdos alinhados em 64 bytes. Cada entrada pode estar comprimida em LZ4 (ver LZ4Block);
+// o empacotador só guarda a versão comprimida quando ela economiza pelo menos 1/8 (texto OBJ sim,
+// JPG/PNG não).
+//
+// Com um pacote montado (--pack), OBJReader, a leitura da configuração da cena e os carregamentos de
+// imagem procuram o caminho primeiro no pacote e depois no disco. Depois de montado, o pacote é só
+// leitura: find pode ser chamado das threads de carregamento.
+class AssetPack {
+public:
+    // Monta o pacote (substitui o anterior); false se o arquivo não existir ou for inválido
+    static bool mount(const string& path);
+    static void unmount();
+    static bool isMounted();
+    static size_t fileCount();
+    static size_t mappedBytes();
+
+    // Procura um caminho no pacote montado (sem cópia se a entrada não estiver comprimida)
+    static bool find(const string& path, AssetView& view);
+
+    // Decodifica uma imagem do pacote (stbi_load_from_memory) ou, se não estiver nele, do disco (stbi_load);
+    // mesmos parâmetros e retorno do stbi_load
+    static unsigned char* loadImage(const string& path, int* width, int* height, int* channels, int desiredChannels);
+
+    // Empacotador: grava os arquivos (caminhos relativos, como aparecem na cena) em um pacote; com
+    // "compress", cada entrada é comprimida em LZ4 quando compensa. Imprime o relatório
+    static bool build(const string& packPath, const vector<string>& files, bool compress);
+
+    // Caminho como chave do índice: barras normais, sem "./" no início
+    static string normalize(const string& path);
+};
+
+// streambuf somente leitura sobre um bloco de memória
+class MemoryStreamBuffer : public streambuf {
+public:
+    void set(const unsigned char* data, size_t size) {
+        char* begin = (char*)data;
+        setg(begin, begin, begin + size);
+    }
+};
+
+// Arquivo de texto lido do pacote montado ou, se não estiver nele, do disco (ifstream)
+class AssetStream : public istream {
+public:
+    explicit AssetStream(const string& path);
+
+    bool is_open() const { return open; }
+    void close() { if (file.is_open()) file.close(); }
+    bool fromPack() const { return packed; }
+
+private:
+    AssetView view;
+    MemoryStreamBuffer memory;
+    filebuf file;
+    bool open;
+    bool packed;
+};
+
+#endif
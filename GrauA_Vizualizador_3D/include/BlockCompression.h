@@ -0,0 +1,56 @@
+#ifndef BLOCKCOMPRESSION_H
+#define BLOCKCOMPRESSION_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+// Formatos de compressão em blocos 4x4 suportados pelo TextureCooker
+enum BlockFormat {
+    BLOCK_BC1,  // RGB, 8 bytes por bloco (4 bits por texel) - EXT_texture_compression_s3tc (DXT1)
+    BLOCK_BC3,  // RGBA, 16 bytes por bloco: BC1 para a cor + alfa interpolado - s3tc (DXT5)
+    BLOCK_BC7   // RGBA, 16 bytes por bloco, melhor qualidade - GL 4.2 / ARB_texture_compression_bptc
+};
+
+// Codificação e decodificação de imagens RGBA8 em blocos BC1, BC3 e BC7. Não acessa a OpenGL.
+//
+// Cada bloco é ajustado pelo eixo principal das cores (PCA) e refinado por mínimos quadrados sobre os
+// índices escolhidos. O BC7 usa apenas o modo 6 (uma partição, extremos RGBA de 7 bits + p-bit e
+// índices de 4 bits): bem acima do BC1/BC3 em qualidade, sem o custo de testar os oito modos.
+// A decodificação serve para medir a qualidade (PSNR) e só entende o modo 6 do BC7.
+// Imagens com lados que não são múltiplos de 4 repetem a última linha/coluna nos blocos da borda.
+class BlockCompression {
+public:
+    static int blockBytes(BlockFormat format);
+
+    // Bytes de uma imagem width x height no formato (blocos arredondados para cima)
+    static size_t imageSize(BlockFormat format, int width, int height);
+
+    // Comprime uma imagem RGBA8; os blocos ficam em linhas, da esquerda para a direita
+    static void encode(const unsigned char* rgba, int width, int height, BlockFormat format,
+                       vector<unsigned char>& blocks);
+
+    // Descomprime para RGBA8 (alfa 255 no BC1)
+    static void decode(const unsigned char* blocks, int width, int height, BlockFormat format,
+                       vector<unsigned char>& rgba);
+
+    // PSNR (dB) entre duas imagens RGBA8 com "pixelCount" pixels, nos 3 ou 4 primeiros canais
+    static double psnr(const unsigned char* a, const unsigned char* b, size_t pixelCount, int channels);
+
+    // Nome do formato na linha de comando (bc1, bc3, bc7) e o inverso; false se o nome for inválido
+    static const char* formatName(BlockFormat format);
+    static bool parseFormat(const string& name, BlockFormat& format);
+
+private:
+    static void encodeColor(const unsigned char* block, unsigned char* output);
+    static void encodeAlpha(const unsigned char* block, unsigned char* output);
+    static void encodeBC7(const unsigned char* block, unsigned char* output);
+
+    static void decodeColor(const unsigned char* input, unsigned char* block, bool threeColorMode);
+    static void decodeAlpha(const unsigned char* input, unsigned char* block);
+    static void decodeBC7(const unsigned char* input, unsigned char* block);
+};
+
+#endif
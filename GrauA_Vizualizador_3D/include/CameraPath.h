@@ -0,0 +1,36 @@
+#ifndef CAMERAPATH_H
+#define CAMERAPATH_H
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Camera.h"
+
+using namespace std;
+
+// Posição e orientação da câmera em um frame do caminho
+struct CameraKey {
+    int frame;
+    glm::vec3 position;
+    float yaw, pitch;   // graus, como em Camera
+};
+
+// Caminho de câmera roteirizado para o modo headless: chaves por número de frame,
+// interpoladas linearmente entre si (antes da primeira e depois da última a câmera fica parada).
+// Arquivo texto, uma chave por linha:  frame posX posY posZ yaw pitch   (linhas com # são comentários)
+class CameraPath {
+public:
+    vector<CameraKey> keys;    // ordenadas por frame
+
+    bool load(const string& path);
+
+    // Posiciona a câmera no frame pedido
+    void apply(int frame, Camera& camera) const;
+
+    // Último frame com chave (duração do caminho)
+    int lastFrame() const { return keys.empty() ? 0 : keys.back().frame; }
+
+    bool empty() const { return keys.empty(); }
+};
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef FILEREADER_H
+#define FILEREADER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include "ThreadPool.h"
+
+using namespace std;
+
+// Como os arquivos da cena são lidos na carga assíncrona (--io)
+enum ReadBackend {
+    READ_BACKEND_STREAM,    // cada thread de trabalho abre e lê o seu arquivo (ifstream), entre o parsing e a decodificação
+    READ_BACKEND_URING,     // io_uring (Linux): todas as leituras enviadas juntas ao kernel; sem suporte, cai para pread
+    READ_BACKEND_PREAD      // threads de E/S dedicadas com pread, várias leituras em andamento
+};
+
+// Leitura de arquivos inteiros em lote para a carga da cena. Com o disco frio, ler cada arquivo dentro
+// da tarefa que o interpreta deixa as threads de trabalho paradas esperando o disco, uma leitura por vez
+// por thread. Aqui todas as leituras pedidas são enviadas de uma vez (com posix_fadvise SEQUENTIAL, que
+// aumenta a janela de leitura antecipada), o disco reordena e sobrepõe os acessos, e cada arquivo é
+// entregue inteiro na memória, na ordem em que fica pronto, para o parsing/decodificação (AssetLoader).
+//
+// io_uring: uma thread de E/S mantém até "queueDepth" leituras no anel (chamadas de sistema diretas, sem
+// liburing) e colhe as conclusões. Sem io_uring (kernel antigo, seccomp, Windows), ou com --io pread, um
+// pool de "queueDepth" threads faz as leituras com pread (ifstream no Windows).
+class FileReader {
+public:
+    // Chamado na thread de E/S com o conteúdo do arquivo (vazio e "ok" false em caso de falha);
+    // deve ser rápido: só repassa o trabalho (ex.: JobSystem::submitBackground)
+    typedef function<void(vector<unsigned char>& data, bool ok)> Callback;
+
+    FileReader();
+    ~FileReader();
+
+    // Inicia o backend pedido (READ_BACKEND_STREAM = desligado); false se nenhum puder ser usado
+    bool start(ReadBackend backend, unsigned int queueDepth = 32);
+
+    // Pede a leitura de um arquivo inteiro (qualquer thread)
+    void read(const string& path, Callback done);
+
+    // Espera todas as leituras pedidas serem entregues (callbacks já retornados)
+    void wait();
+
+    void stop();
+
+    bool isStarted() const { return active != READ_BACKEND_STREAM; }
+    ReadBackend backend() const { return active; }
+    size_t bytesRead() const { return totalBytes.load(); }
+
+    static const char* backendName(ReadBackend backend);
+    static bool parseBackend(const string& name, ReadBackend& backend);
+
+    // Lê um arquivo inteiro com pread (ifstream no Windows); usado pelo backend pread e pelo benchmark
+    static bool readWhole(const string& path, vector<unsigned char>& data);
+
+private:
+    struct Request {
+        string path;
+        Callback done;
+    };
+
+    ReadBackend active;
+    unsigned int depth;
+    atomic<size_t> totalBytes;
+
+    // pedidos ainda não entregues; a thread de E/S do io_uring consome "pending"
+    mutex requestMutex;
+    condition_variable requestAvailable;
+    condition_variable allDelivered;
+    deque<Request> pending;
+    size_t outstanding;
+    bool stopping;
+
+    ThreadPool ioThreads;   // backend pread
+    thread uringThread;     // backend io_uring
+    struct Ring;            // anel do io_uring (FileReader.cpp)
+    Ring* ring;
+
+    bool startUring();
+    void uringLoop();
+    void deliver(Request& request, vector<unsigned char>& data, bool ok);
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef FRAMETIMINGS_H
+#define FRAMETIMINGS_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+using namespace std;
+
+// Tempos (em milissegundos) e carga de um frame
+struct FrameTiming {
+    float cpuMs;            // entrada, atualização e submissão dos comandos (até antes do glFinish/swap)
+    float frameMs;          // frame completo, incluindo a espera pela GPU
+    unsigned int drawCalls; // draw calls emitidos (fila + multi-draw indirect)
+    unsigned long long triangles;
+    float gpuMs;            // soma dos passes medidos por GpuTimer (chega alguns frames depois; -1 = sem medição)
+};
+
+// Registro dos tempos de cada frame de uma execução (modo headless ou reprodução de entrada),
+// gravado em CSV ao final. O resumo usa percentis, que comparam melhor duas versões do que a
+// média (um único frame lento não a distorce, e os picos aparecem no p99/máximo).
+class FrameTimings {
+public:
+    vector<FrameTiming> frames;
+
+    // gpuFrame: índice do frame no GpuTimer, que conta também os frames não registrados (carregamento)
+    void record(float cpuMs, float frameMs, unsigned int drawCalls, unsigned long long triangles,
+                unsigned long long gpuFrame) {
+        gpuRows[gpuFrame] = frames.size();
+        frames.push_back({ cpuMs, frameMs, drawCalls, triangles, -1.0f });
+    }
+
+    // Tempo de GPU de um frame do GpuTimer (resultado lido com atraso); ignorado se o frame não foi registrado
+    void setGpuTime(unsigned long long gpuFrame, float gpuMs) {
+        auto row = gpuRows.find(gpuFrame);
+        if (row == gpuRows.end()) return;
+        frames[row->second].gpuMs = gpuMs;
+        gpuRows.erase(row);
+    }
+
+    // Percentil (0 a 100) do tempo de frame, pelo método do posto mais próximo
+    float percentile(float p) const;
+
+    // frame,cpu_ms,gpu_ms,frame_ms,draw_calls,triangles - uma linha por frame
+    bool writeCSV(const string& path) const;
+
+    // Média, p50/p95/p99/máximo do tempo de frame, CPU x GPU, draw calls e triângulos por frame
+    void printSummary() const;
+
+    // Acrescenta ao CSV uma linha com o resumo da execução e o tamanho/tempos de carga da cena
+    // (scene,objects,load_ms,first_frame_ms,frames,mean_ms,p50_ms,p95_ms,p99_ms,max_ms,cpu_ms,gpu_ms,draw_calls,triangles)
+    bool appendSummaryCSV(const string& path, const string& scene, size_t objects, double loadMs,
+                          double firstFrameMs) const;
+
+private:
+    map<unsigned long long, size_t> gpuRows;   // frame do GpuTimer -> linha em frames (até o tempo chegar)
+};
+
+#endif
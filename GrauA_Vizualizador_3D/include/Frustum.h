@@ -0,0 +1,43 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+#include "Mesh.h"
+
+// Frustum de visualização (6 planos) extraído da matriz projection * view,
+// usado para descartar objetos fora do campo de visão da câmera
+struct Frustum {
+    glm::vec4 planes[6];    // (normal.xyz, d) - pontos dentro satisfazem dot(normal, p) + d >= 0
+
+    Frustum() {}
+
+    explicit Frustum(const glm::mat4& viewProjection) {
+        glm::mat4 m = glm::transpose(viewProjection);   // linhas da matriz como colunas
+
+        planes[0] = m[3] + m[0];    // esquerda
+        planes[1] = m[3] - m[0];    // direita
+        planes[2] = m[3] + m[1];    // baixo
+        planes[3] = m[3] - m[1];    // cima
+        planes[4] = m[3] + m[2];    // near
+        planes[5] = m[3] - m[2];    // far
+
+        for (auto& plane : planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+    }
+
+    // Testa se a bounding box (no espaço do mundo) está ao menos parcialmente dentro do frustum
+    bool intersects(const BoundingBox& box) const {
+        for (const auto& plane : planes) {
+            // vértice da caixa mais à frente na direção da normal do plano
+            glm::vec3 positive(plane.x >= 0.0f ? box.max.x : box.min.x,
+                               plane.y >= 0.0f ? box.max.y : box.min.y,
+                               plane.z >= 0.0f ? box.max.z : box.min.z);
+
+            if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f) return false;
+        }
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef GLEXTENSIONS_H
+#define GLEXTENSIONS_H
+
+#include <string>
+#include <glad/glad.h>
+
+using namespace std;
+
+// O loader GLAD do projeto foi gerado para OpenGL 4.0 (ver Dependencies/GLAD).
+// Este módulo carrega, em tempo de execução, as funções e constantes de versões posteriores
+// (e de extensões) usadas pelos caminhos de renderização opcionais, seguindo a mesma convenção
+// do GLAD (ponteiro glad_glX + macro glX). Cada caminho consulta as flags antes de usar as funções.
+
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+
+// GL 4.3 / ARB_multi_draw_indirect
+typedef void (APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void* indirect,
+                                                            GLsizei drawcount, GLsizei stride);
+GLAPI PFNGLMULTIDRAWELEMENTSINDIRECTPROC glad_glMultiDrawElementsIndirect;
+#define glMultiDrawElementsIndirect glad_glMultiDrawElementsIndirect
+
+// GL 4.1 / ARB_get_program_binary
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH           0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS      0x87FE
+#endif
+
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length,
+                                                   GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary,
+                                                GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+GLAPI PFNGLGETPROGRAMBINARYPROC  glad_glGetProgramBinary;
+GLAPI PFNGLPROGRAMBINARYPROC     glad_glProgramBinary;
+GLAPI PFNGLPROGRAMPARAMETERIPROC glad_glProgramParameteri;
+#define glGetProgramBinary  glad_glGetProgramBinary
+#define glProgramBinary     glad_glProgramBinary
+#define glProgramParameteri glad_glProgramParameteri
+
+// KHR_parallel_shader_compile
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+GLAPI PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glad_glMaxShaderCompilerThreadsKHR;
+#define glMaxShaderCompilerThreadsKHR glad_glMaxShaderCompilerThreadsKHR
+
+// GL 4.4 / ARB_buffer_storage
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT  0x0040
+#define GL_MAP_COHERENT_BIT    0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT  0x0200
+#endif
+
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+GLAPI PFNGLBUFFERSTORAGEPROC glad_glBufferStorage;
+#define glBufferStorage glad_glBufferStorage
+
+// EXT_texture_compression_s3tc (BC1/BC3) e GL 4.2 / ARB_texture_compression_bptc (BC7);
+// as funções glCompressedTex* já fazem parte do GL 1.3
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT  0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+
+// Comando de desenho indireto (layout definido pela especificação de glMultiDrawElementsIndirect)
+struct DrawElementsIndirectCommand {
+    GLuint count;           // número de índices
+    GLuint instanceCount;   // número de instâncias
+    GLuint firstIndex;      // primeiro índice no index buffer
+    GLint  baseVertex;      // somado a cada índice
+    GLuint baseInstance;    // primeira instância
+};
+
+class GLExtensions {
+public:
+    // Recursos disponíveis no contexto atual (preenchidos por load)
+    static bool multiDrawIndirect;      // glMultiDrawElementsIndirect (GL 4.3 ou ARB_multi_draw_indirect)
+    static bool shaderStorageBuffer;    // SSBOs (GL 4.3 ou ARB_shader_storage_buffer_object)
+    static bool shaderDrawParameters;   // gl_DrawID no shader (GL 4.6 ou ARB_shader_draw_parameters)
+    static bool programBinary;          // glGetProgramBinary/glProgramBinary com ao menos um formato
+    static bool parallelShaderCompile;  // compilação em threads do driver (KHR_parallel_shader_compile)
+    static bool bufferStorage;          // glBufferStorage com mapeamento persistente (GL 4.4 ou ARB_buffer_storage)
+    static bool textureCompressionS3TC; // texturas BC1/BC3 (EXT_texture_compression_s3tc)
+    static bool textureCompressionBPTC; // texturas BC7 (GL 4.2 ou ARB_texture_compression_bptc)
+
+    // Carrega as funções usando o mesmo loader passado ao GLAD (ex.: glfwGetProcAddress).
+    // Deve ser chamado com o contexto ativo, depois de gladLoadGLLoader.
+    static void load(GLADloadproc loader);
+
+    // Verifica se a versão do contexto é pelo menos major.minor
+    static bool hasVersion(int major, int minor);
+
+    // Verifica se a extensão está na lista do contexto (glGetStringi)
+    static bool hasExtension(const string& name);
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef GLSTATE_H
+#define GLSTATE_H
+
+#include <glad/glad.h>
+
+using namespace std;
+
+// Camada fina de rastreamento de estado da OpenGL.
+// Guarda o último valor enviado ao driver para programa, VAO, unidades de textura, buffers,
+// depth test e blending; chamadas que não mudariam o estado são descartadas antes de chegar ao driver.
+// Todo o código do visualizador deve passar por aqui em vez de chamar glBind*/glUseProgram diretamente.
+class GLState {
+public:
+    static const unsigned int MAX_TEXTURE_UNITS = 16;
+
+    // Contadores de depuração: chamadas emitidas ao driver x chamadas descartadas (redundantes)
+    static unsigned long long issuedCalls;
+    static unsigned long long elidedCalls;
+
+    static void useProgram(GLuint program);
+    static void bindVertexArray(GLuint vao);
+    static void activeTexture(GLenum unit);                 // GL_TEXTURE0 + n
+    static void bindTexture(GLenum target, GLuint texture); // na unidade ativa
+    static void bindTextureUnit(GLuint unit, GLenum target, GLuint texture);
+    static void bindBuffer(GLenum target, GLuint buffer);
+    static void bindBufferBase(GLenum target, GLuint index, GLuint buffer); // também altera o vínculo genérico
+
+    static void setDepthTest(bool enabled);
+    static void setDepthMask(bool enabled);
+    static void setBlend(bool enabled);
+    static void blendFunc(GLenum srcFactor, GLenum dstFactor);
+
+    // Exclusões passam por aqui para que o cache esqueça nomes que o driver desvincula sozinho
+    static void deleteProgram(GLuint program);
+    static void deleteVertexArray(GLuint vao);
+    static void deleteBuffer(GLuint buffer);
+    static void deleteTexture(GLuint texture);
+
+    // Esquece todo o estado conhecido (ex.: após trocar de contexto)
+    static void invalidate();
+
+    static void resetCounters();
+    static void printReport();
+};
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef GPUTIMER_H
+#define GPUTIMER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <glad/glad.h>
+
+using namespace std;
+
+// Tempo de GPU de um pass em um frame
+struct GpuPassTiming {
+    const char* name;
+    double ms;
+};
+
+// Tempos de GPU por pass de renderização (clear, cena, projéteis, overlay...), medidos com
+// queries GL_TIME_ELAPSED de um pool. Os resultados são lidos alguns frames depois (sem
+// glFinish nem espera pelo resultado): a cada beginFrame, só os frames cujas queries já estão
+// disponíveis são lidos e suas queries voltam ao pool. Com a GPU mais de MAX_PENDING_FRAMES
+// atrasada, o frame atual simplesmente não é medido.
+// Como GL_TIME_ELAPSED não pode ser aninhada, os passes de um frame são sequenciais: beginPass
+// encerra o pass anterior.
+class GpuTimer {
+public:
+    static const size_t MAX_PENDING_FRAMES = 4;    // frames em voo aguardando resultado (normalmente 2 a 3)
+
+    bool enabled;
+
+    // Último frame lido (já com 2-3 frames de atraso) e médias desde o início
+    vector<GpuPassTiming> lastFrame;
+    double lastFrameMs;                 // soma dos passes do último frame lido
+    unsigned long long resolvedFrames;  // frames lidos
+    unsigned long long skippedFrames;   // frames não medidos (GPU atrasada demais)
+
+    GpuTimer();
+    ~GpuTimer();
+
+    // Lê os frames anteriores que já terminaram na GPU e começa um novo frame
+    void beginFrame();
+
+    // Inicia a medição de um pass (nome literal), encerrando o pass anterior
+    void beginPass(const char* name);
+
+    // Encerra o último pass do frame
+    void endFrame();
+
+    // Índice do frame começado pelo último beginFrame (o mesmo que aparece depois em newlyResolved)
+    unsigned long long currentFrame() const { return current.index; }
+
+    // Frames lidos desde a última chamada: índice do frame (contado a partir de 0) e tempo total
+    const vector<pair<unsigned long long, double>>& newlyResolved() const { return resolved; }
+
+    // Espera e lê todos os frames pendentes (no desligamento)
+    void flush();
+
+    // Média de cada pass por frame
+    void printReport() const;
+
+    void cleanup();
+
+private:
+    struct PendingPass {
+        const char* name;
+        GLuint query;
+        uint64_t cpuTicks;  // relógio do profiler quando o pass foi submetido (posição no trace)
+    };
+
+    struct PendingFrame {
+        unsigned long long index;
+        vector<PendingPass> passes;
+    };
+
+    vector<GLuint> pool;                // queries livres
+    vector<GLuint> allQueries;          // para o cleanup
+    deque<PendingFrame> pending;        // frames submetidos, do mais antigo ao mais novo
+    PendingFrame current;
+    bool frameActive, passActive;
+    unsigned long long frameCounter;
+    vector<pair<unsigned long long, double>> resolved;
+
+    // Totais por pass (nome -> soma em ms), na ordem em que os passes apareceram
+    vector<pair<const char*, double>> totals;
+
+    GLuint acquireQuery();
+    void resolve(bool wait);
+};
+
+#endif
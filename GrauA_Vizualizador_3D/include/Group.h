@@ -15,16 +15,23 @@ public:
     // OpenGL objects
     unsigned int VAO;
     unsigned int VBO;
+    unsigned int EBO;
 
     // Vetor de dados (floats) dos vértices (posições, normais, coordenadas de textura)
     // para envio à OpenGL. Armazena sequencialmente os atributos de cada vértice.
     // Exemplo: v1.x, v1.y, v1.z, v1.nx, v1.ny, v1.nz, v1.u, v1.v, v2.x, v2.y, ...
     // Cada grupo de 8 floats representa um vértice (posição<3> + texCoord<2> + normal<3>)
+    // Vértices repetidos (mesma combinação posição/textura/normal) aparecem uma única vez
     vector<float> vertices;
 
-    int vertexCount; // Número de vértices do grupo para envio à glDrawArrays
+    // Índices dos triângulos (3 por triângulo) no vetor "vertices", para envio à glDrawElements
+    vector<unsigned int> indices;
+
+    int vertexCount; // Número de vértices únicos do grupo
                      // cada vértice tem 8 floats (posição<3> + texCoord<2> + normal<3>)
                      // logo, vertexCount = vertices.size() / 8
+
+    int indexCount;  // Número de índices do grupo (3 por triângulo)
     
     Group();
 
@@ -41,6 +48,20 @@ public:
                       const vector<glm::vec2>& objTexCoords,
                       const vector<glm::vec3>& objNormals);
 
+    // Parte da CPU de setupBuffers: gera "vertices" e "indices" a partir das faces (sem chamadas OpenGL)
+    void buildVertexData(const vector<glm::vec3>& objVertices,
+                         const vector<glm::vec2>& objTexCoords,
+                         const vector<glm::vec3>& objNormals);
+
+    // Parte da OpenGL de setupBuffers: cria VAO/VBO/EBO e envia "vertices" e "indices"
+    void uploadBuffers();
+
+    // Envio em partes (ver UploadQueue): createBuffers cria o VBO e o EBO do tamanho dos dados
+    // (vazios se withData = false); com o conteúdo copiado, setupVertexArray cria o VAO.
+    // Enquanto VAO = 0 o grupo não é desenhado.
+    void createBuffers(bool withData);
+    void setupVertexArray();
+
     // Renderiza o grupo de faces
     void render() const;
 
@@ -0,0 +1,49 @@
+#ifndef HEADLESSCONTEXT_H
+#define HEADLESSCONTEXT_H
+
+#include <string>
+#include <glad/glad.h>
+
+using namespace std;
+
+// Contexto OpenGL sem janela, para benchmarks e testes automatizados em máquinas sem monitor
+// (e sem GPU: funciona com o Mesa llvmpipe). O contexto é criado pela EGL, de preferência sem
+// superfície (EGL_MESA_platform_surfaceless); se não houver suporte, usa um pbuffer de 1x1.
+// A cena é desenhada em um framebuffer próprio (FBO com cor RGBA8 e profundidade 24 bits)
+// do tamanho pedido, que fica ligado durante toda a execução no lugar do framebuffer da janela.
+// Disponível apenas no Linux (a EGL não faz parte do build MinGW do projeto).
+class HeadlessContext {
+public:
+    int width, height;  // tamanho do FBO
+
+    HeadlessContext();
+    ~HeadlessContext();
+
+    // Cria o contexto (OpenGL 4.5 core, ou 4.0 se não houver) e o FBO; retorna false se a EGL falhar
+    bool create(int width, int height);
+
+    // Carregador de funções para o GLAD (eglGetProcAddress)
+    static void* getProcAddress(const char* name);
+
+    // Termina os comandos do frame (substitui o glfwSwapBuffers: sem isso o driver acumula frames)
+    void finishFrame();
+
+    // Lê o FBO e grava uma imagem PPM (P6, linhas de cima para baixo)
+    bool saveFrame(const string& path) const;
+
+    bool isCreated() const { return created; }
+
+    void destroy();
+
+private:
+    bool created;
+    void* display;      // EGLDisplay
+    void* context;      // EGLContext
+    void* surface;      // EGLSurface (pbuffer) ou EGL_NO_SURFACE
+    GLuint framebuffer;
+    GLuint colorBuffer, depthBuffer;
+
+    bool createFramebuffer();
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef INPUTRECORDING_H
+#define INPUTRECORDING_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Teclas de um frame, combinadas em uma máscara de bits (estado "pressionada" de cada uma;
+// a detecção de borda dos disparos e das teclas M/I/T continua em System::applyInput e nas suas partes)
+enum InputButton {
+    INPUT_FORWARD           = 1 << 0,   // W / seta para cima
+    INPUT_BACKWARD          = 1 << 1,   // S / seta para baixo
+    INPUT_LEFT              = 1 << 2,   // A / seta para a esquerda
+    INPUT_RIGHT             = 1 << 3,   // D / seta para a direita
+    INPUT_SHOOT             = 1 << 4,   // espaço
+    INPUT_TOGGLE_MULTIDRAW  = 1 << 5,   // M
+    INPUT_TOGGLE_INSTANCING = 1 << 6,   // I
+    INPUT_TOGGLE_TEXTURES   = 1 << 7,   // T
+    INPUT_TOGGLE_OVERLAY    = 1 << 8    // F3
+};
+
+// Entrada de um frame
+struct FrameInput {
+    uint32_t buttons;   // InputButton
+    float mouseX;       // deslocamento do mouse acumulado no frame (já com y invertido)
+    float mouseY;
+    float scroll;       // rolagem acumulada no frame
+
+    FrameInput() : buttons(0), mouseX(0.0f), mouseY(0.0f), scroll(0.0f) {}
+};
+
+// Entrada dos frames combinada para os passos de uma simulação com passo fixo (ver SimulationThread e
+// --fixed-step), que não coincidem com os frames: teclas pressionadas em qualquer frame desde o último
+// passo contam, movimento do mouse e rolagem são somados, e as teclas do último frame continuam valendo
+// nos passos seguintes, mesmo sem frame novo
+class InputAccumulator {
+public:
+    InputAccumulator() : held(0) {}
+
+    void push(const FrameInput& input);     // a cada frame
+    FrameInput take();                      // a cada passo
+
+private:
+    FrameInput pending;
+    uint32_t held;      // teclas do último frame
+};
+
+// Gravação da entrada do usuário, frame a frame, para reprodução determinística:
+// com a mesma gravação e um deltaTime fixo, o estado da cena (câmera, projéteis, objetos eliminados)
+// é idêntico em todas as execuções, e os tempos de frame de duas versões podem ser comparados.
+// Arquivo binário: cabeçalho (magic "CGRI", versão, número de frames) seguido dos FrameInput.
+class InputRecording {
+public:
+    vector<FrameInput> frames;
+
+    bool save(const string& path) const;
+    bool load(const string& path);
+
+    size_t size() const { return frames.size(); }
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef INSTANCERENDERER_H
+#define INSTANCERENDERER_H
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <glm/glm.hpp>
+#include "OBJ3D.h"
+#include "Shader.h"
+#include "ShaderPermutations.h"
+#include "RenderQueue.h"
+
+using namespace std;
+
+// Instanciamento automático: objetos da cena que compartilham malha e textura
+// (ex.: Mirror1/Mirror2 com cube.obj + red.jpg) formam um grupo de instâncias.
+// As matrizes model de cada grupo ficam em um instance buffer (atributos 3 a 6, divisor 1)
+// e cada grupo da malha é desenhado com um único glDrawElementsInstanced.
+// O instance buffer é atualizado incrementalmente: só as instâncias que se moveram
+// ou que foram realocadas por uma eliminação são reenviadas.
+class InstanceRenderer {
+public:
+    // Estatísticas
+    unsigned int instanceGroups;        // grupos de instâncias ativos
+    unsigned int instancedObjects;      // objetos desenhados por instanciamento
+    unsigned long long uploadedInstances; // matrizes reenviadas desde o build
+
+    InstanceRenderer();
+    ~InstanceRenderer();
+
+    // Agrupa os objetos com a mesma malha e a mesma textura (2 ou mais por grupo)
+    // e cria os instance buffers e VAOs de cada grupo
+    bool build(const vector<unique_ptr<OBJ3D>>& objects);
+
+    // true se o objeto é desenhado por um grupo de instâncias
+    bool isInstanced(const OBJ3D* object) const { return slots.count(object) != 0; }
+
+    // Retira o objeto do seu grupo (chamar antes de destruí-lo).
+    // A última instância do grupo ocupa o lugar da removida: uma única matriz é reenviada.
+    void remove(const OBJ3D* object);
+
+    // Reenvia as matrizes dos objetos cuja transformação mudou desde o último frame
+    void update();
+
+    // Adiciona à fila um pacote instanciado por grupo da malha de cada grupo de instâncias
+    // (variante INSTANCED do shader)
+    void enqueue(RenderQueue& queue, ShaderPermutations& shaders, const glm::vec3& cameraPos, float depthScale,
+                 bool useTextureArray) const;
+
+    bool isBuilt() const { return !batches.empty(); }
+
+    void cleanup();
+
+private:
+    struct InstanceBatch {
+        shared_ptr<Mesh> mesh;
+        unsigned int textureID;
+        vector<const OBJ3D*> objects;       // objeto de cada instância (slot)
+        vector<unsigned int> versions;      // transformVersion já enviada de cada slot
+        unsigned int instanceVBO;           // mat4 por instância
+        vector<unsigned int> VAOs;          // um por grupo da malha: VBO/EBO do grupo + instanceVBO
+    };
+
+    vector<InstanceBatch> batches;
+    unordered_map<const OBJ3D*, pair<size_t, size_t>> slots;  // objeto -> (grupo de instâncias, slot)
+
+    void uploadSlot(InstanceBatch& batch, size_t slot);
+};
+
+#endif
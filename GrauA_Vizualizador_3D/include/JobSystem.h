@@ -0,0 +1,157 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <algorithm>
+
+using namespace std;
+
+// Contador de dependências: quantos jobs ainda faltam terminar. Quem enfileira passa o mesmo
+// contador para todos os jobs de um grupo e espera com JobSystem::wait (que ajuda a executá-los)
+struct JobCounter {
+    atomic<int> pending;
+
+    JobCounter() : pending(0) {}
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool isDone() const { return pending.load(memory_order_acquire) == 0; }
+};
+
+// Job pequeno no anel de uma thread (ver JobSystem::submit): o callable fica em "data"
+struct Job {
+    static const size_t DATA_SIZE = 48;
+
+    void (*run)(Job& job);
+    JobCounter* counter;
+    atomic<bool> free;      // o slot do anel pode ser reutilizado (job já iniciado)
+    alignas(16) unsigned char data[DATA_SIZE];
+
+    Job() : run(nullptr), counter(nullptr), free(true) {}
+};
+
+// Sistema de jobs com roubo de trabalho, compartilhado pelo carregamento, pelo culling, pelo
+// tamanho das texturas na tela e pelas colisões. Cada thread de trabalho tem uma deque de Chase-Lev
+// (ver WorkStealingDeque): enfileira e retira os seus jobs na base, sem trava, e quando fica sem
+// trabalho rouba do topo da deque de outra thread escolhida ao acaso. A thread que chama start (a
+// principal) é a thread 0: tem a sua deque e executa jobs enquanto espera (wait), então um
+// parallelFor usa todos os núcleos e a thread principal nunca fica parada com trabalho na fila.
+//
+// Os jobs pequenos (submit, parallelFor) não alocam memória: o callable é copiado para um anel de
+// jobs da própria thread (até Job::DATA_SIZE bytes). As tarefas longas do carregamento (parsing,
+// decodificação, leitura dos níveis das texturas) vão para uma fila de fundo separada (submitBackground),
+// que só as threads de trabalho consomem: a thread principal, esperando o culling do frame, não pega
+// uma decodificação de 100 ms.
+//
+// Uma thread criada fora do sistema (ex.: a da simulação, ver SimulationThread) pode se registrar com
+// attachThread: ganha uma deque e um anel como as threads de trabalho, enfileira os seus jobs e ajuda a
+// executá-los enquanto espera. Sem start (ou fora das threads do sistema e das registradas, no caso de
+// submit) os jobs executam na hora, na própria thread. Os jobs não podem chamar a OpenGL: o contexto
+// pertence à thread principal.
+class JobSystem {
+public:
+    // Cria as threads de trabalho (0 = núcleos disponíveis - 1, no mínimo 1); a thread que chama é a 0
+    static void start(unsigned int workerCount = 0);
+
+    // Espera as threads terminarem o job atual e as encerra; as tarefas de fundo ainda não iniciadas
+    // são descartadas (os seus contadores são liberados)
+    static void stop();
+
+    static bool isStarted();
+
+    // Registra a thread atual, criada fora do sistema, para enfileirar e executar jobs (até
+    // MAX_EXTERNAL_THREADS ao mesmo tempo); false sem start ou sem vaga, e aí os jobs dela executam
+    // na hora. detachThread, com os jobs dela já esperados, libera a vaga (antes de stop)
+    static const unsigned int MAX_EXTERNAL_THREADS = 2;
+    static bool attachThread();
+    static void detachThread();
+
+    // Threads que executam jobs, contando a que chamou start (1 sem start)
+    static unsigned int threadCount();
+
+    // Enfileira um job pequeno na deque da thread atual; "counter" é incrementado agora e
+    // decrementado quando o job terminar
+    template <typename F>
+    static void submit(JobCounter& counter, F&& function);
+
+    // Enfileira uma tarefa longa na fila de fundo (qualquer thread; FIFO)
+    static void submitBackground(JobCounter& counter, function<void()> task);
+
+    // Espera o contador zerar; nas threads do sistema, executa os jobs da fila enquanto isso
+    static void wait(JobCounter& counter);
+
+    // Divide [0, count) em pedaços de até "grain" índices (0 = automático: cerca de 4 pedaços por
+    // thread) e chama body(begin, end) para cada um, em paralelo; retorna quando todos terminarem.
+    // O intervalo é dividido ao meio recursivamente: a thread fica com uma metade e enfileira a outra,
+    // então as threads que roubam levam os pedaços maiores
+    template <typename F>
+    static void parallelFor(size_t count, size_t grain, const F& body);
+
+private:
+    // Slot livre no anel de jobs da thread atual; nullptr fora das threads do sistema
+    static Job* allocate();
+    static void push(Job* job);
+
+    // Move o callable para a pilha e libera o slot antes de executar: um job que espera por um slot
+    // (anel cheio) pode estar executando, aninhado, o job que o ocupa
+    template <typename F>
+    static void invoke(Job& job) {
+        F* stored = reinterpret_cast<F*>(job.data);
+        F function(move(*stored));
+        stored->~F();
+        job.free.store(true, memory_order_release);
+        function();
+    }
+
+    template <typename F>
+    static void splitRange(const F& body, size_t begin, size_t end, size_t grain, JobCounter& counter) {
+        while (end - begin > grain) {
+            size_t middle = begin + (end - begin) / 2;
+            submit(counter, [&body, middle, end, grain, &counter]() {
+                splitRange(body, middle, end, grain, counter);
+            });
+            end = middle;
+        }
+        body(begin, end);
+    }
+};
+
+
+template <typename F>
+void JobSystem::submit(JobCounter& counter, F&& function) {
+    typedef typename decay<F>::type Callable;
+    static_assert(sizeof(Callable) <= Job::DATA_SIZE, "job grande demais: capture por referencia");
+    static_assert(alignof(Callable) <= 16, "alinhamento do job nao suportado");
+
+    Job* job = allocate();
+    if (!job) {
+        function();
+        return;
+    }
+
+    new (job->data) Callable(forward<F>(function));
+    job->run = &invoke<Callable>;
+    job->counter = &counter;
+    counter.pending.fetch_add(1);
+    push(job);
+}
+
+
+template <typename F>
+void JobSystem::parallelFor(size_t count, size_t grain, const F& body) {
+    if (count == 0) return;
+    if (grain == 0) grain = std::max<size_t>(1, count / (threadCount() * 4));
+    if (!isStarted() || count <= grain) {
+        body((size_t)0, count);
+        return;
+    }
+
+    JobCounter counter;
+    splitRange(body, 0, count, grain, counter);
+    wait(counter);
+}
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef LZ4BLOCK_H
+#define LZ4BLOCK_H
+
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+// Compressão no formato de bloco do LZ4 (sequências de literais + cópias de até 64 KB atrás),
+// usada nas entradas do AssetPack. O encoder é guloso, com uma tabela hash de 4 bytes: comprime
+// menos que o LZ4 HC, mas a descompressão (o que roda na carga da cena) é a mesma, a vários GB/s.
+class LZ4Block {
+public:
+    // Tamanho máximo do bloco comprimido de "size" bytes (dados incompressíveis)
+    static size_t maxCompressedSize(size_t size);
+
+    // Comprime "size" bytes em "output" (substitui o conteúdo); retorna o tamanho comprimido
+    static size_t compress(const unsigned char* input, size_t size, vector<unsigned char>& output);
+
+    // Descomprime um bloco de "size" bytes em "output", que precisa ter exatamente "outputSize" bytes;
+    // false se o bloco estiver corrompido
+    static bool decompress(const unsigned char* input, size_t size, unsigned char* output, size_t outputSize);
+};
+
+#endif
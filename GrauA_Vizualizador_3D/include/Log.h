@@ -0,0 +1,180 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <type_traits>
+#include <algorithm>
+
+using namespace std;
+
+// Log assíncrono para os caminhos quentes (colisões, carregamento de cada objeto).
+//
+//   LOG_INFO("Objeto \"{}\" eliminado!", object.name);     // cada {} recebe o próximo argumento
+//   LOG_WARNING("Falha ao carregar textura: {}", path);
+//
+// A macro não formata nem escreve nada: copia o ponteiro do formato (literal) e os argumentos (números,
+// textos de até LogRecord::TEXT_SIZE bytes no total) para um registro binário no anel da própria thread
+// (sem trava: só a thread dona escreve), o que custa algumas dezenas de nanossegundos. Uma thread de fundo
+// recolhe os anéis a cada poucos milissegundos, monta as linhas na ordem em que foram registradas e as
+// escreve de uma vez (um flush por lote, em vez de um endl por mensagem). Anel cheio: o registro é
+// descartado e contado, a thread que registra nunca espera.
+//
+// Cada ponto de chamada aceita no máximo Log::rateLimit mensagens por segundo (uma rajada de eliminações
+// imprime as primeiras e depois uma linha com o número das suprimidas). Com -DLOG_MIN_LEVEL=N as macros
+// abaixo do nível N não geram código (padrão: 1, sem LOG_DEBUG). DEBUG e INFO vão para a saída padrão,
+// WARNING e ERROR para a de erros. Sem Log::start as mensagens são escritas na hora, pela própria thread.
+enum LogLevel {
+    LOG_LEVEL_DEBUG   = 0,
+    LOG_LEVEL_INFO    = 1,
+    LOG_LEVEL_WARNING = 2,
+    LOG_LEVEL_ERROR   = 3
+};
+
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 1
+#endif
+
+// Ponto de chamada de uma macro LOG_* (objeto estático): nível e janela do limite de frequência
+struct LogSite {
+    const char* format;
+    LogLevel level;
+    atomic<int64_t> windowStart;    // início da janela de 1 s (ns do steady_clock)
+    atomic<uint32_t> windowCount;   // mensagens aceitas ou não na janela
+    atomic<uint32_t> suppressed;    // descartadas pelo limite e ainda não informadas
+    int64_t reportedWindow;         // janela das suprimidas já informadas (só quem esvazia os anéis usa)
+    LogSite* next;                  // lista de todos os pontos (relatório das suprimidas)
+
+    LogSite(const char* format, LogLevel level);
+};
+
+// Mensagem ainda não formatada
+struct LogRecord {
+    static const int MAX_ARGS = 6;
+    static const size_t TEXT_SIZE = 120;    // textos dos argumentos (nomes, caminhos), truncados se preciso
+
+    enum ArgType : uint8_t { ARG_INT, ARG_UINT, ARG_DOUBLE, ARG_TEXT };
+
+    int64_t time;           // ns do steady_clock (ordem entre as threads)
+    const LogSite* site;
+    uint8_t argCount;
+    uint8_t textUsed;
+    uint8_t types[MAX_ARGS];
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        uint32_t text;      // posição em "text" (terminado em '\0')
+    } values[MAX_ARGS];
+    char text[TEXT_SIZE];
+};
+
+class Log {
+public:
+    static uint32_t rateLimit;  // mensagens por segundo por ponto de chamada (0 = sem limite)
+
+    // Cria a thread que formata e escreve os registros
+    static void start(ostream& output = cout, ostream& errors = cerr);
+
+    // Escreve o que falta e encerra a thread
+    static void stop();
+
+    // Escreve agora tudo o que já foi registrado, por qualquer thread (ex.: antes de um relatório)
+    static void flush();
+
+    static bool isStarted();
+    static uint64_t droppedCount();     // registros descartados por anel cheio
+
+    // Usado pelas macros
+    template <typename... Args>
+    static void write(LogSite& site, const Args&... args) {
+        static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS, "argumentos demais para um registro de log");
+
+        int64_t time = now();
+        if (!admit(site, time)) return;
+
+        LogRecord* record = reserve();
+        if (!record) return;
+        record->time = time;
+        record->site = &site;
+        record->argCount = 0;
+        record->textUsed = 0;
+        int expand[] = { 0, (put(*record, args), 0)... };
+        (void)expand;
+        commit(record);
+    }
+
+    static inline int64_t now() {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    static bool admit(LogSite& site, int64_t time);
+    static LogRecord* reserve();            // slot livre no anel da thread (nullptr = cheio; ou o registro local, sem start)
+    static void commit(LogRecord* record);
+
+    template <typename T>
+    static typename enable_if<is_integral<T>::value && is_signed<T>::value>::type put(LogRecord& record, T value) {
+        record.types[record.argCount] = LogRecord::ARG_INT;
+        record.values[record.argCount++].i = value;
+    }
+
+    template <typename T>
+    static typename enable_if<is_integral<T>::value && !is_signed<T>::value>::type put(LogRecord& record, T value) {
+        record.types[record.argCount] = LogRecord::ARG_UINT;
+        record.values[record.argCount++].u = value;
+    }
+
+    template <typename T>
+    static typename enable_if<is_floating_point<T>::value>::type put(LogRecord& record, T value) {
+        record.types[record.argCount] = LogRecord::ARG_DOUBLE;
+        record.values[record.argCount++].d = value;
+    }
+
+    static void put(LogRecord& record, const char* value) { putText(record, value, strlen(value)); }
+    static void put(LogRecord& record, const string& value) { putText(record, value.data(), value.size()); }
+
+    // Copia o texto (truncado no espaço que sobrou); o último byte fica reservado para o '\0'
+    static void putText(LogRecord& record, const char* value, size_t length) {
+        size_t offset = record.textUsed;
+        length = std::min(length, LogRecord::TEXT_SIZE - 1 - offset);
+        memcpy(record.text + offset, value, length);
+        record.text[offset + length] = '\0';
+        record.textUsed = (uint8_t)std::min(offset + length + 1, LogRecord::TEXT_SIZE - 1);
+        record.types[record.argCount] = LogRecord::ARG_TEXT;
+        record.values[record.argCount++].text = (uint32_t)offset;
+    }
+};
+
+#define LOG_AT(level, format, ...) \
+    do { static LogSite logSite(format, level); Log::write(logSite, ##__VA_ARGS__); } while (0)
+
+#if LOG_MIN_LEVEL <= 0
+#define LOG_DEBUG(format, ...)   LOG_AT(LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(format, ...)   ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= 1
+#define LOG_INFO(format, ...)    LOG_AT(LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(format, ...)    ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= 2
+#define LOG_WARNING(format, ...) LOG_AT(LOG_LEVEL_WARNING, format, ##__VA_ARGS__)
+#else
+#define LOG_WARNING(format, ...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= 3
+#define LOG_ERROR(format, ...)   LOG_AT(LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(format, ...)   ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+using namespace std;
+
+// Fila sem trava com vários produtores e um único consumidor (lista encadeada de D. Vyukov).
+// push pode ser chamado de qualquer thread e nunca espera (uma troca atômica); pop só pode ser
+// chamado pelo consumidor. Um item cujo push ainda não terminou (entre a troca e a ligação do nó)
+// aparece no próximo pop; por isso uma fila "vazia" pode ter itens a caminho.
+template <typename T>
+class MPSCQueue {
+public:
+    MPSCQueue() : head(&stub), tail(&stub) {}
+
+    ~MPSCQueue() {
+        T value;
+        while (pop(value)) {}
+        if (tail != &stub) delete tail;
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    void push(T&& value) {
+        Node* node = new Node(move(value));
+        Node* previous = head.exchange(node, memory_order_acq_rel);
+        previous->next.store(node, memory_order_release);
+    }
+
+    // Retira o item mais antigo; false se não houver nenhum disponível
+    bool pop(T& value) {
+        Node* next = tail->next.load(memory_order_acquire);
+        if (next == nullptr) return false;
+
+        value = move(next->value);  // "next" passa a ser o nó sentinela
+        Node* previous = tail;
+        tail = next;
+        if (previous != &stub) delete previous;
+        return true;
+    }
+
+private:
+    struct Node {
+        atomic<Node*> next;
+        T value;
+
+        Node() : next(nullptr) {}
+        explicit Node(T&& item) : next(nullptr), value(move(item)) {}
+    };
+
+    Node stub;              // sentinela inicial
+    atomic<Node*> head;     // último nó inserido (produtores)
+    Node* tail;             // sentinela atual; o próximo item é tail->next (consumidor)
+};
+
+#endif
@@ -47,6 +47,16 @@ public:
     // Este, por sua vez, preenche os vetores e mapas passados por referência.
     bool readObjectModel(string& path);
 
+    // Parte da CPU de readObjectModel: lê o OBJ, calcula a bounding box e gera os dados dos vértices
+    // de cada grupo, sem chamadas OpenGL (pode rodar fora da thread principal - ver AssetLoader)
+    bool readObjectData(const string& path);
+
+    // Idem, com o conteúdo do arquivo já lido (ver FileReader)
+    bool readObjectData(const string& path, const vector<unsigned char>& contents);
+
+    // Parte da OpenGL: cria os buffers dos grupos já preparados por readObjectData (thread principal)
+    void uploadBuffers();
+
     // Configura os buffers OpenGL (VBOs, VAOs) para cada grupo da malha
     void setupBuffers();
     
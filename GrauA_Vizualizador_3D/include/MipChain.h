@@ -0,0 +1,53 @@
+#ifndef MIPCHAIN_H
+#define MIPCHAIN_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Filtro usado para gerar os mipmaps
+enum MipFilter {
+    MIP_FILTER_GPU,     // glGenerateMipmap depois do envio do nível 0 (padrão)
+    MIP_FILTER_BOX,     // média da área coberta por cada texel (2x2 em dimensões pares)
+    MIP_FILTER_KAISER   // sinc com janela de Kaiser: mais nítido, sem o serrilhado da caixa
+};
+
+// Um nível de mipmap gerado na CPU
+struct MipLevel {
+    int width, height;
+    vector<unsigned char> pixels;   // mesmo número de canais do nível 0, linhas sem preenchimento
+};
+
+// Geração de mipmaps na CPU, para as threads de trabalho entregarem a cadeia pronta e a thread
+// principal só enviar os níveis (ver AssetLoader e System::updateLoading).
+// Cada nível é reduzido do anterior por um filtro separável (linhas, depois colunas); as bordas
+// repetem a imagem, como o GL_REPEAT das texturas da cena. Não acessa a OpenGL.
+class MipChain {
+public:
+    // Número de níveis de uma textura width x height, do nível 0 até 1x1
+    static int levelCount(int width, int height);
+
+    // Gera os níveis 1..n a partir do nível 0 (1 a 4 canais); não faz nada com MIP_FILTER_GPU
+    static void build(const unsigned char* data, int width, int height, int channels, MipFilter filter,
+                      vector<MipLevel>& levels);
+
+    // Reduz uma imagem à metade (arredondada para baixo, mínimo 1) em cada dimensão
+    static void downsample(const unsigned char* source, int width, int height, int channels, MipFilter filter,
+                           MipLevel& level);
+
+    // Nome do filtro na linha de comando (gpu, box, kaiser) e o inverso; false se o nome for inválido
+    static const char* filterName(MipFilter filter);
+    static bool parseFilter(const string& name, MipFilter& filter);
+
+private:
+    // Pesos de um texel de destino: fonte = (first + i) módulo o tamanho de origem
+    struct Taps {
+        int first;
+        vector<float> weights;
+    };
+
+    static void computeTaps(int sourceSize, int destinationSize, MipFilter filter, vector<Taps>& taps);
+};
+
+#endif
@@ -2,17 +2,21 @@
 #define OBJ3D_H
 
 #include <string>
+#include <memory>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "Mesh.h"
 #include "Shader.h"
+#include "ShaderPermutations.h"
 #include "Texture.h"
+#include "TextureArray.h"
+#include "RenderQueue.h"
 
 using namespace std;
 
 class OBJ3D {
 public:
-    Mesh mesh;  // malha do objeto 3D
+    shared_ptr<Mesh> mesh;  // malha do objeto 3D (compartilhada entre objetos com o mesmo arquivo .obj)
     glm::mat4 transform;    // matriz de transformação do objeto (model matrix)
     glm::vec3 position;     // posição do objeto
     glm::vec3 rotation;     // ângulos de rotação do objeto (em radianos)
@@ -24,6 +28,10 @@ public:
     // Texture support
     unsigned int textureID;
     bool hasTexture;
+    TextureLayer arrayTexture;  // mesma textura empacotada em um texture array (ver TextureArray)
+
+    // Incrementado a cada atualização da matriz de transformação
+    unsigned int transformVersion;
     
     OBJ3D();
 
@@ -34,8 +42,14 @@ public:
     // Carrega um objeto 3D a partir de um arquivo
     bool loadObject(string& path);
 
-    // Renderiza o objeto 3D usando o shader fornecido
-    void render(const Shader& shader) const;
+    // Usa uma malha já carregada por outro objeto (mesmo arquivo .obj)
+    void setMesh(const shared_ptr<Mesh>& sharedMesh, const string& path);
+
+    // Adiciona à fila de renderização um pacote de desenho por grupo da malha, com a variante
+    // de shader correspondente ao material (depthScale normaliza a distância até a câmera para a
+    // chave de ordenação; useTextureArray = amostra a textura da camada em arrayTexture, se houver)
+    void enqueue(RenderQueue& queue, ShaderPermutations& shaders, const glm::vec3& cameraPos, float depthScale,
+                 bool useTextureArray) const;
     
     // Define a posição, rotação e escala do objeto e atualiza a matriz de transformação
     void setPosition(const glm::vec3& pos);
@@ -43,6 +57,7 @@ public:
     void setScale   (const glm::vec3& scl);
     void setEliminable(bool canEliminate);
     void setTexture(const string& texturePath);
+    void setTexture(const string& texturePath, unsigned int sharedTextureID); // textura já carregada
     
     void translate(const glm::vec3& offset);
     void rotate(const glm::vec3& angles);
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <istream>
 #include <glm/glm.hpp>
 #include "Group.h"
 
@@ -18,6 +19,14 @@ public:
                         vector<glm::vec2>& texCoords,
                         vector<glm::vec3>& normals,
                         vector<Group>& groups);
+
+    // Mesmo que readFileOBJ, sobre um stream já aberto ("path" só identifica o arquivo)
+    static bool readOBJ(istream& objFile,
+                        const string& path,
+                        vector<glm::vec3>& vertices,
+                        vector<glm::vec2>& texCoords,
+                        vector<glm::vec3>& normals,
+                        vector<Group>& groups);
     
     // Divide uma string em substrings com base em um delimitador
     static vector<string> split(const string& str, char delimiter);
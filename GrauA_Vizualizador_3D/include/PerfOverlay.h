@@ -0,0 +1,57 @@
+#ifndef PERFOVERLAY_H
+#define PERFOVERLAY_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <glm/glm.hpp>
+#include "Shader.h"
+
+using namespace std;
+
+// Overlay de desempenho (tecla F3): FPS, gráfico dos últimos tempos de frame, CPU x GPU,
+// draw calls, triângulos, mudanças de estado, objetos visíveis/descartados, projéteis e memória.
+// Os valores vêm do registro central (ver Stats.h). Texto e retângulos são acumulados em um único
+// vertex buffer e desenhados com um draw call, com uma fonte bitmap 5x7 embutida (atlas R8).
+class PerfOverlay {
+public:
+    static const int GRAPH_SAMPLES = 120;   // frames no gráfico
+
+    bool visible;
+
+    PerfOverlay();
+    ~PerfOverlay();
+
+    // Cria o shader, o atlas da fonte e os buffers
+    bool initialize();
+
+    // Acrescenta o tempo de um frame ao gráfico (chamado em todo frame, visível ou não)
+    void recordFrame(float frameMs);
+
+    // Desenha sobre o framebuffer atual (width x height em pixels)
+    void render(int width, int height);
+
+    bool isInitialized() const { return VAO != 0; }
+
+    void cleanup();
+
+private:
+    unique_ptr<Shader> shader;
+    unsigned int VAO, VBO, fontTexture;
+    size_t bufferCapacity;      // floats alocados no VBO
+
+    vector<float> vertices;     // x, y, u, v, r, g, b, a por vértice (6 vértices por retângulo)
+    float history[GRAPH_SAMPLES];
+    int historyHead;
+    int historyCount;
+    double memoryTimer;         // a memória do processo é lida duas vezes por segundo
+    float smoothedFrameMs;
+
+    void addQuad(float x, float y, float w, float h, const glm::vec4& color,
+                 float u0 = -1.0f, float v0 = -1.0f, float u1 = -1.0f, float v1 = -1.0f);
+    float addText(float x, float y, const string& text, const glm::vec4& color);   // retorna o x final
+    void addGraph(float x, float y, float w, float h);
+    void buildFontAtlas();
+};
+
+#endif
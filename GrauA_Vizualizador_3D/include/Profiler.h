@@ -0,0 +1,139 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+
+#ifdef ENABLE_PROFILER
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+using namespace std;
+
+// Profiler de CPU por escopos.
+//
+//   PROFILE_SCOPE("System::render");   // mede do ponto da macro até o fim do bloco (RAII)
+//   PROFILE_FUNCTION();                // idem, com o nome da função
+//
+// Só existe quando compilado com -DENABLE_PROFILER; sem a flag as macros não geram código.
+// Cada thread grava seus escopos em um buffer circular próprio (sem locks: só a thread dona
+// escreve; o índice é atômico para a exportação), com o contador de ciclos da CPU (TSC) como
+// relógio nos x86, ou steady_clock nas demais arquiteturas. Os escopos aninhados guardam a
+// profundidade, e o resultado é exportado no formato de trace do Chrome
+// (abrir em chrome://tracing ou https://ui.perfetto.dev).
+class Profiler {
+public:
+    static constexpr size_t RING_SIZE = 1 << 16;   // escopos guardados por thread (os mais antigos são sobrescritos)
+
+    // Escopo concluído
+    struct Event {
+        const char* name;   // literal: só o ponteiro é guardado
+        uint64_t start;     // ticks (ver now)
+        uint64_t end;
+        uint32_t depth;     // 0 = escopo mais externo da thread
+    };
+
+    // Buffer circular de uma thread
+    struct ThreadBuffer {
+        Event events[RING_SIZE];
+        atomic<uint64_t> written;   // total de eventos já gravados (posição = written % RING_SIZE)
+        uint32_t depth;
+        uint32_t threadIndex;
+        string threadName;
+    };
+
+    // true se o profiler foi compilado (-DENABLE_PROFILER)
+    static bool isCompiledIn();
+
+    // Nome da thread atual no trace (ex.: "principal", "worker 2")
+    static void setThreadName(const string& name);
+
+    // Pass de GPU medido por GpuTimer: aparece em uma linha "GPU" do trace, a partir do instante
+    // em que foi submetido (ou do fim do pass anterior); a posição é aproximada, a duração é a medida
+    static void addGpuEvent(const char* name, uint64_t submitTicks, double durationMs);
+
+    // Ticks do relógio por microssegundo (calibrado contra steady_clock desde o início do programa)
+    static double ticksPerMicrosecond();
+
+    // Grava os eventos de todas as threads em JSON (trace events do Chrome).
+    // Deve ser chamado com as threads instrumentadas paradas (normalmente no desligamento).
+    static bool writeChromeTrace(const string& path);
+
+    // Relógio do profiler
+    static inline uint64_t now() {
+#if defined(ENABLE_PROFILER) && (defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__))
+        return __rdtsc();
+#else
+        return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // Buffer da thread atual (registrado no primeiro escopo da thread)
+    static ThreadBuffer& threadBuffer() {
+        thread_local ThreadBuffer* buffer = registerThread();
+        return *buffer;
+    }
+
+    // Acrescenta um evento ao buffer (só a thread dona do buffer chama)
+    static inline void push(ThreadBuffer& buffer, const char* name, uint64_t start, uint64_t end, uint32_t depth) {
+        uint64_t index = buffer.written.load(memory_order_relaxed);
+        Event& event = buffer.events[index & (RING_SIZE - 1)];
+        event.name  = name;
+        event.start = start;
+        event.end   = end;
+        event.depth = depth;
+        buffer.written.store(index + 1, memory_order_release);
+    }
+
+private:
+    static ThreadBuffer* registerThread();
+    static ThreadBuffer* createBuffer(const string& name);
+};
+
+
+#ifdef ENABLE_PROFILER
+
+// Marca o início no construtor e grava o evento no destrutor
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : name(name), buffer(Profiler::threadBuffer()) {
+        depth = buffer.depth++;
+        start = Profiler::now();
+    }
+
+    ~ProfileScope() {
+        uint64_t end = Profiler::now();
+        buffer.depth--;
+        Profiler::push(buffer, name, start, end, depth);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    Profiler::ThreadBuffer& buffer;
+    uint64_t start;
+    uint32_t depth;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b)  PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name)   ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FUNCTION()    PROFILE_SCOPE(__func__)
+
+#else
+
+#define PROFILE_SCOPE(name)   ((void)0)
+#define PROFILE_FUNCTION()    ((void)0)
+
+#endif
+
+#endif
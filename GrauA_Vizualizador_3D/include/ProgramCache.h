@@ -0,0 +1,41 @@
+#ifndef PROGRAMCACHE_H
+#define PROGRAMCACHE_H
+
+#include <string>
+#include <cstdint>
+#include <glad/glad.h>
+
+using namespace std;
+
+// Cache em disco de programas já linkados (glGetProgramBinary / glProgramBinary).
+// Cada programa é salvo em "<directory>/<chave>.bin"; a chave é um hash do código fonte dos
+// dois estágios (que já inclui os #define das variantes), de GL_RENDERER e de GL_VERSION,
+// então trocar de driver ou de placa invalida o cache sozinho. Se o driver recusar o binário
+// (formato diferente, driver atualizado), o Shader volta a compilar a partir do código fonte.
+class ProgramCache {
+public:
+    static string directory;    // pasta dos binários (relativa ao diretório de execução)
+    static bool enabled;        // false = sempre compila (ou contexto sem suporte)
+
+    // Estatísticas desde o início da execução
+    static unsigned int hits;       // programas carregados do disco
+    static unsigned int misses;     // programas compilados (sem arquivo no cache)
+    static unsigned int rejected;   // binários recusados pelo driver ou corrompidos
+
+    // Chave do programa: hash FNV-1a de 64 bits
+    static uint64_t makeKey(const string& vertexSource, const string& fragmentSource);
+
+    // Tenta carregar o binário da chave no programa (já criado com glCreateProgram).
+    // Retorna true se o programa ficou linkado.
+    static bool load(GLuint program, uint64_t key);
+
+    // Salva o binário de um programa linkado (criado com GL_PROGRAM_BINARY_RETRIEVABLE_HINT)
+    static void store(GLuint program, uint64_t key);
+
+    static void printReport();
+
+private:
+    static string pathFor(uint64_t key);
+};
+
+#endif
@@ -4,11 +4,14 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "Shader.h"
+#include "ShaderPermutations.h"
+#include "RenderQueue.h"
 
 
 class Projetil {
 public:
     glm::vec3 position;
+    glm::vec3 previousPosition;     // posição antes do último update (interpolação, ver SimulationThread)
     glm::vec3 direction;
     float speed;
     float lifetime;
@@ -20,8 +23,9 @@ public:
     
     Projetil();
 
-    // Construtor com parâmetros
-    Projetil(const glm::vec3& startPos, const glm::vec3& dir, float projetilSpeed = 5.0f, float maxLife = 5.0f);
+    // Construtor com parâmetros (createMesh = false: só o movimento, sem VAO - projéteis da thread de simulação)
+    Projetil(const glm::vec3& startPos, const glm::vec3& dir, float projetilSpeed = 5.0f, float maxLife = 5.0f,
+             bool createMesh = true);
     
     ~Projetil();
     
@@ -31,6 +35,9 @@ public:
     // Renderiza o projétil
     void draw(const Shader& shader) const;
 
+    // Adiciona o projétil à fila de renderização (pass dos projéteis, variante sem textura do shader)
+    void enqueue(RenderQueue& queue, ShaderPermutations& shaders) const;
+
     bool isActive() const { return active && lifetime < maxLifetime; }
 
     // Calcula a direção do vetor de reflexão
@@ -0,0 +1,101 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Shader.h"
+#include "GpuTimer.h"
+
+using namespace std;
+
+// Passes de renderização - ocupam os bits mais significativos da chave de ordenação,
+// então todos os pacotes de um pass são submetidos antes dos pacotes do pass seguinte
+enum RenderPass { PASS_OPAQUE = 0, PASS_PROJECTILE = 1 };
+
+// Pacote de desenho: tudo o que é necessário para emitir um draw call de um grupo
+struct DrawPacket {
+    uint64_t key;            // chave de ordenação (ver RenderQueue::makeKey)
+    const Shader* shader;    // programa usado pelo pacote
+    unsigned int VAO;        // VAO do grupo (malha)
+    int indexCount;          // número de índices para glDrawElements (0 = não indexado)
+    int vertexCount;         // número de vértices para glDrawArrays (quando não indexado)
+    int instanceCount;       // > 0: glDrawElementsInstanced, model vem do instance buffer (ver InstanceRenderer)
+    unsigned int textureID;  // textura difusa (0 = sem textura) ou texture array, se textureLayer >= 0
+    int textureLayer;        // camada no texture array (-1 = textureID é uma GL_TEXTURE_2D comum)
+    glm::mat4 model;         // matriz de transformação do objeto
+    glm::vec3 color;         // cor sólida (usada quando não há textura)
+};
+
+// Contadores de mudanças de estado (e draw calls) de um frame
+struct RenderStats {
+    unsigned int drawCalls;
+    unsigned int instancedDrawCalls;    // parte dos draw calls que desenha várias instâncias
+    unsigned int programBinds;
+    unsigned int textureBinds;
+    unsigned int vaoBinds;
+    unsigned int uniformUpdates;
+    unsigned long long triangles;       // triângulos submetidos (todas as instâncias)
+
+    RenderStats() : drawCalls(0), instancedDrawCalls(0), programBinds(0), textureBinds(0), vaoBinds(0), uniformUpdates(0),
+                    triangles(0) {}
+
+    // total de chamadas que alteram estado da OpenGL (sem contar os draw calls)
+    unsigned int stateChanges() const { return programBinds + textureBinds + vaoBinds + uniformUpdates; }
+};
+
+// Fila de renderização: coleta os pacotes de desenho do frame, ordena pela chave de 64 bits
+// (radix sort) e submete à OpenGL pulando binds redundantes entre pacotes consecutivos
+class RenderQueue {
+public:
+    RenderStats stats;       // mudanças de estado efetivamente emitidas no último flush
+    RenderStats naiveStats;  // o que o caminho antigo (objeto a objeto) teria emitido no mesmo frame
+
+    // Acumulados desde o início da execução (para o relatório no desligamento)
+    unsigned long long frames;
+    RenderStats totalStats;
+    RenderStats totalNaiveStats;
+
+    GpuTimer* gpuTimer;      // se definido, cada pass da fila é medido na GPU (ver GpuTimer)
+
+    RenderQueue();
+
+    // Monta a chave: pass<4> | shader<8> | textura<16> | malha<20> | profundidade<16>
+    static uint64_t makeKey(RenderPass pass, unsigned int shaderID, unsigned int textureID,
+                            unsigned int meshID, float depth);
+
+    // Nome do pass (tempos de GPU e trace)
+    static const char* passName(RenderPass pass);
+
+    // Campo de textura da chave: para texture arrays, array<8> | camada<8>, de modo que
+    // os pacotes de uma mesma camada fiquem contíguos e o uniform textureLayer mude pouco
+    static unsigned int textureKey(unsigned int textureID, int layer);
+
+    // Limpa os pacotes do frame anterior
+    void clear();
+
+    // Adiciona um pacote à fila
+    void submit(const DrawPacket& packet);
+
+    // Soma ao relatório "antes" as chamadas que o caminho antigo faria para um objeto
+    void countNaiveObject(bool textured, unsigned int groupCount);
+    void countNaiveProjectile();
+
+    // Ordena os pacotes e emite os draw calls, atualizando stats
+    void flush(const glm::mat4& view, const glm::mat4& projection);
+
+    // Imprime a média de mudanças de estado por frame (antes x depois)
+    void printReport() const;
+
+    size_t size() const { return packets.size(); }
+
+private:
+    vector<DrawPacket> packets;
+    vector<uint64_t> sortKeys, sortKeysTmp;       // chaves sendo ordenadas
+    vector<uint32_t> sortIndices, sortIndicesTmp; // índices dos pacotes, permutados junto com as chaves
+
+    // LSD radix sort de 8 bits por passada; passadas em que todas as chaves têm o mesmo byte são puladas
+    void radixSort();
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef SCENEGENERATOR_H
+#define SCENEGENERATOR_H
+
+#include <string>
+#include <vector>
+#include <random>
+#include <glm/glm.hpp>
+
+using namespace std;
+
+// Distribuição espacial dos objetos gerados
+enum SceneDistribution {
+    DISTRIBUTION_UNIFORM,   // posições aleatórias em uma caixa
+    DISTRIBUTION_CLUSTERED, // aglomerados (gaussianas ao redor de centros aleatórios)
+    DISTRIBUTION_GRID       // grade regular no plano XZ
+};
+
+// Parâmetros da cena sintética (--generate-scene); os valores padrão geram uma cena pequena
+struct SceneGeneratorOptions {
+    string directory;               // destino: cena.txt, models/ e textures/
+    size_t objects = 1000;          // --objects N (10 a 1M)
+    unsigned int meshes = 8;        // --meshes N: arquivos .obj distintos
+    unsigned int meshFaces = 500;   // --mesh-faces N: triângulos por malha (densidade)
+    unsigned int textures = 8;      // --textures N: texturas distintas (0 = sem textura)
+    unsigned int textureSize = 64;  // --texture-size N (lado, em pixels)
+    float instancing = 0.5f;        // --instancing 0..1: fração dos objetos que compartilham malha + textura
+    SceneDistribution distribution = DISTRIBUTION_UNIFORM;  // --distribution uniform|clustered|grid
+    float extent = 0.0f;            // --extent L: meia largura da região (0 = automático pela quantidade)
+    unsigned int seed = 1;          // --seed N: mesma semente, mesma cena
+};
+
+// Gerador de cenas de estresse: escreve um arquivo de configuração no formato de Configurador_Cena.txt,
+// malhas OBJ sintéticas (esferas deformadas) e texturas PPM, para medir como o carregamento e o frame
+// escalam com o número de objetos (ver "Cenas de estresse" no README).
+//
+// Instanciamento: os objetos "compartilhados" usam poucas combinações malha + textura (desenhadas em
+// grupo pelo InstanceRenderer); cada um dos demais recebe uma combinação exclusiva enquanto houver
+// (meshes x textures), então cenas grandes com pouco instanciamento precisam de mais malhas e texturas.
+class SceneGenerator {
+public:
+    // Escreve a cena inteira; não precisa de contexto OpenGL
+    static bool generate(const SceneGeneratorOptions& options);
+
+private:
+    static bool writeMesh(const string& path, unsigned int faces, mt19937& random);
+    static bool writeTexture(const string& path, unsigned int size, unsigned int index);
+    static glm::vec3 randomPosition(const SceneGeneratorOptions& options, float extent,
+                                    const vector<glm::vec3>& clusters, mt19937& random, size_t index);
+};
+
+#endif
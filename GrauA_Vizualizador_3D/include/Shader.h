@@ -2,6 +2,7 @@
 #define SHADER_H
 
 #include <string>
+#include <cstdint>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -19,6 +20,18 @@ public:
     bool loadFromFiles(const string& vertexPath, const string& fragmentPath);
     bool loadFromStrings(const string& vertexSource, const string& fragmentSource);
 
+    // Carregamento em duas etapas: beginLoad usa o cache de programas (ProgramCache) ou dispara
+    // a compilação e o link sem esperar o resultado; finishLoad verifica os erros e grava o binário
+    // no cache. Com KHR_parallel_shader_compile o driver compila vários programas ao mesmo tempo
+    // entre as duas chamadas. loadFromStrings = beginLoad + finishLoad.
+    bool beginLoad(const string& vertexSource, const string& fragmentSource);
+    bool finishLoad();
+
+    // true se o programa terminou de compilar (sempre true sem KHR_parallel_shader_compile)
+    bool isReady() const;
+
+    bool loadedFromCache;   // o último carregamento veio do cache de programas
+
     void use() const;
     
     // Funções utilitárias para uniformes
@@ -36,6 +49,11 @@ public:
     void setMat4 (const std::string& name, const glm::mat4& mat) const;
     
 private:
+    // Estado entre beginLoad e finishLoad
+    unsigned int pendingVertex, pendingFragment;
+    uint64_t cacheKey;
+    bool pending;
+
     string readFile(const string& filePath) const;
     unsigned int compileShader(const string& source, GLenum shaderType) const;
     bool checkCompileErrors(unsigned int shader, const string& type) const;
@@ -0,0 +1,59 @@
+#ifndef SHADERPERMUTATIONS_H
+#define SHADERPERMUTATIONS_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "Shader.h"
+
+using namespace std;
+
+// Funcionalidades de um shader, combinadas em uma máscara de bits.
+// Cada bit vira um #define no código fonte, então cada combinação compila um programa
+// especializado, sem desvios em tempo de execução (o antigo "uber shader" testava
+// isProjectile e hasDiffuseMap em todo vértice e fragmento).
+enum ShaderFeature {
+    SHADER_TEXTURED      = 1 << 0,  // amostra a textura difusa (senão usa objectColor)
+    SHADER_INSTANCED     = 1 << 1,  // matriz model por instância nos atributos 3 a 6 (ver InstanceRenderer)
+    SHADER_TEXTURE_ARRAY = 1 << 2,  // textura difusa é uma camada de um texture array (ver TextureArray)
+
+    SHADER_FEATURE_COUNT = 3
+};
+
+// Cache de variantes de um par de shaders (vertex/fragment), indexado pela máscara de funcionalidades.
+// A variante é compilada na primeira vez em que é pedida; prepare() adianta a compilação
+// para o carregamento, evitando travadas no primeiro frame que a usa.
+class ShaderPermutations {
+public:
+    ShaderPermutations();
+    ~ShaderPermutations();
+
+    // Código fonte comum a todas as variantes (os #define são inseridos logo após o #version)
+    void setSources(const string& vertexSource, const string& fragmentSource);
+
+    // Programa da variante (nullptr se a compilação falhou; a falha também fica no cache)
+    const Shader* get(unsigned int features);
+
+    // Compila antecipadamente as variantes; retorna false se alguma falhar
+    bool prepare(const vector<unsigned int>& featureSets);
+
+    // Remove combinações sem efeito (ex.: TEXTURE_ARRAY sem TEXTURED), para que não gerem programas repetidos
+    static unsigned int normalize(unsigned int features);
+
+    // Linhas "#define X" correspondentes à máscara
+    static string defines(unsigned int features);
+
+    size_t variantCount() const { return variants.size(); }
+
+    void cleanup();
+
+private:
+    string vertexSource, fragmentSource;
+    unordered_map<unsigned int, unique_ptr<Shader>> variants;
+
+    // Insere as definições depois da linha #version (que precisa ser a primeira do shader)
+    static string injectDefines(const string& source, const string& definitions);
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef SIMULATIONTHREAD_H
+#define SIMULATIONTHREAD_H
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Camera.h"
+#include "InputRecording.h"
+#include "TripleBuffer.h"
+
+using namespace std;
+
+class OBJ3D;
+
+// Pose da câmera da simulação (os vetores Front/Right/Up são recalculados a partir dos ângulos)
+struct CameraState {
+    glm::vec3 position;
+    float yaw, pitch, zoom;
+
+    CameraState() : position(0.0f), yaw(YAW), pitch(PITCH), zoom(ZOOM) {}
+    explicit CameraState(const Camera& camera)
+        : position(camera.Position), yaw(camera.Yaw), pitch(camera.Pitch), zoom(camera.Zoom) {}
+};
+
+// Projétil ativo ao fim do passo, com a posição do início do passo (interpolação)
+struct ProjectileInstance {
+    glm::vec3 previous;
+    glm::vec3 position;
+};
+
+// Estado publicado pela simulação ao fim de cada passo; a renderização só lê. Os objetos da cena
+// não se movem, então as suas transformações ficam nos próprios OBJ3D (imutáveis depois do
+// carregamento) e o snapshot leva apenas o conjunto dos que continuam vivos
+struct SimulationSnapshot {
+    uint64_t tick;                  // passos simulados (0 = nada publicado ainda)
+    chrono::steady_clock::time_point time;  // fim do passo
+    CameraState previousCamera;     // câmera no início e no fim do passo
+    CameraState camera;
+    vector<ProjectileInstance> projectiles;
+    uint64_t sceneVersion;          // muda a cada eliminação
+    vector<OBJ3D*> objects;         // objetos vivos, na ordem da cena (só é copiado quando sceneVersion muda)
+    unsigned int collisionTests;    // testes raio x bounding box do passo
+
+    SimulationSnapshot() : tick(0), sceneVersion(0), collisionTests(0) {}
+};
+
+// Simulação em uma thread própria, com passo fixo: a cada "tickTime" segundos a função de passo
+// recebe a entrada acumulada desde o passo anterior e preenche um snapshot, publicado para a thread de
+// renderização por um buffer triplo (TripleBuffer). A renderização não espera a simulação: desenha o
+// snapshot mais recente, interpolando entre o início e o fim do passo conforme o tempo decorrido desde a
+// publicação (um passo de atraso). Um passo lento atrasa os seguintes, mas não os frames; com o dt fixo
+// o resultado da simulação não depende da taxa de frames.
+class SimulationThread {
+public:
+    // Executa um passo e preenche todo o snapshot; false = nada a simular, a simulação terminou
+    // (ex.: fim da gravação reproduzida) e o snapshot não é publicado
+    typedef function<bool(const FrameInput& input, float deltaTime, SimulationSnapshot& snapshot)> Step;
+
+    SimulationThread();
+    ~SimulationThread();
+
+    void start(float tickTime, Step step);
+    void stop();    // espera o passo atual terminar
+
+    bool isStarted() const { return worker.joinable(); }
+    bool isFinished() const { return finished.load(); }
+    float tickTime() const { return period; }
+    uint64_t lateTicks() const { return late.load(); }  // passos que atrasaram mais que MAX_LAG
+
+    // Thread de renderização: acrescenta a entrada do frame à do próximo passo (ver InputAccumulator)
+    void pushInput(const FrameInput& frameInput);
+
+    // Thread de renderização: snapshot mais recente e fração do passo seguinte já decorrida (0..1)
+    const SimulationSnapshot& latest(float& alpha);
+
+private:
+    // atraso além do qual a simulação desiste de recuperar os passos (em vez de executá-los em rajada)
+    static constexpr double MAX_LAG = 0.25;
+
+    Step step;
+    float period;
+    thread worker;
+    atomic<bool> stopping;
+    atomic<bool> finished;
+    atomic<uint64_t> late;
+
+    mutex inputMutex;
+    InputAccumulator pendingInput;  // entrada dos frames desde o último passo
+
+    TripleBuffer<SimulationSnapshot> snapshots;
+
+    FrameInput takeInput();
+    void run();
+};
+
+#endif
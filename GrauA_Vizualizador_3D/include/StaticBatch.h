@@ -0,0 +1,96 @@
+#ifndef STATICBATCH_H
+#define STATICBATCH_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "OBJ3D.h"
+#include "Shader.h"
+#include "GLExtensions.h"
+
+using namespace std;
+
+// Caminho de renderização por multi-draw indirect:
+// toda a geometria estática fica em um único vertex buffer e um único index buffer (com offsets por grupo),
+// as transformações e materiais de cada objeto ficam em um SSBO e o frame é desenhado com
+// glMultiDrawElementsIndirect, indexando o SSBO por gl_DrawID no vertex shader.
+// O buffer de comandos só é reconstruído quando o conjunto de objetos visíveis muda.
+class StaticBatch {
+public:
+    // Estatísticas do último frame
+    unsigned int multiDrawCalls;    // chamadas glMultiDrawElementsIndirect emitidas
+    unsigned int commandCount;      // comandos de desenho (um por grupo visível)
+    unsigned int triangleCount;     // triângulos dos comandos
+    unsigned int visibleObjects;
+    unsigned int culledObjects;
+    unsigned long long commandRebuilds; // reconstruções do buffer de comandos desde o build
+
+    StaticBatch();
+    ~StaticBatch();
+
+    // Verifica se o contexto suporta o caminho (MDI + SSBO + gl_DrawID)
+    static bool isSupported();
+
+    // Copia a geometria de todos os objetos para os buffers compartilhados.
+    // Malhas com o mesmo arquivo .obj são armazenadas uma única vez.
+    bool build(const vector<unique_ptr<OBJ3D>>& objects);
+
+    // Força a reconstrução dos comandos no próximo frame (ex.: objeto eliminado)
+    void markDirty() { dirty = true; }
+
+    // Desenha os objetos visíveis (frustum culling pela bounding box transformada).
+    // useTextureArray = texturas lidas das camadas dos texture arrays (um bind por array)
+    void render(const vector<unique_ptr<OBJ3D>>& objects, const Shader& shader,
+                const glm::mat4& view, const glm::mat4& projection, bool useTextureArray);
+
+    bool isBuilt() const { return VAO != 0; }
+
+    void cleanup();
+
+private:
+    // Faixa de um grupo dentro do index buffer compartilhado
+    struct MeshRange {
+        unsigned int firstIndex;
+        unsigned int indexCount;
+        int baseVertex;
+    };
+
+    // Dados por comando, lidos no shader (layout std430: mat4 + vec4 + ivec4 = 96 bytes)
+    struct ObjectData {
+        glm::mat4  model;
+        glm::vec4  color;
+        glm::ivec4 material;    // x = tem textura (1/0), y = camada no texture array (-1 = GL_TEXTURE_2D)
+    };
+
+    // Comandos consecutivos que usam a mesma textura: um glMultiDrawElementsIndirect por faixa
+    struct TextureRange {
+        unsigned int textureID;
+        bool isArray;           // textureID é um GL_TEXTURE_2D_ARRAY (unidade 1)
+        unsigned int first;
+        unsigned int count;
+    };
+
+    unsigned int VAO, VBO, EBO;
+    unsigned int commandBuffer;     // GL_DRAW_INDIRECT_BUFFER
+    unsigned int objectBuffer;      // GL_SHADER_STORAGE_BUFFER (binding = 0)
+
+    unordered_map<string, vector<MeshRange>> meshRanges;   // faixas de cada malha, pelo caminho do .obj
+
+    vector<uint8_t> visibility;     // máscara de visibilidade do frame em que os comandos foram gerados
+    vector<uint8_t> currentVisibility;
+    vector<DrawElementsIndirectCommand> commands;
+    vector<ObjectData> objectData;
+    vector<TextureRange> textureRanges;
+    bool dirty;
+    bool commandsUseTextureArray;   // modo de textura com que os comandos foram gerados
+
+    void rebuildCommands(const vector<unique_ptr<OBJ3D>>& objects);
+
+    // Textura (2D ou array) e camada usadas por um objeto no modo atual
+    unsigned int textureOf(const OBJ3D& object, int& layer) const;
+};
+
+#endif
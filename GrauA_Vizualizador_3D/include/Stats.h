@@ -0,0 +1,50 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstddef>
+
+using namespace std;
+
+// Contadores do frame e dos recursos, consultados pelo overlay de desempenho e pelos relatórios
+enum StatId {
+    STAT_FRAME_MS,          // duração do último frame
+    STAT_CPU_MS,            // parte de CPU do último frame (até a submissão dos comandos)
+    STAT_GPU_MS,            // soma dos passes de GPU do último frame medido (ver GpuTimer)
+    STAT_DRAW_CALLS,        // draw calls do último frame (fila + multi-draw indirect)
+    STAT_TRIANGLES,
+    STAT_STATE_CHANGES,     // binds de programa, textura e VAO + uniforms (ver RenderStats)
+    STAT_VISIBLE_OBJECTS,
+    STAT_CULLED_OBJECTS,    // descartados pelo frustum culling
+    STAT_PROJECTILES,       // projéteis ativos
+    STAT_COLLISION_TESTS,   // testes raio x bounding box do último frame
+    STAT_CPU_MEMORY,        // bytes residentes do processo
+    STAT_GPU_MEMORY,        // bytes de buffers e texturas enviados à OpenGL (estimativa)
+    STAT_ASSETS_LOADED,     // malhas e texturas já carregadas pelo AssetLoader
+    STAT_ASSETS_PENDING,    // malhas e texturas ainda em leitura, decodificação ou envio (0 = cena completa)
+    STAT_UPLOAD_BYTES,      // bytes enviados pela UploadQueue no último frame
+    STAT_TEXTURE_RESIDENT,  // bytes dos níveis residentes das texturas em streaming (ver TextureStreamer)
+    STAT_TEXTURE_BUDGET,    // orçamento de memória dessas texturas (0 = streaming desligado)
+    STAT_TEXTURE_PENDING,   // texturas esperando níveis mais finos (em leitura, envio ou sem espaço no orçamento)
+    STAT_TEXTURE_EVICTIONS, // níveis descartados no último frame
+
+    STAT_COUNT
+};
+
+// Registro central de estatísticas: cada subsistema (renderização, colisões, carregamento)
+// escreve seus contadores diretamente no vetor, sem alocação nem busca por nome.
+// Acesso apenas pela thread principal.
+class Stats {
+public:
+    static double values[STAT_COUNT];
+
+    static inline void set(StatId id, double value) { values[id] = value; }
+    static inline void add(StatId id, double value) { values[id] += value; }
+    static inline double get(StatId id) { return values[id]; }
+
+    static const char* name(StatId id);
+
+    // Memória residente do processo (0 se a plataforma não informar)
+    static size_t processMemory();
+};
+
+#endif
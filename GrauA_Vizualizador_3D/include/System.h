@@ -4,6 +4,8 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <map>
+#include <chrono>
 #include <glad/glad.h>  // biblioteca de funções baseada nas definições/especificações OPENGL
                         // Incluir antes de outros que requerem OpenGL (como GLFW)
 #include <GLFW/glfw3.h> // biblioteca de funções para criação da janela no Windows
@@ -13,8 +15,22 @@
 
 #include "Camera.h"
 #include "Shader.h"
+#include "ShaderPermutations.h"
 #include "OBJ3D.h"
 #include "Projetil.h"
+#include "RenderQueue.h"
+#include "StaticBatch.h"
+#include "InstanceRenderer.h"
+#include "TextureArray.h"
+#include "HeadlessContext.h"
+#include "InputRecording.h"
+#include "FrameTimings.h"
+#include "PerfOverlay.h"
+#include "SceneGenerator.h"
+#include "AssetLoader.h"
+#include "UploadQueue.h"
+#include "TextureStreamer.h"
+#include "SimulationThread.h"
 
 using namespace std;	// Para não precisar digitar std:: na frente de comandos da biblioteca
 using namespace glm;	// Para não precisar digitar glm:: na frente de comandos da biblioteca
@@ -32,6 +48,46 @@ struct ObjectInfo {
     string texturePath; // Caminho para a textura do objeto
 };
 
+// Opções de execução lidas da linha de comando (modo headless, gravação/reprodução) - ver System::parseArguments
+struct RunOptions {
+    bool headless = false;      // --headless
+    int width  = 1024;          // --size LARGURAxALTURA (tamanho do FBO)
+    int height = 768;
+    int frames = 0;             // --frames N (0 = duração da gravação ou do caminho de câmera, ou 300)
+    string cameraPath;          // --camera-path arquivo (ver CameraPath)
+    string timingsPath = "frame_timings.csv";  // --timings arquivo.csv
+    string dumpPath;            // --dump arquivo.ppm (frame final)
+    bool multiDraw = false;     // --multidraw        (equivale à tecla M)
+    bool instancing = true;     // --no-instancing    (tecla I)
+    bool textureArrays = true;  // --no-texture-arrays (tecla T)
+    string recordPath;          // --record arquivo: grava a entrada de cada frame (ver InputRecording)
+    string replayPath;          // --replay arquivo: reproduz uma gravação no lugar do teclado/mouse
+    float fixedDeltaTime = 1.0f / 60.0f;    // --fixed-dt segundos (deltaTime durante a reprodução)
+    string tracePath = "cpu_trace.json";    // --trace arquivo: trace do profiler (build com -DENABLE_PROFILER)
+    bool overlay = false;       // --overlay (tecla F3): overlay de desempenho no frame salvo
+    string scenePath = "Configurador_Cena.txt"; // --scene arquivo: configuração da cena
+    string scalingPath;         // --scaling-csv arquivo: acrescenta uma linha de resumo (carga x tempos) por execução
+    SceneGeneratorOptions generator;    // --generate-scene diretório [...]: só gera a cena e sai
+    bool syncLoading = false;   // --sync-loading: carrega malhas e texturas antes do primeiro frame (caminho antigo)
+    unsigned int loaderThreads = 0;     // --loader-threads N: threads do JobSystem além da principal (0 = núcleos - 1)
+    ReadBackend readBackend = READ_BACKEND_URING;   // --io uring|pread|stream: leitura dos arquivos na carga assíncrona
+    size_t uploadBudgetKB = 4096;       // --upload-budget KB: dados enviados à OpenGL por frame durante o carregamento
+    float uploadMs = 2.0f;              // --upload-ms ms: tempo máximo por frame gasto nesses envios
+    MipFilter mipFilter = MIP_FILTER_GPU;   // --mips gpu|box|kaiser: onde/como os mipmaps são gerados
+    bool cookedTextures = true;         // --no-cooked-textures: ignora o cache de texturas cozidas
+    CookOptions cook;                   // --cook-textures [...]: só cozinha as texturas da cena e sai
+    size_t textureBudgetMB = 0;         // --texture-budget MB: streaming das texturas com esse orçamento (0 = desligado)
+    int textureTail = 64;               // --texture-tail N: lado máximo dos níveis carregados antes de qualquer pedido
+    string packPath;                    // --pack arquivo: lê cena, modelos e texturas de um pacote (ver AssetPack)
+    string packOutput;                  // --pack-assets arquivo [--pack-compress]: só empacota a cena e sai
+    bool packCompress = false;
+    bool simThread = false;             // --sim-thread: simulação em thread própria, com passo fixo (ver SimulationThread)
+    bool fixedStep = false;             // --fixed-step: simulação com passo fixo na thread principal (acumulador)
+    float tickRate = 60.0f;             // --tick-rate Hz: passos por segundo dessas simulações (na reprodução, 1 / --fixed-dt)
+    int maxSteps = 5;                   // --max-steps N: passos por frame no --fixed-step; o atraso além disso é descartado
+    uint32_t logRate = 100;             // --log-rate N: mensagens por segundo de cada ponto de log (0 = sem limite, ver Log)
+};
+
 class System {
 public:
     GLFWwindow* window; // Janela principal do sistema OpenGL
@@ -41,36 +97,162 @@ public:
     static const unsigned int SCREEN_WIDTH = 1024;
     static const unsigned int SCREEN_HEIGHT = 768;
 
+    // Tamanho atual do framebuffer (janela ou FBO do modo headless)
+    int framebufferWidth;
+    int framebufferHeight;
+
     // Temporização
     float deltaTime;
-    float lastFrame;    
+    double lastFrame;   // glfwGetTime do frame anterior (em float, perderia os milissegundos depois de algumas horas)
 
     System();   // Construtor padrão
 
     ~System();  // Destrutor padrão
     
     bool initializeGLFW();
+    bool initializeHeadless(int width, int height);    // contexto EGL + FBO, sem janela
     bool initializeOpenGL();
     bool loadShaders();
     bool loadSceneObjects();
+    bool cookTextures(const RunOptions& options);  // TextureCooker nas texturas da cena, sem contexto OpenGL
+    bool packAssets(const RunOptions& options);    // AssetPack com a configuração, modelos e texturas da cena
     void processInput();
     void render();
     void shutdown();
+
+    // Lê as opções de execução; retorna false se algum argumento for inválido
+    static bool parseArguments(int argc, char** argv, RunOptions& options);
+
+    // Prepara a gravação ou a reprodução da entrada pedida nas opções
+    bool setupInput(const RunOptions& options);
+
+    // Laço principal sem janela: N frames (caminho de câmera ou gravação), tempos por frame e dump opcional
+    void runHeadless(const RunOptions& options);
+
+    // Grava a entrada capturada (--record) e o relatório de tempos da reprodução (--replay)
+    void finishRun(const RunOptions& options);
+
+    bool hasContext() const { return window != nullptr || headless.isCreated(); }
     
+    HeadlessContext headless;   // contexto sem janela (modo headless)
+
     Camera camera;      // câmera do sistema
-    Shader mainShader;  // shader unificado para objetos da cena e projéteis
+    ShaderPermutations shaders; // variantes do shader da cena e dos projéteis (uma por combinação de funcionalidades)
+    RenderQueue renderQueue;    // fila de pacotes de desenho, ordenada por chave a cada frame
+    GpuTimer gpuTimer;          // tempo de GPU de cada pass (clear, cena, projéteis), lido com 2-3 frames de atraso
+
+    Shader multiDrawShader;     // shader do caminho multi-draw indirect (dados por objeto em SSBO)
+    StaticBatch staticBatch;    // geometria estática em buffers compartilhados (multi-draw indirect)
+    bool useMultiDraw;          // true = objetos da cena desenhados pelo staticBatch (tecla M)
+
+    InstanceRenderer instanceRenderer;  // grupos de objetos com a mesma malha e textura
+    bool useInstancing;                 // true = grupos de instâncias desenhados com glDrawElementsInstanced (tecla I)
+
+    TextureArray textureArrays;         // texturas da cena empacotadas em GL_TEXTURE_2D_ARRAYs
+    bool useTextureArrays;              // true = texturas lidas das camadas dos arrays (tecla T)
+
+    // Malhas e texturas já carregadas, pelo caminho do arquivo: objetos repetidos compartilham os recursos
+    map<string, shared_ptr<Mesh>> meshCache;
+    map<string, unsigned int> textureCache;
     
     std::vector<std::unique_ptr<OBJ3D>> sceneObjects;
     std::vector<std::unique_ptr<Projetil>> projeteis;
+
+    string sceneFile;       // arquivo de configuração lido por loadSceneObjects (--scene)
+    double sceneLoadMs;     // do início de loadSceneObjects até a cena completa (malhas, texturas, arrays e lotes)
+    double firstFrameMs;    // do início de loadSceneObjects até o fim do primeiro frame (< 0 = ainda não desenhado)
+
+    // Carregamento assíncrono (ver AssetLoader): loadSceneObjects cria os objetos com limites provisórios
+    // e enfileira malhas e texturas; updateLoading, a cada frame, envia à OpenGL (em partes, ver
+    // UploadQueue) o que ficou pronto
+    AssetLoader assetLoader;
+    UploadQueue uploads;
+    bool asyncLoading;      // false = --sync-loading
+    MipFilter mipFilter;    // MIP_FILTER_GPU = glGenerateMipmap; os demais geram a cadeia nas threads (--mips)
+    bool sceneLoading;      // true enquanto houver malhas ou texturas pendentes
+    size_t assetsReady;     // malhas e texturas já enviadas (ou que falharam)
+    bool texturesArrived;   // alguma textura foi completada desde a última atribuição aos objetos
+    chrono::steady_clock::time_point loadStart;
+
+    void updateLoading();   // thread principal, antes de desenhar o frame
+    void finishLoading();   // espera a cena ficar completa (reprodução e medições sem carregamento em curso)
+    void finalizeScene();   // texture arrays, instanciamento e lotes do multi-draw, com todos os recursos carregados
+
+    // Streaming de texturas (--texture-budget, ver TextureStreamer): as texturas da cena começam só com a
+    // cauda dos mipmaps e recebem os níveis mais finos conforme o tamanho dos objetos na tela
+    TextureStreamer textureStreamer;
+    void updateStreaming(); // thread principal, a cada frame, depois da entrada (posição da câmera do frame)
     
     // Entrada
     bool keys[1024];
     bool firstMouse;
     float lastX, lastY;
+    float mouseDeltaX, mouseDeltaY;     // movimento do mouse acumulado pelos callbacks desde o último frame
+    float scrollDelta;
+
+    // Gravação e reprodução da entrada (ver InputRecording)
+    InputRecording inputRecording;
+    bool recordingInput;        // true = cada frame de entrada real é acrescentado à gravação
+    bool replayingInput;        // true = a entrada vem da gravação, com deltaTime fixo
+    size_t replayPosition;      // próximo frame da gravação
+    float fixedDeltaTime;
+
+    // Tempos e carga de cada frame (modo headless e reprodução); os contadores do frame ficam em Stats
+    FrameTimings timings;
+    PerfOverlay overlay;        // FPS, gráfico de tempos e contadores sobre a cena (tecla F3)
+
+    // Publica os tempos do frame em Stats e no gráfico do overlay (e no relatório, se estiver gravando)
+    void recordFrame(float cpuMs, float frameMs, bool keepTiming);
+
+    FrameInput readInput();                 // estado atual do teclado e do mouse (GLFW)
+    void applyInput(const FrameInput& input);
+    bool replayFinished() const {
+        return replayingInput && (simulation.isStarted() ? simulation.isFinished()
+                                                         : replayPosition >= inputRecording.size());
+    }
 
-    void disparo();
+    // Partes de applyInput: câmera e disparos (simulação) e teclas M/I/T/F3 (renderização)
+    void applySimulationInput(const FrameInput& input, Camera& target, vector<unique_ptr<Projetil>>& shots,
+                              float dt, bool createMesh);
+    void applyRenderToggles(const FrameInput& input);
+
+    void disparo(const Camera& origem, vector<unique_ptr<Projetil>>& destino, bool createMesh);
     void updateProjeteis();
     void checkCollisions();
+
+    // Simulação em thread própria (--sim-thread, ver SimulationThread): a thread da simulação é dona de
+    // simCamera, simProjeteis e simObjects; a thread principal só lê os snapshots publicados, com
+    // "camera" interpolada entre os passos e os objetos eliminados retirados de sceneObjects
+    SimulationThread simulation;
+    Camera simCamera;
+    vector<unique_ptr<Projetil>> simProjeteis;  // sem VAO: desenhados com a malha de projetilModel
+    vector<OBJ3D*> simObjects;                  // objetos vivos, na ordem de sceneObjects
+    uint64_t simSceneVersion;                   // incrementada a cada eliminação na simulação
+    uint64_t appliedSceneVersion;               // versão já aplicada em sceneObjects
+    vector<vec3> projectilePositions;           // posições interpoladas dos projéteis do frame
+    unique_ptr<Projetil> projetilModel;
+
+    void startSimulation(float tickTime);   // depois do carregamento completo (objetos e malhas imutáveis)
+    bool simulate(const FrameInput& input, float dt, SimulationSnapshot& snapshot);  // thread da simulação
+    void applySnapshot(const SimulationSnapshot& snapshot, float alpha);
+
+    // Passo fixo na thread principal (--fixed-step): o mesmo passo da thread de simulação, executado
+    // quantas vezes couberem no tempo acumulado dos frames; o frame desenha o estado interpolado
+    bool fixedStep;
+    float tickTime;             // duração de um passo (s)
+    int maxSteps;               // passos por frame antes de descartar o atraso (espiral da morte)
+    double stepAccumulator;     // tempo dos frames ainda não simulado
+    InputAccumulator stepInput;
+    SimulationSnapshot stepSnapshot;
+    size_t stepCount, steppedFrames, clampedFrames;
+
+    void startFixedStep(float tickTime, int maxSteps);
+    bool isSimulated() const { return fixedStep || simulation.isStarted(); }
+
+    // Thread principal, a cada frame: entrada do frame -> simulação (thread ou passos fixos), estado
+    // interpolado -> câmera e projéteis desenhados
+    void syncSimulation(double frameTime);
+    void prepareSimulation();
     
     // Callbacks
     static void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -3,15 +3,34 @@
 
 #include <string>
 #include <glad/glad.h>
+#include "TextureCooker.h"
 
 using namespace std;
 
+class TextureArray;
+
 class Texture {
 public:
     // Carrega uma textura a partir de um arquivo e retorna o ID da textura OpenGL
-    static unsigned int loadTexture(const string& path);
+    // (a versão cozida, comprimida e com mipmaps, se houver uma atualizada - ver TextureCooker).
+    // Com arrayLayers, a camada do texture array sai da mesma imagem, sem decodificá-la de novo
+    static unsigned int loadTexture(const string& path, TextureArray* arrayLayers = nullptr);
     // Cria uma textura a partir de dados em memória (array de bytes)
     static unsigned int createTexture(int width, int height, unsigned char* data, int channels);
+    // Cria a textura com o nível 0 alocado e vazio, para ser preenchida em partes (ver UploadQueue);
+    // os mipmaps são gerados depois do envio do último trecho ou, com mipLevels, também alocados
+    // aqui para receber os níveis gerados na CPU (ver MipChain)
+    static unsigned int allocateTexture(int width, int height, int channels, bool mipLevels = false);
+    // Cria a textura com todos os níveis (levels) alocados em um formato comprimido, para receber
+    // os blocos de uma textura cozida em partes (ver UploadQueue::uploadCompressed)
+    static unsigned int allocateCompressed(int width, int height, BlockFormat format, int levels);
+    // Cria a textura a partir de uma textura cozida, enviando todos os níveis de uma vez
+    static unsigned int createCompressedTexture(const CookedTexture& texture);
+    // Formato OpenGL dos pixels de uma imagem com 1, 3 ou 4 canais
+    static GLenum formatFor(int channels);
+    // Formato OpenGL de um formato de compressão e se o contexto atual o suporta
+    static GLenum compressedFormatFor(BlockFormat format);
+    static bool supportsFormat(BlockFormat format);
     // Deleta a textura OpenGL
     static void deleteTexture(unsigned int textureID);
 };
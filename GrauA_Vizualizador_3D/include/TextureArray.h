@@ -0,0 +1,97 @@
+#ifndef TEXTUREARRAY_H
+#define TEXTUREARRAY_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <glad/glad.h>
+#include "MipChain.h"
+#include "BlockCompression.h"
+
+using namespace std;
+
+// Posição de uma textura dentro de um texture array
+struct TextureLayer {
+    unsigned int arrayID;   // GL_TEXTURE_2D_ARRAY (0 = textura não empacotada)
+    int layer;              // camada dentro do array (-1 = nenhuma)
+
+    TextureLayer() : arrayID(0), layer(-1) {}
+};
+
+// Empacota as texturas da cena em GL_TEXTURE_2D_ARRAYs, uma camada por textura.
+// As camadas de um array precisam ter o mesmo tamanho, então cada imagem é redimensionada
+// para um "bucket" quadrado (potência de 2, limitada a MAX_LAYER_SIZE). Com o limite padrão
+// todas as texturas da cena caem no mesmo bucket e um único bind serve o pass inteiro.
+// Camadas cozidas (TextureCooker) ficam em buckets próprios, um por formato de compressão.
+class TextureArray {
+public:
+    static const int MIN_LAYER_SIZE = 64;
+    static const int MAX_LAYER_SIZE = 1024;
+
+    TextureArray();
+    ~TextureArray();
+
+    // Decodifica a imagem (ou lê a camada cozida, se houver) e reserva uma camada no bucket correspondente
+    // ao seu tamanho. A mesma textura adicionada duas vezes ocupa uma única camada. Retorna false se a
+    // imagem não abrir.
+    bool addTexture(const string& path);
+
+    // Mesmo que addTexture, em duas etapas, para imagens decodificadas fora da thread principal:
+    // prepareLayer converte a imagem (1 a 4 canais) para RGBA8 no tamanho do bucket e retorna esse
+    // tamanho (não acessa o objeto, pode rodar em qualquer thread); addLayer reserva a camada,
+    // opcionalmente com os mipmaps já gerados na CPU (MipChain::build sobre a camada preparada).
+    static int prepareLayer(const unsigned char* data, int width, int height, int channels,
+                            vector<unsigned char>& pixels);
+    void addLayer(const string& path, int size, vector<unsigned char>&& pixels,
+                  vector<MipLevel>&& mips = vector<MipLevel>());
+
+    // Reserva uma camada já comprimida (níveis 0..n de CookedTexture::layerLevels)
+    void addCompressedLayer(const string& path, BlockFormat format, vector<MipLevel>&& levels);
+
+    // Cria os arrays na OpenGL (um por bucket), envia as camadas e gera os mipmaps
+    // (ou envia os da CPU, se todas as camadas do bucket os tiverem).
+    // Os pixels decodificados são descartados depois do envio.
+    bool build();
+
+    // Array e camada de uma textura adicionada (arrayID = 0 se não foi empacotada)
+    TextureLayer find(const string& path) const;
+
+    size_t arrayCount() const { return arrays.size(); }
+    size_t layerCount() const { return layers.size(); }
+
+    bool isBuilt() const { return !arrays.empty(); }
+
+    void cleanup();
+
+private:
+    // Tamanho das camadas e formato: -1 = RGBA8, senão o BlockFormat das camadas cozidas
+    typedef pair<int, int> BucketKey;
+
+    struct Bucket {
+        int size;                               // largura = altura das camadas
+        int format;                             // como na BucketKey
+        vector<vector<unsigned char>> pixels;   // RGBA8 (ou blocos) do nível 0 de cada camada (até o build)
+        vector<vector<MipLevel>> mips;          // níveis 1..n de cada camada (vazio = glGenerateMipmap)
+        unsigned int arrayID;
+    };
+
+    map<BucketKey, Bucket> buckets;
+    map<string, pair<BucketKey, int>> layers;   // caminho -> (bucket, camada)
+
+    Bucket& bucketFor(int size, int format);
+
+    // Preenche o array (já vinculado) de um bucket RGBA8 / de camadas cozidas (todos os níveis
+    // enviados, sem glGenerateMipmap)
+    void buildUncompressed(Bucket& bucket);
+    void buildCompressed(Bucket& bucket);
+    vector<unsigned int> arrays;
+
+    // Tamanho de bucket para uma imagem width x height
+    static int bucketSize(int width, int height);
+
+    // Redimensiona uma imagem RGBA8 para size x size (média das amostras de origem cobertas por cada pixel)
+    static void resample(const unsigned char* source, int width, int height,
+                         vector<unsigned char>& destination, int size);
+};
+
+#endif
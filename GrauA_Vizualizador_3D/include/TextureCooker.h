@@ -0,0 +1,79 @@
+#ifndef TEXTURECOOKER_H
+#define TEXTURECOOKER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "BlockCompression.h"
+#include "MipChain.h"
+
+using namespace std;
+
+// Opções do cozimento (--cook-textures), lidas por System::parseArguments
+struct CookOptions {
+    bool enabled = false;           // --cook-textures: cozinha as texturas da cena (--scene) e sai
+    bool autoFormat = true;         // --cook-format auto|bc1|bc3|bc7 (auto: bc1 sem alfa, bc3 com alfa)
+    BlockFormat format = BLOCK_BC1;
+    bool force = false;             // --cook-force: refaz também as texturas já atualizadas no cache
+};
+
+// Textura cozida: todos os níveis de mipmap já comprimidos (MipLevel::pixels guarda os blocos)
+struct CookedTexture {
+    BlockFormat format;
+    vector<MipLevel> levels;        // níveis 0..n no tamanho da imagem original
+    vector<MipLevel> layerLevels;   // níveis 0..n da camada do texture array (ver TextureArray::prepareLayer)
+};
+
+// Resultado do cozimento de uma textura
+struct CookReport {
+    string path;
+    bool cooked;            // false = falha ao ler a imagem ou ao gravar o arquivo
+    bool skipped;           // o cache já estava atualizado (nada foi refeito)
+    int width, height;
+    BlockFormat format;
+    size_t levelCount;
+    size_t rawBytes;        // o que seria enviado sem compressão (RGB/RGBA + mipmaps, textura e camada)
+    size_t cookedBytes;
+    size_t encodedBytes;    // bytes RGBA passados ao encoder
+    double psnr;            // nível 0 da textura contra a imagem original (dB)
+    double encodeMs;
+
+    CookReport() : cooked(false), skipped(false), width(0), height(0), format(BLOCK_BC1), levelCount(0),
+                   rawBytes(0), cookedBytes(0), encodedBytes(0), psnr(0.0), encodeMs(0.0) {}
+};
+
+// Cozimento offline das texturas: cada imagem (jpg/png) vira um arquivo "<directory>/<hash do caminho>.ctex"
+// com a cadeia de mipmaps (MipChain) comprimida em blocos BC1/BC3/BC7 (BlockCompression), para a textura
+// e para a sua camada do texture array. Em tempo de execução Texture, TextureArray e AssetLoader usam o
+// arquivo cozido quando ele existe, corresponde à imagem atual (tamanho e data de modificação gravados no
+// cabeçalho) e o formato é suportado pelo contexto; senão decodificam a imagem como antes.
+// Não acessa a OpenGL: load pode rodar nas threads de carregamento.
+class TextureCooker {
+public:
+    static string directory;    // pasta do cache (relativa ao diretório de execução)
+    static bool enabled;        // false = --no-cooked-textures: sempre decodifica as imagens
+
+    // Cozinha as texturas (em paralelo, nas threads do JobSystem) e imprime o relatório:
+    // tamanho, taxa de compressão, PSNR e vazão do encoder. Retorna false se alguma falhar.
+    static bool cookAll(const vector<string>& paths, const CookOptions& options, MipFilter filter);
+
+    // Cozinha uma textura e grava o arquivo no cache
+    static bool cook(const string& path, const CookOptions& options, MipFilter filter, CookReport& report);
+
+    // Lê a textura cozida de uma imagem; false se não houver arquivo ou se ele estiver desatualizado.
+    // Com firstLevel > 0 os níveis anteriores vêm só com as dimensões e a camada não é lida
+    // (leitura parcial do TextureStreamer)
+    static bool load(const string& path, CookedTexture& texture, int firstLevel = 0);
+
+    static string pathFor(const string& path);
+
+private:
+    static bool isCurrent(const string& path, bool checkFormat, BlockFormat format);
+    static bool write(const string& path, const CookedTexture& texture);
+
+    // Comprime o nível 0 e os mipmaps de uma imagem RGBA8
+    static void encodeChain(const unsigned char* rgba, int width, int height, BlockFormat format, MipFilter filter,
+                            vector<MipLevel>& levels, CookReport& report);
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef TEXTURESTREAMER_H
+#define TEXTURESTREAMER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <glad/glad.h>
+#include "JobSystem.h"
+#include "MPSCQueue.h"
+#include "MipChain.h"
+#include "BlockCompression.h"
+#include "UploadQueue.h"
+
+using namespace std;
+
+// Streaming de texturas com orçamento de memória de vídeo. Cada textura começa só com a cauda da
+// cadeia de mipmaps (níveis de lado <= tailSize); os níveis mais finos são pedidos conforme o uso na
+// tela (use: tamanho projetado dos objetos que a usam), lidos nas threads do JobSystem (do arquivo
+// cozido, só os níveis pedidos, ou decodificando a imagem - ver TextureCooker e MipChain) e enviados
+// em partes pela UploadQueue. Quando um pedido não cabe no orçamento, os níveis que nenhum objeto
+// usou neste frame são descartados, do usado há mais tempo para o mais recente (LRU); os níveis em
+// uso nunca são descartados para dar lugar a outros, então duas texturas não se alternam (sem thrashing):
+// a que não coube fica com a resolução que coube até sobrar espaço.
+//
+// Cada textura é um único objeto OpenGL com armazenamento mutável (glTexImage2D por nível), de modo
+// que o ID dado aos objetos, ao instanciamento e à fila de renderização não muda: GL_TEXTURE_BASE_LEVEL
+// marca o nível residente mais fino e um nível descartado é reespecificado com tamanho 0.
+//
+// Apenas a thread principal chama os métodos públicos.
+class TextureStreamer {
+public:
+    size_t budgetBytes;     // --texture-budget (MB); 0 = streaming desligado
+    int tailSize;           // --texture-tail: lado máximo dos níveis residentes desde o início
+    MipFilter mipFilter;    // filtro dos mipmaps das imagens sem versão cozida (gpu = box)
+    UploadQueue* uploads;   // envio dos níveis pedidos (a cauda é enviada direto)
+
+    TextureStreamer();
+    ~TextureStreamer();
+
+    bool isEnabled() const { return budgetBytes > 0; }
+
+    // Enfileira a leitura da cauda de uma textura (cada caminho uma vez); o ID chega por update
+    void add(const string& path);
+
+    // Registra, no frame atual, um objeto com a textura ocupando "pixels" pixels na tela
+    void use(unsigned int textureID, float pixels);
+
+    // Uma vez por frame: cria as texturas cujas caudas chegaram (devolvidas em "arrived"), envia os
+    // níveis lidos, descarta os níveis sem uso se faltar espaço e faz os novos pedidos
+    void update(vector<pair<string, unsigned int>>& arrived);
+
+    // Espera as leituras enfileiradas terminarem (os resultados chegam no próximo update)
+    void wait();
+
+    void stop();
+
+    size_t pendingTails() const { return tailsPending; }
+    size_t residentBytes() const { return resident; }
+
+    // Totais da execução: níveis lidos e descartados, bytes enviados e pico de memória
+    void printReport() const;
+
+private:
+    struct Entry {
+        string path;
+        GLuint texture;         // 0 = cauda ainda não chegou (ou falhou)
+        bool compressed;        // arquivo cozido (níveis em blocos) ou imagem decodificada
+        BlockFormat format;
+        int width, height, channels;
+        int levelCount;
+        int tailLevel;          // primeiro nível da cauda
+        int residentLevel;      // nível residente mais fino (GL_TEXTURE_BASE_LEVEL)
+        int wantedLevel;        // nível mais fino pedido pelos objetos no frame "usedFrame"
+        unsigned int usedFrame;
+        bool loading;           // leitura ou envio de níveis em andamento (não pode ser descartada)
+        vector<unsigned int> lastUsed;  // último frame em que cada nível foi usado (LRU)
+    };
+
+    // Níveis lidos por uma thread: a cauda (com as dimensões da textura) ou firstLevel..lastLevel
+    struct Result {
+        size_t index;
+        bool tail;
+        bool ok;
+        bool compressed;
+        BlockFormat format;
+        int width, height, channels;
+        int levelCount;
+        int firstLevel;
+        vector<MipLevel> levels;    // firstLevel, firstLevel + 1, ...
+
+        Result() : index(0), tail(false), ok(false), compressed(false), format(BLOCK_BC1), width(0), height(0),
+                   channels(0), levelCount(0), firstLevel(0) {}
+    };
+
+    vector<Entry> entries;
+    unordered_map<unsigned int, size_t> byTexture;  // ID OpenGL -> entrada
+    unordered_map<string, size_t> byPath;
+    JobCounter tasks;       // leituras enfileiradas no JobSystem (tarefas de fundo)
+    atomic<bool> cancelled; // stop: as leituras ainda não iniciadas retornam sem fazer nada
+    MPSCQueue<Result> results;
+
+    unsigned int frame;
+    size_t resident;        // bytes residentes + reservados pelos pedidos em andamento
+    size_t tailsPending;
+    size_t loadsInFlight;
+    size_t frameEvictions;  // níveis descartados no frame atual
+
+    // totais (printReport)
+    size_t loadedLevels, evictedLevels, deferredRequests;
+    size_t streamedBytes, peakResident;
+    bool budgetWarning;
+
+    // Threads de trabalho: lê os níveis a partir de firstLevel (tail: a partir do primeiro nível da cauda)
+    void load(Result& result, const string& path, int firstLevel, int lastLevel) const;
+
+    void createTexture(Entry& entry, Result& result);
+    void uploadLevels(size_t index, Result& result);
+    void request(size_t index);
+    bool evictUnused(size_t bytes, size_t keep);
+    void evict(Entry& entry);
+
+    size_t levelBytes(const Entry& entry, int level) const;
+    size_t rangeBytes(const Entry& entry, int first, int last) const;
+    int tailLevelFor(int width, int height, int levelCount) const;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+// Conjunto fixo de threads de trabalho consumindo uma fila de tarefas (FIFO).
+// As tarefas não podem chamar a OpenGL: o contexto pertence à thread principal.
+class ThreadPool {
+public:
+    ThreadPool();
+    ~ThreadPool();
+
+    // Cria as threads (0 = núcleos disponíveis - 1, no mínimo 1); "name" identifica as threads no trace
+    void start(unsigned int threadCount, const string& name);
+
+    // Enfileira uma tarefa; executa na hora, na própria thread, se o pool não foi iniciado
+    void submit(function<void()> task);
+
+    // Espera a fila esvaziar e todas as tarefas em andamento terminarem
+    void wait();
+
+    // Descarta as tarefas ainda não iniciadas, espera as em andamento e encerra as threads
+    void stop();
+
+    size_t threadCount() const { return workers.size(); }
+
+private:
+    vector<thread> workers;
+    deque<function<void()>> tasks;
+    mutex queueMutex;
+    condition_variable taskAvailable;   // nova tarefa ou pedido de parada
+    condition_variable allDone;         // fila vazia e nenhuma tarefa em andamento
+    size_t running;
+    bool stopping;
+
+    void workerLoop();
+};
+
+#endif
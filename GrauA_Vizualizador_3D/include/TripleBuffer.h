@@ -0,0 +1,49 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+using namespace std;
+
+// Buffer triplo sem trava entre um escritor e um leitor (ex.: simulação -> renderização).
+// O escritor preenche "write()" e chama publish; o leitor chama update e lê "read()". Os três slots
+// se revezam por trocas atômicas do índice do meio: nenhum lado espera o outro, o leitor sempre recebe
+// o estado publicado mais recente (os intermediários são descartados) e um slot publicado nunca é
+// alterado enquanto o leitor o usa. Os slots são reaproveitados: vetores dentro de T mantêm a capacidade.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle(1), front(0), back(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Escritor: slot a preencher (conteúdo de duas publicações atrás, ou o inicial)
+    T& write() { return slots[back]; }
+
+    // Escritor: entrega o slot preenchido e recebe outro para o próximo estado
+    void publish() {
+        back = middle.exchange(back | FRESH, memory_order_acq_rel) & INDEX;
+    }
+
+    // Leitor: passa a ler o estado mais recente, se houver um novo; false se nada mudou
+    bool update() {
+        if (!(middle.load(memory_order_relaxed) & FRESH)) return false;
+        front = middle.exchange(front, memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    // Leitor: estado atual (o inicial até a primeira publicação)
+    const T& read() const { return slots[front]; }
+
+private:
+    static const int INDEX = 3;     // bits do índice do slot
+    static const int FRESH = 4;     // o slot do meio foi publicado e ainda não lido
+
+    T slots[3];
+    atomic<int> middle;
+    int front;      // só o leitor usa
+    int back;       // só o escritor usa
+};
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef UPLOADQUEUE_H
+#define UPLOADQUEUE_H
+
+#include <deque>
+#include <memory>
+#include <functional>
+#include <glad/glad.h>
+
+using namespace std;
+
+// Envio de dados para a OpenGL dividido entre frames. Cada frame, update() copia o próximo trecho
+// dos envios pendentes (FIFO) até o limite de bytes e de tempo do frame, de modo que uma malha
+// de centenas de MB ou uma textura 4K não travam um frame inteiro em um glBufferData/glTexImage2D.
+//
+// Os trechos passam por um anel de staging mapeado persistentemente (glBufferStorage): o memcpy
+// é feito direto na memória mapeada e a cópia para o destino fica com a GPU (glCopyBufferSubData
+// para buffers; o anel vinculado como GL_PIXEL_UNPACK_BUFFER - PBO - para glTexSubImage2D).
+// A região do anel escrita em um frame é protegida por um glFenceSync e só é reaproveitada
+// quando a cerca sinaliza (consultada sem espera); com o anel cheio o envio para até o próximo frame.
+// Sem glBufferStorage (GL < 4.4), os trechos são enviados direto da memória com glBufferSubData e
+// glTexSubImage2D, com os mesmos limites.
+//
+// Apenas a thread principal (com o contexto) usa a fila.
+class UploadQueue {
+public:
+    size_t frameBytes;      // bytes enviados por frame (--upload-budget, em KB)
+    double frameMs;         // tempo máximo por frame gasto em update() (--upload-ms)
+
+    UploadQueue();
+    ~UploadQueue();
+
+    // Cria o anel de staging (ringBytes = 0: quatro vezes o limite de bytes por frame)
+    bool initialize(size_t ringBytes = 0);
+
+    // Copia "size" bytes para o buffer (já criado com esse tamanho). "owner" mantém os dados vivos
+    // até o último trecho; "done" roda na thread principal depois do último trecho.
+    void uploadBuffer(GLuint buffer, const void* data, size_t size, shared_ptr<void> owner,
+                      function<void()> done = nullptr);
+
+    // Preenche um nível (width x height) de uma textura alocada por Texture::allocateTexture,
+    // em faixas de linhas
+    void uploadTexture(GLuint texture, int level, int width, int height, int channels, const unsigned char* data,
+                       shared_ptr<void> owner, function<void()> done = nullptr);
+
+    // Preenche um nível de uma textura alocada por Texture::allocateCompressed com "size" bytes de
+    // blocos 4x4 (formato OpenGL comprimido), em faixas de linhas de blocos
+    void uploadCompressed(GLuint texture, int level, int width, int height, GLenum format, const unsigned char* data,
+                          size_t size, shared_ptr<void> owner, function<void()> done = nullptr);
+
+    // Envia trechos até o limite do frame e recicla as regiões do anel já consumidas pela GPU
+    void update();
+
+    bool isIdle() const { return jobs.empty(); }
+    size_t pendingBytes() const;
+    size_t lastFrameBytes() const { return frameUploaded; }
+
+    void cleanup();
+
+private:
+    struct Job {
+        bool texture;
+        GLuint target;          // buffer ou textura de destino
+        const unsigned char* data;
+        size_t size;
+        size_t offset;          // bytes já enviados
+        int level, width, height, channels;
+        GLenum compressedFormat;    // textura em blocos (0 = pixels sem compressão)
+        int rowHeight;          // texels de altura de cada linha de dados (1, ou 4 nos blocos)
+        size_t rowBytes;        // textura: bytes por linha de dados (sem alinhamento)
+        shared_ptr<void> owner;
+        function<void()> done;
+    };
+
+    // Região do anel escrita em um frame, liberada quando a cerca sinaliza
+    struct Region {
+        GLsync fence;
+        size_t bytes;
+    };
+
+    deque<Job> jobs;
+    deque<Region> regions;
+
+    GLuint ring;
+    unsigned char* mapped;  // nullptr = sem anel (envio direto)
+    size_t capacity;
+    size_t head;            // próxima posição livre
+    size_t used;            // bytes em uso pela GPU (regiões com cerca pendente + frame atual)
+    size_t frameRegion;     // bytes do anel usados no frame atual
+    size_t frameUploaded;
+    double bytesPerMs;      // vazão medida dos envios (média móvel), limita o trecho ao tempo restante
+
+    void retireRegions();
+    bool allocate(size_t size, size_t& offset);
+    size_t sendSlice(Job& job, size_t budget);
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef WORKSTEALINGDEQUE_H
+#define WORKSTEALINGDEQUE_H
+
+#include <atomic>
+#include <cstdint>
+
+using namespace std;
+
+// Deque de Chase-Lev com capacidade fixa (potência de 2), na formulação com atomics do C11 de
+// Lê, Pop, Cohen e Zappa Nardelli ("Correct and Efficient Work-Stealing for Weak Memory Models").
+// Só a thread dona chama push e pop, na base (LIFO: o trabalho mais recente, ainda no cache);
+// as outras threads chamam steal, no topo (FIFO: os pedaços maiores de um parallelFor). Dono e
+// ladrões só disputam (compare_exchange) o último item. Guarda ponteiros; nullptr = vazia/perdeu a disputa.
+template <typename T, size_t Capacity>
+class WorkStealingDeque {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity deve ser potencia de 2");
+
+public:
+    WorkStealingDeque() : top(0), bottom(0) {
+        for (auto& item : items) item.store(nullptr, memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Dono: false se a deque estiver cheia
+    bool push(T* item) {
+        int64_t b = bottom.load(memory_order_relaxed);
+        int64_t t = top.load(memory_order_acquire);
+        if (b - t >= (int64_t)Capacity) return false;
+
+        items[b & (Capacity - 1)].store(item, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        bottom.store(b + 1, memory_order_relaxed);
+        return true;
+    }
+
+    // Dono: item mais recente
+    T* pop() {
+        int64_t b = bottom.load(memory_order_relaxed) - 1;
+        bottom.store(b, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        int64_t t = top.load(memory_order_relaxed);
+
+        if (t > b) {    // vazia
+            bottom.store(b + 1, memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* item = items[b & (Capacity - 1)].load(memory_order_relaxed);
+        if (t == b) {   // último item: disputa com os ladrões
+            if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed)) item = nullptr;
+            bottom.store(b + 1, memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Qualquer thread: item mais antigo
+    T* steal() {
+        int64_t t = top.load(memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        int64_t b = bottom.load(memory_order_acquire);
+        if (t >= b) return nullptr;
+
+        T* item = items[t & (Capacity - 1)].load(memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed)) return nullptr;
+        return item;
+    }
+
+private:
+    alignas(64) atomic<int64_t> top;        // ladrões
+    alignas(64) atomic<int64_t> bottom;     // dono
+    alignas(64) atomic<T*> items[Capacity];
+};
+
+#endif
@@ -17,17 +17,89 @@
 // Internal
 #include <iostream>
 #include "System.h"
+#include "AssetPack.h"
+#include "Profiler.h"
+#include "JobSystem.h"
+#include "Log.h"
 
 using namespace std;
 
-int main() {
+namespace {
+    // Encerra as threads de trabalho e depois o log em qualquer retorno de main. Declarado antes do
+    // System, é destruído depois dele (que ainda espera jobs e registra mensagens); os destrutores
+    // estáticos de JobSystem.cpp e Log.cpp, de ordem indefinida entre si, ficam só como reserva
+    struct ServicesShutdown {
+        ~ServicesShutdown() {
+            JobSystem::stop();
+            Log::stop();
+        }
+    };
+}
+
+int main(int argc, char** argv) {
+    ServicesShutdown services;
+
     cout << "    Visualizador de Modelos 3D - CGR    " << endl;
     cout << endl;
 
+    // opções de execução: modo headless, gravação/reprodução da entrada (ver System::parseArguments)
+    RunOptions options;
+    if (!System::parseArguments(argc, argv, options)) {
+        return EXIT_FAILURE; }
+
+    // só gera uma cena de estresse (configuração + malhas + texturas) e sai, sem abrir janela
+    if (!options.generator.directory.empty()) {
+        return SceneGenerator::generate(options.generator) ? 0 : EXIT_FAILURE; }
+
+    // threads de trabalho compartilhadas pelo carregamento, culling e colisões (ver JobSystem.h);
+    // esta thread é a thread 0 e ajuda a executar os jobs enquanto espera por eles
+    Profiler::setThreadName("principal");   // antes das threads de trabalho se registrarem no trace
+    JobSystem::start(options.loaderThreads);
+
+    // mensagens dos caminhos quentes (colisões, objetos carregados) formatadas e escritas em uma thread
+    // de fundo (ver Log.h)
+    Log::rateLimit = options.logRate;
+    Log::start();
+
     System system;  // Instancia o sistema (janela, OpenGL, Shaders, cena, etc)
+    system.sceneFile = options.scenePath;
+    TextureCooker::enabled = options.cookedTextures;
+
+    // só empacota a cena (ver AssetPack) e sai, sem abrir janela
+    if (!options.packOutput.empty()) {
+        return system.packAssets(options) ? 0 : EXIT_FAILURE; }
+
+    // cena, modelos e texturas lidos do pacote mapeado em memória (o que não estiver nele vem do disco)
+    if (!options.packPath.empty()) {
+        if (!AssetPack::mount(options.packPath)) return EXIT_FAILURE;
+        cout << "Pacote montado: " << options.packPath << " (" << AssetPack::fileCount() << " arquivos, "
+             << AssetPack::mappedBytes() / (1024 * 1024) << " MB)" << endl;
+    }
 
+    // só cozinha as texturas da cena (ver TextureCooker) e sai, sem abrir janela
+    if (options.cook.enabled) {
+        return system.cookTextures(options) ? 0 : EXIT_FAILURE; }
+
+    system.asyncLoading = !options.syncLoading;
+    system.mipFilter = options.mipFilter;
+    if (system.asyncLoading) system.assetLoader.start(options.readBackend);  // leitura/decodificação
+    system.uploads.frameBytes = options.uploadBudgetKB * 1024;
+    system.uploads.frameMs = options.uploadMs;
+
+    // streaming de texturas com orçamento de memória (ver TextureStreamer.h)
+    system.textureStreamer.budgetBytes = options.textureBudgetMB * 1024 * 1024;
+    system.textureStreamer.tailSize = options.textureTail;
+    system.textureStreamer.mipFilter = options.mipFilter;
+    system.textureStreamer.uploads = &system.uploads;
+
+    if (options.headless) {
+        // contexto EGL sem janela, desenhando em um FBO (ver HeadlessContext.h)
+        if (!system.initializeHeadless(options.width, options.height)) {
+            cerr << "Falha ao criar contexto headless" << endl;
+            return EXIT_FAILURE; }
+    }
     // inicializa a GLFW (janela, contexto, callbacks, etc - na apresentação ver System.cpp)
-    if (!system.initializeGLFW()) {
+    else if (!system.initializeGLFW()) {
         cerr << "Falha ao inicializar GLFW" << endl;
         return EXIT_FAILURE; }
 
@@ -48,36 +120,89 @@ int main() {
         return EXIT_FAILURE;
     }
 
+    // Gravação ou reprodução da entrada (ver InputRecording.h)
+    if (!system.setupInput(options)) {
+        return EXIT_FAILURE;
+    }
+
+    // a reprodução precisa da cena completa desde o primeiro frame (mesmas colisões em todas as execuções)
+    if (system.replayingInput && !options.headless) system.finishLoading();
+
+    // simulação com passo fixo, em thread própria (ver SimulationThread.h) ou na thread principal com
+    // acumulador; na reprodução, o passo da gravação
+    float tickTime = system.replayingInput ? system.fixedDeltaTime : 1.0f / options.tickRate;
+    if (options.simThread) system.startSimulation(tickTime);
+    else if (options.fixedStep) system.startFixedStep(tickTime, options.maxSteps);
+    bool simulated = system.isSimulated();
+
     cout << "Sistema inicializado com sucesso" << endl;
 
+    if (options.headless) {
+        system.runHeadless(options);    // frames, tempos e dump (ver System.cpp)
+        system.finishRun(options);
+        system.shutdown();
+        return 0;
+    }
+
     cout << "Controles:" << endl;
     cout << "  WASD/Setas: Mover camera" << endl;
     cout << "  Mouse: Olhar ao redor" << endl;
     cout << "  Scroll: Zoom" << endl;
     cout << "  ESPAÇO: Atirar" << endl;
+    cout << "  M: Alternar renderizacao (fila / multi-draw indirect)" << endl;
+    cout << "  I: Ativar/desativar instanciamento" << endl;
+    cout << "  T: Alternar texturas (texture arrays / individuais)" << endl;
+    cout << "  F3: Mostrar/ocultar overlay de desempenho" << endl;
     cout << "  ESC: Sair" << endl;
 
-    // Main loop - game loop
-    while (!glfwWindowShouldClose(system.window)) {
+    // Main loop - game loop (na reprodução, termina junto com a gravação)
+    while (!glfwWindowShouldClose(system.window) && !system.replayFinished()) {
+        PROFILE_SCOPE("Frame");
         
-        float currentFrame = glfwGetTime(); // Tempo atual em segundos desde que a GLFW foi inicializada 
-        system.deltaTime = currentFrame - system.lastFrame; // Tempo entre frames para movimentação
+        double currentFrame = glfwGetTime(); // Tempo atual em segundos desde que a GLFW foi inicializada 
+        system.deltaTime = (float)(currentFrame - system.lastFrame); // Tempo entre frames para movimentação
         system.lastFrame = currentFrame;
 
-        system.processInput();  // Processa entrada do usuário
-                                // (teclado, mouse, etc - ver System.cpp)
+        // na reprodução o passo é fixo, para que a cena evolua igual em todas as execuções
+        if (system.replayingInput) system.deltaTime = system.fixedDeltaTime;
+        double frameStart = glfwGetTime();
 
-        system.updateProjeteis();   // Atualiza posição dos projéteis (ver System.cpp)
+        system.updateLoading(); // Envia à OpenGL as malhas e texturas que terminaram de carregar (ver System.cpp)
 
-        system.checkCollisions();   // Verifica colisões entre projéteis e objetos da cena (ver System.cpp)
+        if (simulated) {
+            // entrada para a simulação; câmera e projéteis interpolados do último passo (ver System.cpp)
+            system.syncSimulation(system.deltaTime);
+        } else {
+            system.processInput();  // Processa entrada do usuário
+                                    // (teclado, mouse, etc - ver System.cpp)
+        }
+
+        system.updateStreaming();   // Níveis de mipmap pedidos/descartados conforme a câmera (ver System.cpp)
+
+        if (!simulated) {
+            system.updateProjeteis();   // Atualiza posição dos projéteis (ver System.cpp)
+
+            system.checkCollisions();   // Verifica colisões entre projéteis e objetos da cena (ver System.cpp)
+        }
 
         system.render();        // Renderiza a cena (ver System.cpp)
 
-        glfwSwapBuffers(system.window); // Troca os buffers da janela (ver System.cpp)
+        double submitted = glfwGetTime();
+
+        {
+            PROFILE_SCOPE("glfwSwapBuffers");
+            glfwSwapBuffers(system.window); // Troca os buffers da janela (ver System.cpp)
+        }
+
+        // tempos do frame para o overlay; na reprodução também vão para o relatório
+        // (o swap inclui a espera pelo vsync, se estiver ativo)
+        system.recordFrame((float)((submitted - frameStart) * 1000.0), (float)((glfwGetTime() - frameStart) * 1000.0),
+                           system.replayingInput);
 
         glfwPollEvents();   // Processa eventos da janela (teclado, mouse, etc) (ver System.cpp)
     }
 
+    system.finishRun(options);  // grava a entrada capturada e o relatório da reprodução
     system.shutdown(); // Limpa e finaliza o sistema
 
     return 0;
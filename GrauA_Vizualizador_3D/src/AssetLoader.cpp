@@ -0,0 +1,172 @@
+#include "AssetLoader.h"
+#include "TextureArray.h"
+#include "Texture.h"
+#include "Profiler.h"
+#include "AssetPack.h"
+#include <fstream>
+#include <stb_image.h>
+
+AssetLoader::AssetLoader() : cancelled(false), requested(0), collected(0) {}
+
+AssetLoader::~AssetLoader() {
+    stop();
+    LoadedImage image;
+    while (readyImages.pop(image)) release(image);
+}
+
+
+void AssetLoader::start(ReadBackend readBackend) {
+    cancelled = false;
+    reader.start(readBackend);
+}
+
+
+// Com o FileReader ativo os arquivos são lidos em lote e só o parsing/decodificação vai para o JobSystem.
+// Ficam de fora o que vem do pacote montado (já mapeado) e as imagens com textura cozida (lida no lugar delas)
+bool AssetLoader::readsAhead(const string& path, bool image) const {
+    if (!reader.isStarted() || AssetPack::isMounted()) return false;
+    if (image && TextureCooker::enabled) {
+        ifstream cooked(TextureCooker::pathFor(path), ios::binary);
+        if (cooked) return false;
+    }
+    return true;
+}
+
+
+void AssetLoader::loadMesh(const string& path) {
+    requested++;
+
+    if (readsAhead(path, false)) {
+        reader.read(path, [this, path](vector<unsigned char>& contents, bool ok) {
+            auto data = make_shared<vector<unsigned char>>(move(contents));
+            JobSystem::submitBackground(tasks, [this, path, data, ok]() {
+                if (cancelled) return;
+                PROFILE_SCOPE("AssetLoader::loadMesh");
+                LoadedMesh result;
+                result.path = path;
+                result.mesh.reset(new Mesh());
+                if (!ok || !result.mesh->readObjectData(path, *data)) result.mesh.reset();
+
+                readyMeshes.push(move(result));
+            });
+        });
+        return;
+    }
+
+    JobSystem::submitBackground(tasks, [this, path]() {
+        if (cancelled) return;
+        PROFILE_SCOPE("AssetLoader::loadMesh");
+        LoadedMesh result;
+        result.path = path;
+        result.mesh.reset(new Mesh());
+        if (!result.mesh->readObjectData(path)) result.mesh.reset();
+
+        readyMeshes.push(move(result));
+    });
+}
+
+
+void AssetLoader::loadImage(const string& path, bool prepareArrayLayer, MipFilter mipFilter) {
+    requested++;
+
+    if (readsAhead(path, true)) {
+        reader.read(path, [this, path, prepareArrayLayer, mipFilter](vector<unsigned char>& contents, bool ok) {
+            auto data = make_shared<vector<unsigned char>>(move(contents));
+            JobSystem::submitBackground(tasks, [this, path, data, ok, prepareArrayLayer, mipFilter]() mutable {
+                if (cancelled) return;
+                PROFILE_SCOPE("AssetLoader::loadImage");
+                LoadedImage result;
+                result.path = path;
+                if (ok) {
+                    result.data = stbi_load_from_memory(data->data(), (int)data->size(), &result.width,
+                                                        &result.height, &result.channels, 0);
+                }
+                data.reset();   // o arquivo já foi decodificado
+                prepareImage(result, prepareArrayLayer, mipFilter);
+
+                readyImages.push(move(result));
+            });
+        });
+        return;
+    }
+
+    JobSystem::submitBackground(tasks, [this, path, prepareArrayLayer, mipFilter]() {
+        if (cancelled) return;
+        PROFILE_SCOPE("AssetLoader::loadImage");
+        LoadedImage result;
+        result.path = path;
+
+        if (TextureCooker::load(path, result.cooked) && Texture::supportsFormat(result.cooked.format)) {
+            result.compressed = true;
+            if (!prepareArrayLayer) result.cooked.layerLevels.clear();
+            readyImages.push(move(result));
+            return;
+        }
+
+        result.data = AssetPack::loadImage(path, &result.width, &result.height, &result.channels, 0);
+        prepareImage(result, prepareArrayLayer, mipFilter);
+
+        readyImages.push(move(result));
+    });
+}
+
+
+// Camada do texture array e cadeias de mipmaps de uma imagem decodificada
+void AssetLoader::prepareImage(LoadedImage& result, bool prepareArrayLayer, MipFilter mipFilter) {
+    if (result.data && prepareArrayLayer) {
+        result.layerSize = TextureArray::prepareLayer(result.data, result.width, result.height,
+                                                      result.channels, result.layerPixels);
+        MipChain::build(result.layerPixels.data(), result.layerSize, result.layerSize, 4, mipFilter,
+                        result.layerMips);
+    }
+    if (result.data) {
+        MipChain::build(result.data, result.width, result.height, result.channels, mipFilter, result.mips);
+    }
+}
+
+
+void AssetLoader::collect(vector<LoadedMesh>& meshes, vector<LoadedImage>& images) {
+    LoadedMesh mesh;
+    while (readyMeshes.pop(mesh)) {
+        meshes.push_back(move(mesh));
+        collected++;
+    }
+
+    LoadedImage image;
+    while (readyImages.pop(image)) {
+        images.push_back(move(image));
+        collected++;
+    }
+}
+
+
+void AssetLoader::wait() {
+    reader.wait();  // as leituras entregues já enfileiraram o seu parsing no JobSystem
+    JobSystem::wait(tasks);
+}
+
+
+// Descarta o que ainda não começou e espera as tarefas em andamento (elas usam "this")
+void AssetLoader::stop() {
+    cancelled = true;
+    reader.stop();
+    JobSystem::wait(tasks);
+}
+
+
+void AssetLoader::release(LoadedImage& image) {
+    if (image.data) stbi_image_free(image.data);
+    image.data = nullptr;
+    vector<unsigned char>().swap(image.layerPixels);
+    image.mips.clear();
+    image.layerMips.clear();
+    image.cooked.levels.clear();
+    image.cooked.layerLevels.clear();
+}
+
+
+shared_ptr<unsigned char> AssetLoader::takeData(LoadedImage& image) {
+    shared_ptr<unsigned char> data(image.data, [](unsigned char* pixels) { stbi_image_free(pixels); });
+    image.data = nullptr;
+    return data;
+}
@@ -0,0 +1,344 @@
+#include "AssetPack.h"
+#include "LZ4Block.h"
+#include "Profiler.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stb_image.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const uint32_t PACK_MAGIC     = 0x50524743;    // "CGRP"
+    const uint32_t PACK_VERSION   = 1;
+    const uint64_t PACK_ALIGNMENT = 64;            // início de cada conteúdo (linha de cache)
+    const uint32_t ENTRY_LZ4      = 1;             // conteúdo comprimido (LZ4Block)
+
+    struct PackHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+        uint64_t namesOffset;   // o índice vem logo depois do cabeçalho
+        uint64_t namesSize;
+    };
+
+    struct PackEntry {
+        uint64_t hash;          // FNV-1a do caminho normalizado
+        uint64_t offset;
+        uint64_t storedSize;    // bytes no pacote
+        uint64_t size;          // bytes do arquivo original
+        uint32_t nameOffset;    // caminho na tabela de nomes (para distinguir colisões do hash)
+        uint32_t nameLength;
+        uint32_t flags;
+        uint32_t reserved;
+    };
+
+    // Pacote montado
+    const unsigned char* mapped = nullptr;
+    size_t mappedSize = 0;
+    const PackEntry* entries = nullptr;
+    uint32_t entryCount = 0;
+    const char* names = nullptr;
+#ifdef _WIN32
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = NULL;
+#endif
+
+    uint64_t fnv1a(const string& text) {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t alignUp(uint64_t value) {
+        return (value + PACK_ALIGNMENT - 1) & ~(PACK_ALIGNMENT - 1);
+    }
+
+    double megabytes(uint64_t bytes) { return bytes / (1024.0 * 1024.0); }
+
+    bool mapFile(const string& path) {
+#ifdef _WIN32
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, NULL);
+        if (fileHandle == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(fileHandle, &size) || size.QuadPart == 0) return false;
+        mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mappingHandle == NULL) return false;
+
+        mapped = (const unsigned char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        mappedSize = (size_t)size.QuadPart;
+        return mapped != nullptr;
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat info;
+        void* address = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            address = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);  // o mapeamento continua válido sem o descritor
+        if (address == MAP_FAILED) return false;
+
+        mapped = (const unsigned char*)address;
+        mappedSize = (size_t)info.st_size;
+        return true;
+#endif
+    }
+
+    void unmapFile() {
+#ifdef _WIN32
+        if (mapped) UnmapViewOfFile(mapped);
+        if (mappingHandle != NULL) CloseHandle(mappingHandle);
+        if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+        mappingHandle = NULL;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        if (mapped) munmap((void*)mapped, mappedSize);
+#endif
+        mapped = nullptr;
+        mappedSize = 0;
+        entries = nullptr;
+        entryCount = 0;
+        names = nullptr;
+    }
+}
+
+
+string AssetPack::normalize(const string& path) {
+    string normalized = path;
+    replace(normalized.begin(), normalized.end(), '\\', '/');
+    while (normalized.compare(0, 2, "./") == 0) normalized.erase(0, 2);
+    return normalized;
+}
+
+
+bool AssetPack::mount(const string& path) {
+    unmount();
+
+    if (!mapFile(path)) {
+        cerr << "Falha ao abrir pacote: " << path << endl;
+        unmapFile();
+        return false;
+    }
+
+    // cabeçalho, índice e tabela de nomes precisam caber no arquivo; cada entrada também
+    PackHeader header;
+    bool valid = mappedSize >= sizeof(header);
+    if (valid) {
+        memcpy(&header, mapped, sizeof(header));
+        valid = header.magic == PACK_MAGIC && header.version == PACK_VERSION &&
+                sizeof(header) + (uint64_t)header.entryCount * sizeof(PackEntry) <= header.namesOffset &&
+                header.namesOffset <= mappedSize && header.namesSize <= mappedSize - header.namesOffset;
+    }
+    if (valid) {
+        entries = (const PackEntry*)(mapped + sizeof(header));
+        entryCount = header.entryCount;
+        names = (const char*)(mapped + header.namesOffset);
+        for (uint32_t i = 0; i < entryCount && valid; i++) {
+            const PackEntry& entry = entries[i];
+            // na forma "tamanho <= resto" a soma de dois campos de 64 bits de um pacote corrompido não estoura
+            valid = entry.offset <= mappedSize && entry.storedSize <= mappedSize - entry.offset &&
+                    (uint64_t)entry.nameOffset + entry.nameLength <= header.namesSize &&
+                    ((entry.flags & ENTRY_LZ4) || entry.storedSize == entry.size);
+        }
+    }
+
+    if (!valid) {
+        cerr << "Pacote invalido: " << path << endl;
+        unmapFile();
+        return false;
+    }
+    return true;
+}
+
+
+void AssetPack::unmount() {
+    unmapFile();
+}
+
+
+bool AssetPack::isMounted() {
+    return mapped != nullptr;
+}
+
+
+size_t AssetPack::fileCount() {
+    return entryCount;
+}
+
+
+size_t AssetPack::mappedBytes() {
+    return mappedSize;
+}
+
+
+bool AssetPack::find(const string& path, AssetView& view) {
+    if (!mapped) return false;
+
+    string name = normalize(path);
+    uint64_t hash = fnv1a(name);
+
+    const PackEntry* end = entries + entryCount;
+    const PackEntry* entry = lower_bound(entries, end, hash,
+                                         [](const PackEntry& e, uint64_t value) { return e.hash < value; });
+    for (; entry != end && entry->hash == hash; ++entry) {
+        if (entry->nameLength != name.size() || name.compare(0, name.size(), names + entry->nameOffset,
+                                                             entry->nameLength) != 0) {
+            continue;
+        }
+
+        const unsigned char* stored = mapped + entry->offset;
+        if (entry->flags & ENTRY_LZ4) {
+            PROFILE_SCOPE("AssetPack::decompress");
+            view.buffer.resize((size_t)entry->size);
+            if (!LZ4Block::decompress(stored, (size_t)entry->storedSize, view.buffer.data(), view.buffer.size())) {
+                cerr << "Entrada corrompida no pacote: " << name << endl;
+                return false;
+            }
+            view.data = view.buffer.data();
+        } else {
+            view.data = stored;
+        }
+        view.size = (size_t)entry->size;
+        return true;
+    }
+    return false;
+}
+
+
+unsigned char* AssetPack::loadImage(const string& path, int* width, int* height, int* channels, int desiredChannels) {
+    AssetView view;
+    if (find(path, view)) {
+        return stbi_load_from_memory(view.data, (int)view.size, width, height, channels, desiredChannels);
+    }
+    return stbi_load(path.c_str(), width, height, channels, desiredChannels);
+}
+
+
+bool AssetPack::build(const string& packPath, const vector<string>& files, bool compress) {
+    PROFILE_SCOPE("AssetPack::build");
+    auto start = chrono::steady_clock::now();
+
+    // nomes (sem repetição) e o tamanho do que vem antes dos conteúdos
+    vector<string> paths;
+    vector<PackEntry> table;
+    string nameTable;
+    for (const string& file : files) {
+        string name = normalize(file);
+        if (find_if(paths.begin(), paths.end(), [&](const string& p) { return normalize(p) == name; }) != paths.end()) {
+            continue;
+        }
+
+        PackEntry entry = {};
+        entry.hash = fnv1a(name);
+        entry.nameOffset = (uint32_t)nameTable.size();
+        entry.nameLength = (uint32_t)name.size();
+        nameTable += name;
+        paths.push_back(file);
+        table.push_back(entry);
+    }
+
+    PackHeader header = {};
+    header.magic = PACK_MAGIC;
+    header.version = PACK_VERSION;
+    header.entryCount = (uint32_t)table.size();
+    header.namesOffset = sizeof(header) + table.size() * sizeof(PackEntry);
+    header.namesSize = nameTable.size();
+
+    ofstream pack(packPath, ios::binary | ios::trunc);
+    if (!pack) {
+        cerr << "Falha ao criar pacote: " << packPath << endl;
+        return false;
+    }
+
+    // conteúdos, um arquivo por vez (só um na memória); cabeçalho e índice no final, no início do arquivo
+    uint64_t offset = alignUp(header.namesOffset + header.namesSize);
+    uint64_t written = header.namesOffset + header.namesSize;  // fim do que já foi gravado no arquivo
+    uint64_t rawBytes = 0;
+    size_t compressedCount = 0;
+    vector<unsigned char> compressed;
+
+    for (size_t i = 0; i < paths.size(); i++) {
+        ifstream file(paths[i], ios::binary | ios::ate);
+        if (!file) {
+            cerr << "Falha ao ler arquivo para o pacote: " << paths[i] << endl;
+            return false;
+        }
+        vector<unsigned char> data((size_t)file.tellg());
+        file.seekg(0);
+        file.read((char*)data.data(), data.size());
+
+        PackEntry& entry = table[i];
+        entry.offset = offset;
+        entry.size = data.size();
+
+        const vector<unsigned char>* stored = &data;
+        if (compress && !data.empty() &&
+            LZ4Block::compress(data.data(), data.size(), compressed) <= data.size() - data.size() / 8) {
+            stored = &compressed;
+            entry.flags |= ENTRY_LZ4;
+            compressedCount++;
+        }
+        entry.storedSize = stored->size();
+
+        pack.seekp((streamoff)offset);
+        pack.write((const char*)stored->data(), stored->size());
+        if (entry.storedSize > 0) written = offset + entry.storedSize;
+        offset = alignUp(offset + entry.storedSize);
+        rawBytes += entry.size;
+    }
+
+    // completa o arquivo até o último alinhamento: um arquivo vazio no final aponta para esse offset,
+    // que o mount exige dentro do arquivo
+    if (written < offset) {
+        pack.seekp((streamoff)offset - 1);
+        pack.put(0);
+    }
+
+    sort(table.begin(), table.end(), [](const PackEntry& a, const PackEntry& b) { return a.hash < b.hash; });
+    pack.seekp(0);
+    pack.write((const char*)&header, sizeof(header));
+    pack.write((const char*)table.data(), table.size() * sizeof(PackEntry));
+    pack.write(nameTable.data(), nameTable.size());
+
+    if (!pack) {
+        cerr << "Falha ao gravar pacote: " << packPath << endl;
+        return false;
+    }
+
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << fixed << setprecision(1) << "Pacote gravado: " << packPath << " - " << table.size() << " arquivos, "
+         << megabytes(rawBytes) << " MB -> " << megabytes(offset) << " MB (" << compressedCount
+         << " comprimidos em LZ4) em " << ms << " ms" << defaultfloat << setprecision(6) << endl;
+    return true;
+}
+
+
+AssetStream::AssetStream(const string& path) : istream(nullptr), open(false), packed(false) {
+    if (AssetPack::find(path, view)) {
+        memory.set(view.data, view.size);
+        rdbuf(&memory);
+        open = packed = true;
+    } else if (file.open(path, ios::in)) {
+        rdbuf(&file);
+        open = true;
+    } else {
+        setstate(ios::failbit);
+    }
+}
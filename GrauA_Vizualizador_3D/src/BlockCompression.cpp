@@ -0,0 +1,513 @@
+#include "BlockCompression.h"
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+namespace {
+    // Pesos de interpolação dos índices de 4 bits do BC7 (em 64 avos)
+    const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // Copia o bloco 4x4 (bx, by) da imagem; fora da imagem repete a última linha/coluna
+    void readBlock(const unsigned char* rgba, int width, int height, int bx, int by, unsigned char* block) {
+        for (int y = 0; y < 4; y++) {
+            int sy = std::min(by * 4 + y, height - 1);
+            for (int x = 0; x < 4; x++) {
+                int sx = std::min(bx * 4 + x, width - 1);
+                memcpy(block + (y * 4 + x) * 4, rgba + ((size_t)sy * width + sx) * 4, 4);
+            }
+        }
+    }
+
+    // Copia para a imagem a parte do bloco que está dentro dela
+    void writeBlock(unsigned char* rgba, int width, int height, int bx, int by, const unsigned char* block) {
+        for (int y = 0; y < 4 && by * 4 + y < height; y++) {
+            for (int x = 0; x < 4 && bx * 4 + x < width; x++) {
+                memcpy(rgba + ((size_t)(by * 4 + y) * width + bx * 4 + x) * 4, block + (y * 4 + x) * 4, 4);
+            }
+        }
+    }
+
+    // Média e eixo de maior variância dos 16 texels (nos "dims" primeiros canais), por iteração
+    // de potência sobre a matriz de covariância. Eixo nulo se o bloco tiver uma só cor.
+    void principalAxis(const unsigned char* block, int dims, float* mean, float* axis) {
+        float covariance[4][4] = {};
+        for (int c = 0; c < dims; c++) {
+            mean[c] = 0.0f;
+            for (int i = 0; i < 16; i++) mean[c] += block[i * 4 + c];
+            mean[c] /= 16.0f;
+        }
+        for (int i = 0; i < 16; i++) {
+            for (int a = 0; a < dims; a++) {
+                for (int b = a; b < dims; b++) {
+                    covariance[a][b] += (block[i * 4 + a] - mean[a]) * (block[i * 4 + b] - mean[b]);
+                }
+            }
+        }
+
+        for (int c = 0; c < dims; c++) axis[c] = 1.0f;
+        for (int iteration = 0; iteration < 8; iteration++) {
+            float next[4] = {};
+            for (int a = 0; a < dims; a++) {
+                for (int b = 0; b < dims; b++) {
+                    next[a] += (a <= b ? covariance[a][b] : covariance[b][a]) * axis[b];
+                }
+            }
+            float largest = 0.0f;
+            for (int c = 0; c < dims; c++) largest = std::max(largest, std::fabs(next[c]));
+            if (largest < 1e-6f) {
+                for (int c = 0; c < dims; c++) axis[c] = 0.0f;
+                return;
+            }
+            for (int c = 0; c < dims; c++) axis[c] = next[c] / largest;
+        }
+    }
+
+    // Extremos do segmento mean + t * axis que cobre as projeções dos texels
+    void axisEndpoints(const unsigned char* block, int dims, const float* mean, const float* axis,
+                       float* first, float* second) {
+        float minT = 0.0f, maxT = 0.0f;
+        float length = 0.0f;
+        for (int c = 0; c < dims; c++) length += axis[c] * axis[c];
+
+        if (length > 0.0f) {
+            minT = 1e30f;
+            maxT = -1e30f;
+            for (int i = 0; i < 16; i++) {
+                float t = 0.0f;
+                for (int c = 0; c < dims; c++) t += (block[i * 4 + c] - mean[c]) * axis[c];
+                t /= length;
+                minT = std::min(minT, t);
+                maxT = std::max(maxT, t);
+            }
+        }
+
+        for (int c = 0; c < dims; c++) {
+            first[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * maxT));
+            second[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * minT));
+        }
+    }
+
+    // Resolve os extremos a, b que minimizam sum |w_i * a + (1 - w_i) * b - p_i|^2 para pesos fixos
+    bool leastSquares(const unsigned char* block, int dims, const float* weights, float* first, float* second) {
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+        float ax[4] = {}, bx[4] = {};
+        for (int i = 0; i < 16; i++) {
+            float w = weights[i], v = 1.0f - w;
+            aa += w * w;
+            ab += w * v;
+            bb += v * v;
+            for (int c = 0; c < dims; c++) {
+                ax[c] += w * block[i * 4 + c];
+                bx[c] += v * block[i * 4 + c];
+            }
+        }
+
+        float determinant = aa * bb - ab * ab;
+        if (std::fabs(determinant) < 1e-6f) return false;   // todos os texels no mesmo índice
+
+        for (int c = 0; c < dims; c++) {
+            first[c] = std::min(255.0f, std::max(0.0f, (bb * ax[c] - ab * bx[c]) / determinant));
+            second[c] = std::min(255.0f, std::max(0.0f, (aa * bx[c] - ab * ax[c]) / determinant));
+        }
+        return true;
+    }
+
+    uint16_t pack565(const float* color) {
+        int r = (int)(color[0] * 31.0f / 255.0f + 0.5f);
+        int g = (int)(color[1] * 63.0f / 255.0f + 0.5f);
+        int b = (int)(color[2] * 31.0f / 255.0f + 0.5f);
+        return (uint16_t)((r << 11) | (g << 5) | b);
+    }
+
+    void unpack565(uint16_t packed, int* color) {
+        int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    // Paleta de 4 cores (modo de 4 cores: color0 > color1) ou 3 cores + preto
+    void colorPalette(uint16_t color0, uint16_t color1, bool threeColorMode, int palette[4][3]) {
+        unpack565(color0, palette[0]);
+        unpack565(color1, palette[1]);
+        for (int c = 0; c < 3; c++) {
+            if (threeColorMode) {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            } else {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+            }
+        }
+    }
+
+    // Escolhe o índice mais próximo de cada texel; retorna o erro quadrático total
+    int fitColorIndices(const unsigned char* block, uint16_t color0, uint16_t color1, unsigned char* indices) {
+        int palette[4][3];
+        colorPalette(color0, color1, false, palette);
+
+        int total = 0;
+        for (int i = 0; i < 16; i++) {
+            int best = 0, bestError = 1 << 30;
+            for (int p = 0; p < 4; p++) {
+                int dr = block[i * 4] - palette[p][0];
+                int dg = block[i * 4 + 1] - palette[p][1];
+                int db = block[i * 4 + 2] - palette[p][2];
+                int error = dr * dr + dg * dg + db * db;
+                if (error < bestError) {
+                    bestError = error;
+                    best = p;
+                }
+            }
+            indices[i] = (unsigned char)best;
+            total += bestError;
+        }
+        return total;
+    }
+
+    // Extremos de 8 bits do BC7 modo 6: 7 bits por canal + um p-bit por extremo (bit menos significativo),
+    // escolhido pelo menor erro
+    void quantizeBC7(const float* endpoint, int* value, int& pBit) {
+        float bestError = 1e30f;
+        for (int p = 0; p < 2; p++) {
+            int candidate[4];
+            float error = 0.0f;
+            for (int c = 0; c < 4; c++) {
+                int q = std::min(127, std::max(0, (int)std::floor((endpoint[c] - p) / 2.0f + 0.5f)));
+                candidate[c] = (q << 1) | p;
+                error += (candidate[c] - endpoint[c]) * (candidate[c] - endpoint[c]);
+            }
+            if (error < bestError) {
+                bestError = error;
+                pBit = p;
+                memcpy(value, candidate, sizeof(candidate));
+            }
+        }
+    }
+
+    int fitBC7Indices(const unsigned char* block, const int* first, const int* second, unsigned char* indices) {
+        int palette[16][4];
+        for (int i = 0; i < 16; i++) {
+            for (int c = 0; c < 4; c++) {
+                palette[i][c] = ((64 - BC7_WEIGHTS[i]) * first[c] + BC7_WEIGHTS[i] * second[c] + 32) >> 6;
+            }
+        }
+
+        int total = 0;
+        for (int i = 0; i < 16; i++) {
+            int best = 0, bestError = 1 << 30;
+            for (int p = 0; p < 16; p++) {
+                int error = 0;
+                for (int c = 0; c < 4; c++) {
+                    int d = block[i * 4 + c] - palette[p][c];
+                    error += d * d;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    best = p;
+                }
+            }
+            indices[i] = (unsigned char)best;
+            total += bestError;
+        }
+        return total;
+    }
+
+    // Escrita/leitura de campos de bits a partir do bit menos significativo do bloco de 128 bits
+    void putBits(unsigned char* block, int& position, unsigned int value, int count) {
+        for (int i = 0; i < count; i++, position++) {
+            if (value & (1u << i)) block[position >> 3] |= (unsigned char)(1u << (position & 7));
+        }
+    }
+
+    unsigned int getBits(const unsigned char* block, int& position, int count) {
+        unsigned int value = 0;
+        for (int i = 0; i < count; i++, position++) {
+            if (block[position >> 3] & (1u << (position & 7))) value |= 1u << i;
+        }
+        return value;
+    }
+}
+
+
+int BlockCompression::blockBytes(BlockFormat format) {
+    return format == BLOCK_BC1 ? 8 : 16;
+}
+
+
+size_t BlockCompression::imageSize(BlockFormat format, int width, int height) {
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * blockBytes(format);
+}
+
+
+void BlockCompression::encode(const unsigned char* rgba, int width, int height, BlockFormat format,
+                              vector<unsigned char>& blocks) {
+    int columns = (width + 3) / 4, rows = (height + 3) / 4;
+    int size = blockBytes(format);
+    blocks.assign(imageSize(format, width, height), 0);
+
+    unsigned char block[64];
+    for (int by = 0; by < rows; by++) {
+        for (int bx = 0; bx < columns; bx++) {
+            readBlock(rgba, width, height, bx, by, block);
+            unsigned char* output = &blocks[((size_t)by * columns + bx) * size];
+
+            if (format == BLOCK_BC1) {
+                encodeColor(block, output);
+            } else if (format == BLOCK_BC3) {
+                encodeAlpha(block, output);
+                encodeColor(block, output + 8);
+            } else {
+                encodeBC7(block, output);
+            }
+        }
+    }
+}
+
+
+void BlockCompression::decode(const unsigned char* blocks, int width, int height, BlockFormat format,
+                              vector<unsigned char>& rgba) {
+    int columns = (width + 3) / 4, rows = (height + 3) / 4;
+    int size = blockBytes(format);
+    rgba.assign((size_t)width * height * 4, 255);
+
+    unsigned char block[64];
+    for (int by = 0; by < rows; by++) {
+        for (int bx = 0; bx < columns; bx++) {
+            const unsigned char* input = blocks + ((size_t)by * columns + bx) * size;
+
+            if (format == BLOCK_BC1) {
+                decodeColor(input, block, true);
+            } else if (format == BLOCK_BC3) {
+                decodeColor(input + 8, block, false);   // no BC3 a cor é sempre de 4 cores
+                decodeAlpha(input, block);
+            } else {
+                decodeBC7(input, block);
+            }
+            writeBlock(rgba.data(), width, height, bx, by, block);
+        }
+    }
+}
+
+
+double BlockCompression::psnr(const unsigned char* a, const unsigned char* b, size_t pixelCount, int channels) {
+    double sum = 0.0;
+    for (size_t i = 0; i < pixelCount; i++) {
+        for (int c = 0; c < channels; c++) {
+            double d = (double)a[i * 4 + c] - b[i * 4 + c];
+            sum += d * d;
+        }
+    }
+    double mse = sum / ((double)pixelCount * channels);
+    if (mse <= 0.0) return 99.0;    // imagens idênticas
+    return 10.0 * log10(255.0 * 255.0 / mse);
+}
+
+
+// Bloco de cor BC1 (também a metade de cor do BC3): sempre no modo de 4 cores (color0 > color1)
+void BlockCompression::encodeColor(const unsigned char* block, unsigned char* output) {
+    float mean[4], axis[4], first[4], second[4];
+    principalAxis(block, 3, mean, axis);
+    axisEndpoints(block, 3, mean, axis, first, second);
+
+    uint16_t color0 = pack565(first), color1 = pack565(second);
+    unsigned char indices[16];
+    int error = fitColorIndices(block, color0, color1, indices);
+
+    // refinamento: extremos por mínimos quadrados sobre os índices atuais, enquanto o erro cair
+    static const float INDEX_WEIGHTS[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };  // peso de color0
+    for (int iteration = 0; iteration < 2 && error > 0; iteration++) {
+        float weights[16];
+        for (int i = 0; i < 16; i++) weights[i] = INDEX_WEIGHTS[indices[i]];
+        if (!leastSquares(block, 3, weights, first, second)) break;
+
+        uint16_t refined0 = pack565(first), refined1 = pack565(second);
+        unsigned char refinedIndices[16];
+        int refinedError = fitColorIndices(block, refined0, refined1, refinedIndices);
+        if (refinedError >= error) break;
+
+        color0 = refined0;
+        color1 = refined1;
+        error = refinedError;
+        memcpy(indices, refinedIndices, sizeof(indices));
+    }
+
+    // o modo de 4 cores exige color0 > color1: trocar os extremos troca 0 <-> 1 e 2 <-> 3
+    if (color0 < color1) {
+        std::swap(color0, color1);
+        for (int i = 0; i < 16; i++) indices[i] ^= 1;
+    } else if (color0 == color1) {
+        memset(indices, 0, sizeof(indices));
+    }
+
+    uint32_t bits = 0;
+    for (int i = 0; i < 16; i++) bits |= (uint32_t)indices[i] << (2 * i);
+
+    output[0] = (unsigned char)(color0 & 0xFF);
+    output[1] = (unsigned char)(color0 >> 8);
+    output[2] = (unsigned char)(color1 & 0xFF);
+    output[3] = (unsigned char)(color1 >> 8);
+    for (int i = 0; i < 4; i++) output[4 + i] = (unsigned char)(bits >> (8 * i));
+}
+
+
+// Bloco de alfa do BC3: extremos no mínimo e máximo do bloco, 6 valores interpolados entre eles
+void BlockCompression::encodeAlpha(const unsigned char* block, unsigned char* output) {
+    int alpha0 = 0, alpha1 = 255;
+    for (int i = 0; i < 16; i++) {
+        alpha0 = std::max(alpha0, (int)block[i * 4 + 3]);
+        alpha1 = std::min(alpha1, (int)block[i * 4 + 3]);
+    }
+
+    uint64_t bits = 0;
+    if (alpha0 > alpha1) {
+        int palette[8] = { alpha0, alpha1 };
+        for (int i = 2; i < 8; i++) palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1) / 7;
+
+        for (int i = 0; i < 16; i++) {
+            int best = 0, bestError = 256;
+            for (int p = 0; p < 8; p++) {
+                int error = std::abs(block[i * 4 + 3] - palette[p]);
+                if (error < bestError) {
+                    bestError = error;
+                    best = p;
+                }
+            }
+            bits |= (uint64_t)best << (3 * i);
+        }
+    }
+
+    output[0] = (unsigned char)alpha0;
+    output[1] = (unsigned char)alpha1;
+    for (int i = 0; i < 6; i++) output[2 + i] = (unsigned char)(bits >> (8 * i));
+}
+
+
+// BC7 modo 6: bit de modo (6 zeros e um 1), extremos R0 R1 G0 G1 B0 B1 A0 A1 de 7 bits, p-bits P0 P1 e
+// 16 índices de 4 bits (o primeiro com 3: seu bit mais alto é implícito 0 - "anchor")
+void BlockCompression::encodeBC7(const unsigned char* block, unsigned char* output) {
+    float mean[4], axis[4], first[4], second[4];
+    principalAxis(block, 4, mean, axis);
+    axisEndpoints(block, 4, mean, axis, first, second);
+
+    int endpoint0[4], endpoint1[4], pBit0 = 0, pBit1 = 0;
+    quantizeBC7(first, endpoint0, pBit0);
+    quantizeBC7(second, endpoint1, pBit1);
+
+    unsigned char indices[16];
+    int error = fitBC7Indices(block, endpoint0, endpoint1, indices);
+
+    for (int iteration = 0; iteration < 2 && error > 0; iteration++) {
+        float weights[16];
+        for (int i = 0; i < 16; i++) weights[i] = (64 - BC7_WEIGHTS[indices[i]]) / 64.0f;
+        if (!leastSquares(block, 4, weights, first, second)) break;
+
+        int refined0[4], refined1[4], refinedP0 = 0, refinedP1 = 0;
+        quantizeBC7(first, refined0, refinedP0);
+        quantizeBC7(second, refined1, refinedP1);
+        unsigned char refinedIndices[16];
+        int refinedError = fitBC7Indices(block, refined0, refined1, refinedIndices);
+        if (refinedError >= error) break;
+
+        memcpy(endpoint0, refined0, sizeof(refined0));
+        memcpy(endpoint1, refined1, sizeof(refined1));
+        pBit0 = refinedP0;
+        pBit1 = refinedP1;
+        error = refinedError;
+        memcpy(indices, refinedIndices, sizeof(indices));
+    }
+
+    // o índice do texel 0 precisa caber em 3 bits: troca os extremos e inverte os índices
+    if (indices[0] >= 8) {
+        for (int c = 0; c < 4; c++) std::swap(endpoint0[c], endpoint1[c]);
+        std::swap(pBit0, pBit1);
+        for (int i = 0; i < 16; i++) indices[i] = (unsigned char)(15 - indices[i]);
+    }
+
+    memset(output, 0, 16);
+    int position = 0;
+    putBits(output, position, 1u << 6, 7);
+    for (int c = 0; c < 4; c++) {
+        putBits(output, position, (unsigned int)endpoint0[c] >> 1, 7);
+        putBits(output, position, (unsigned int)endpoint1[c] >> 1, 7);
+    }
+    putBits(output, position, (unsigned int)pBit0, 1);
+    putBits(output, position, (unsigned int)pBit1, 1);
+    for (int i = 0; i < 16; i++) putBits(output, position, indices[i], i == 0 ? 3 : 4);
+}
+
+
+void BlockCompression::decodeColor(const unsigned char* input, unsigned char* block, bool threeColorMode) {
+    uint16_t color0 = (uint16_t)(input[0] | (input[1] << 8));
+    uint16_t color1 = (uint16_t)(input[2] | (input[3] << 8));
+    uint32_t bits = input[4] | (input[5] << 8) | (input[6] << 16) | ((uint32_t)input[7] << 24);
+
+    int palette[4][3];
+    colorPalette(color0, color1, threeColorMode && color0 <= color1, palette);
+
+    for (int i = 0; i < 16; i++) {
+        int index = (bits >> (2 * i)) & 3;
+        for (int c = 0; c < 3; c++) block[i * 4 + c] = (unsigned char)palette[index][c];
+        block[i * 4 + 3] = 255;
+    }
+}
+
+
+void BlockCompression::decodeAlpha(const unsigned char* input, unsigned char* block) {
+    int alpha0 = input[0], alpha1 = input[1];
+    int palette[8] = { alpha0, alpha1 };
+    for (int i = 2; i < 8; i++) {
+        palette[i] = alpha0 > alpha1 ? ((8 - i) * alpha0 + (i - 1) * alpha1) / 7
+                   : (i < 6 ? ((6 - i) * alpha0 + (i - 1) * alpha1) / 5 : (i == 6 ? 0 : 255));
+    }
+
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; i++) bits |= (uint64_t)input[2 + i] << (8 * i);
+    for (int i = 0; i < 16; i++) block[i * 4 + 3] = (unsigned char)palette[(bits >> (3 * i)) & 7];
+}
+
+
+void BlockCompression::decodeBC7(const unsigned char* input, unsigned char* block) {
+    int position = 0;
+    if (getBits(input, position, 7) != (1u << 6)) {
+        memset(block, 0, 64);   // outro modo: não gerado pelo encoder
+        return;
+    }
+
+    int endpoint0[4], endpoint1[4];
+    for (int c = 0; c < 4; c++) {
+        endpoint0[c] = (int)getBits(input, position, 7) << 1;
+        endpoint1[c] = (int)getBits(input, position, 7) << 1;
+    }
+    int pBit0 = (int)getBits(input, position, 1), pBit1 = (int)getBits(input, position, 1);
+    for (int c = 0; c < 4; c++) {
+        endpoint0[c] |= pBit0;
+        endpoint1[c] |= pBit1;
+    }
+
+    for (int i = 0; i < 16; i++) {
+        int weight = BC7_WEIGHTS[getBits(input, position, i == 0 ? 3 : 4)];
+        for (int c = 0; c < 4; c++) {
+            block[i * 4 + c] = (unsigned char)(((64 - weight) * endpoint0[c] + weight * endpoint1[c] + 32) >> 6);
+        }
+    }
+}
+
+
+const char* BlockCompression::formatName(BlockFormat format) {
+    switch (format) {
+        case BLOCK_BC3: return "bc3";
+        case BLOCK_BC7: return "bc7";
+        default:        return "bc1";
+    }
+}
+
+
+bool BlockCompression::parseFormat(const string& name, BlockFormat& format) {
+    if (name == "bc1")      format = BLOCK_BC1;
+    else if (name == "bc3") format = BLOCK_BC3;
+    else if (name == "bc7") format = BLOCK_BC7;
+    else return false;
+    return true;
+}
@@ -0,0 +1,63 @@
+#include "CameraPath.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+bool CameraPath::load(const string& path) {
+    ifstream file(path);
+    if (!file) {
+        cerr << "Caminho de camera nao encontrado: " << path << endl;
+        return false;
+    }
+
+    keys.clear();
+    string line;
+    while (getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        istringstream sline(line);
+        CameraKey key;
+        if (sline >> key.frame >> key.position.x >> key.position.y >> key.position.z >> key.yaw >> key.pitch) {
+            keys.push_back(key);
+        }
+    }
+
+    sort(keys.begin(), keys.end(), [](const CameraKey& a, const CameraKey& b) { return a.frame < b.frame; });
+
+    if (keys.empty()) {
+        cerr << "Caminho de camera sem chaves: " << path << endl;
+        return false;
+    }
+
+    cout << "Caminho de camera: " << keys.size() << " chaves, " << lastFrame() + 1 << " frames" << endl;
+    return true;
+}
+
+
+void CameraPath::apply(int frame, Camera& camera) const {
+    if (keys.empty()) return;
+
+    // primeira chave com frame maior que o pedido: o trecho vai da anterior até ela
+    auto next = upper_bound(keys.begin(), keys.end(), frame,
+                            [](int value, const CameraKey& key) { return value < key.frame; });
+
+    CameraKey current;
+    if (next == keys.begin()) {
+        current = keys.front();
+    } else if (next == keys.end()) {
+        current = keys.back();
+    } else {
+        const CameraKey& previous = *(next - 1);
+        float t = float(frame - previous.frame) / float(next->frame - previous.frame);
+
+        current.position = glm::mix(previous.position, next->position, t);
+        current.yaw   = glm::mix(previous.yaw, next->yaw, t);
+        current.pitch = glm::mix(previous.pitch, next->pitch, t);
+    }
+
+    camera.Position = current.position;
+    camera.Yaw = current.yaw;
+    camera.Pitch = current.pitch;
+    camera.updateCameraVectors();
+}
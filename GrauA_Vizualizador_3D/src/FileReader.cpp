@@ -0,0 +1,426 @@
+#include "FileReader.h"
+#include "Profiler.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+
+#ifdef HAS_IO_URING
+// Anel do io_uring mapeado do kernel: a fila de envio (SQ) recebe os pedidos, a de conclusão (CQ)
+// devolve os resultados. Só a thread de E/S mexe nele
+struct FileReader::Ring {
+    int fd = -1;
+    void* sqMap = MAP_FAILED;
+    void* cqMap = MAP_FAILED;
+    size_t sqMapSize = 0, cqMapSize = 0;
+    io_uring_sqe* sqes = (io_uring_sqe*)MAP_FAILED;
+    size_t sqesSize = 0;
+    unsigned *sqTail = nullptr, *sqMask = nullptr, *sqArray = nullptr;
+    unsigned *cqHead = nullptr, *cqTail = nullptr, *cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    vector<vector<unsigned char>> orphaned;     // buffers de leituras abandonadas (o kernel ainda pode escrever)
+
+    bool setup(unsigned int entries) {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0) return false;
+
+        sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) sqMapSize = cqMapSize = max(sqMapSize, cqMapSize);
+
+        sqMap = mmap(nullptr, sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqMap == MAP_FAILED) return false;
+        cqMap = singleMap ? sqMap : mmap(nullptr, cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                         fd, IORING_OFF_CQ_RING);
+        if (cqMap == MAP_FAILED) return false;
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = (io_uring_sqe*)mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                   fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return false;
+
+        char* sq = (char*)sqMap;
+        char* cq = (char*)cqMap;
+        sqTail  = (unsigned*)(sq + params.sq_off.tail);
+        sqMask  = (unsigned*)(sq + params.sq_off.ring_mask);
+        sqArray = (unsigned*)(sq + params.sq_off.array);
+        cqHead  = (unsigned*)(cq + params.cq_off.head);
+        cqTail  = (unsigned*)(cq + params.cq_off.tail);
+        cqMask  = (unsigned*)(cq + params.cq_off.ring_mask);
+        cqes    = (io_uring_cqe*)(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    void release() {
+        if (sqes != MAP_FAILED) munmap(sqes, sqesSize);
+        if (cqMap != MAP_FAILED && cqMap != sqMap) munmap(cqMap, cqMapSize);
+        if (sqMap != MAP_FAILED) munmap(sqMap, sqMapSize);
+        if (fd >= 0) close(fd);
+        fd = -1;
+        sqMap = cqMap = MAP_FAILED;
+        sqes = (io_uring_sqe*)MAP_FAILED;
+        orphaned.clear();
+    }
+
+    // Próxima posição livre da SQ (o chamador garante que há espaço: no máximo uma leitura por slot)
+    io_uring_sqe* nextSqe() {
+        unsigned tail = *sqTail;
+        unsigned index = tail & *sqMask;
+        sqArray[index] = index;
+        memset(&sqes[index], 0, sizeof(io_uring_sqe));
+        return &sqes[index];
+    }
+
+    void publish(unsigned count) {
+        __atomic_store_n(sqTail, *sqTail + count, __ATOMIC_RELEASE);
+    }
+
+    int enter(unsigned toSubmit, unsigned minComplete) {
+        return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, IORING_ENTER_GETEVENTS, nullptr, 0);
+    }
+};
+#else
+struct FileReader::Ring {
+    void release() {}
+};
+#endif
+
+
+FileReader::FileReader() : active(READ_BACKEND_STREAM), depth(32), totalBytes(0), outstanding(0), stopping(false),
+                           ring(nullptr) {}
+
+FileReader::~FileReader() { stop(); }
+
+
+bool FileReader::start(ReadBackend backend, unsigned int queueDepth) {
+    if (isStarted() || backend == READ_BACKEND_STREAM) return false;
+
+    depth = max(1u, queueDepth);
+    stopping = false;
+
+    if (backend == READ_BACKEND_URING) {
+        if (startUring()) {
+            active = READ_BACKEND_URING;
+            uringThread = thread([this]() {
+                Profiler::setThreadName("io_uring");
+                uringLoop();
+            });
+            return true;
+        }
+        cout << "io_uring indisponivel; leitura dos arquivos com pread" << endl;
+    }
+
+    ioThreads.start(depth, "io");
+    active = READ_BACKEND_PREAD;
+    return true;
+}
+
+
+bool FileReader::startUring() {
+#ifdef HAS_IO_URING
+    ring = new Ring();
+    if (ring->setup(depth)) return true;
+
+    ring->release();
+    delete ring;
+    ring = nullptr;
+#endif
+    return false;
+}
+
+
+void FileReader::read(const string& path, Callback done) {
+    {
+        lock_guard<mutex> lock(requestMutex);
+        outstanding++;
+        if (active == READ_BACKEND_URING) pending.push_back({ path, move(done) });
+    }
+
+    if (active == READ_BACKEND_URING) {
+        requestAvailable.notify_one();
+        return;
+    }
+
+    Request request = { path, move(done) };
+    ioThreads.submit([this, request]() mutable {
+        PROFILE_SCOPE("FileReader::pread");
+        vector<unsigned char> data;
+        bool ok = readWhole(request.path, data);
+        deliver(request, data, ok);
+    });
+}
+
+
+void FileReader::wait() {
+    unique_lock<mutex> lock(requestMutex);
+    allDelivered.wait(lock, [this]() { return outstanding == 0; });
+}
+
+
+void FileReader::stop() {
+    {
+        lock_guard<mutex> lock(requestMutex);
+        stopping = true;
+        pending.clear();
+    }
+    requestAvailable.notify_all();
+
+    // a thread do io_uring só sai depois das leituras em andamento (o kernel ainda escreve nos buffers)
+    if (uringThread.joinable()) uringThread.join();
+    ioThreads.stop();
+
+    if (ring) {
+        ring->release();
+        delete ring;
+        ring = nullptr;
+    }
+
+    {
+        lock_guard<mutex> lock(requestMutex);
+        outstanding = 0;
+    }
+    allDelivered.notify_all();
+    active = READ_BACKEND_STREAM;
+}
+
+
+void FileReader::deliver(Request& request, vector<unsigned char>& data, bool ok) {
+    if (!ok) cerr << "Falha ao ler arquivo: " << request.path << endl;
+    else totalBytes += data.size();
+
+    request.done(data, ok);
+
+    lock_guard<mutex> lock(requestMutex);
+    if (--outstanding == 0) allDelivered.notify_all();
+}
+
+
+void FileReader::uringLoop() {
+#ifdef HAS_IO_URING
+    // uma leitura por slot; leituras curtas continuam do ponto em que pararam
+    struct Slot {
+        Request request;
+        int fd = -1;                // -1 = slot livre
+        vector<unsigned char> data;
+        size_t offset;
+        iovec chunk;
+    };
+    vector<Slot> slots(depth);
+    vector<unsigned int> freeSlots;
+    for (unsigned int i = depth; i > 0; i--) freeSlots.push_back(i - 1);
+    unsigned int inFlight = 0;
+    unsigned int toSubmit = 0;
+
+    auto queueRead = [&](unsigned int index) {
+        Slot& slot = slots[index];
+        slot.chunk.iov_base = slot.data.data() + slot.offset;
+        slot.chunk.iov_len = min(slot.data.size() - slot.offset, (size_t)1 << 30);
+
+        io_uring_sqe* sqe = ring->nextSqe();
+        sqe->opcode = IORING_OP_READV;
+        sqe->fd = slot.fd;
+        sqe->addr = (unsigned long long)&slot.chunk;
+        sqe->len = 1;
+        sqe->off = slot.offset;
+        sqe->user_data = index;
+        ring->publish(1);
+        toSubmit++;
+    };
+
+    auto finish = [&](unsigned int index, bool ok) {
+        Slot& slot = slots[index];
+        close(slot.fd);
+        slot.fd = -1;
+        slot.data.resize(slot.offset);
+        deliver(slot.request, slot.data, ok);
+        slot.request = Request();
+        vector<unsigned char>().swap(slot.data);
+        freeSlots.push_back(index);
+        inFlight--;
+    };
+
+    for (;;) {
+        // novos pedidos, enquanto houver slot livre
+        deque<Request> arrived;
+        {
+            unique_lock<mutex> lock(requestMutex);
+            if (inFlight == 0 && toSubmit == 0) {
+                requestAvailable.wait(lock, [this]() { return stopping || !pending.empty(); });
+            }
+            if (stopping && inFlight == 0) return;
+            while (!stopping && !pending.empty() && arrived.size() < freeSlots.size()) {
+                arrived.push_back(move(pending.front()));
+                pending.pop_front();
+            }
+        }
+
+        for (Request& request : arrived) {
+            vector<unsigned char> empty;
+            int fd = open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat info;
+            if (fd < 0 || fstat(fd, &info) != 0) {
+                if (fd >= 0) close(fd);
+                deliver(request, empty, false);
+                continue;
+            }
+            if (info.st_size == 0) {
+                close(fd);
+                deliver(request, empty, true);
+                continue;
+            }
+
+            // janela de leitura antecipada maior; WILLNEED aqui bloquearia a thread de E/S enquanto o
+            // kernel enfileira a leitura antecipada do arquivo inteiro (mais lento nas medidas)
+            posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+            unsigned int index = freeSlots.back();
+            freeSlots.pop_back();
+            Slot& slot = slots[index];
+            slot.request = move(request);
+            slot.fd = fd;
+            slot.data.resize((size_t)info.st_size);
+            slot.offset = 0;
+            inFlight++;
+            queueRead(index);
+        }
+
+        if (inFlight == 0) continue;
+
+        {
+            PROFILE_SCOPE("FileReader::io_uring_enter");
+            int submitted = ring->enter(toSubmit, 1);
+            if (submitted < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                cerr << "Falha no io_uring_enter: " << strerror(errno) << "; leituras restantes com pread" << endl;
+                break;
+            }
+            if (submitted > 0) toSubmit -= min(toSubmit, (unsigned int)submitted);
+        }
+
+        // conclusões
+        unsigned head = *ring->cqHead;
+        unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            const io_uring_cqe& cqe = ring->cqes[head & *ring->cqMask];
+            unsigned int index = (unsigned int)cqe.user_data;
+            Slot& slot = slots[index];
+
+            if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+                queueRead(index);
+            } else if (cqe.res < 0) {
+                finish(index, false);
+            } else if (cqe.res == 0) {
+                finish(index, true);    // o arquivo encolheu durante a leitura
+            } else {
+                slot.offset += (size_t)cqe.res;
+                if (slot.offset < slot.data.size()) queueRead(index);
+                else finish(index, true);
+            }
+        }
+        __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    // anel inutilizável: as leituras em andamento são refeitas com pread e as próximas também saem por
+    // pread, nesta thread, para que todo pedido seja entregue (wait não fica esperando para sempre). Os
+    // buffers das leituras abandonadas só são liberados com o anel
+    for (Slot& slot : slots) {
+        if (slot.fd < 0) continue;
+        close(slot.fd);
+        slot.fd = -1;
+        ring->orphaned.push_back(move(slot.data));
+
+        vector<unsigned char> data;
+        bool ok = readWhole(slot.request.path, data);
+        deliver(slot.request, data, ok);
+    }
+
+    for (;;) {
+        Request request;
+        {
+            unique_lock<mutex> lock(requestMutex);
+            requestAvailable.wait(lock, [this]() { return stopping || !pending.empty(); });
+            if (stopping) return;
+            request = move(pending.front());
+            pending.pop_front();
+        }
+
+        PROFILE_SCOPE("FileReader::pread");
+        vector<unsigned char> data;
+        bool ok = readWhole(request.path, data);
+        deliver(request, data, ok);
+    }
+#endif
+}
+
+
+bool FileReader::readWhole(const string& path, vector<unsigned char>& data) {
+#ifdef _WIN32
+    ifstream file(path, ios::binary | ios::ate);
+    if (!file) return false;
+    data.resize((size_t)file.tellg());
+    file.seekg(0);
+    file.read((char*)data.data(), data.size());
+    return (bool)file;
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);    // janela de leitura antecipada maior
+#endif
+
+    data.resize((size_t)info.st_size);
+    size_t offset = 0;
+    ssize_t count = 0;
+    while (offset < data.size()) {
+        count = pread(fd, data.data() + offset, data.size() - offset, (off_t)offset);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) break;
+        offset += (size_t)count;
+    }
+    close(fd);
+
+    data.resize(offset);
+    return count >= 0;
+#endif
+}
+
+
+const char* FileReader::backendName(ReadBackend backend) {
+    switch (backend) {
+        case READ_BACKEND_URING: return "uring";
+        case READ_BACKEND_PREAD: return "pread";
+        default:                 return "stream";
+    }
+}
+
+
+bool FileReader::parseBackend(const string& name, ReadBackend& backend) {
+    if (name == "uring")       backend = READ_BACKEND_URING;
+    else if (name == "pread")  backend = READ_BACKEND_PREAD;
+    else if (name == "stream") backend = READ_BACKEND_STREAM;
+    else return false;
+    return true;
+}
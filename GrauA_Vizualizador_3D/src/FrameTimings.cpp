@@ -0,0 +1,106 @@
+#include "FrameTimings.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+
+float FrameTimings::percentile(float p) const {
+    if (frames.empty()) return 0.0f;
+
+    vector<float> sorted;
+    sorted.reserve(frames.size());
+    for (const auto& frame : frames) sorted.push_back(frame.frameMs);
+    sort(sorted.begin(), sorted.end());
+
+    size_t rank = (size_t)ceil(p / 100.0f * sorted.size());
+    if (rank > 0) rank--;
+    return sorted[min(rank, sorted.size() - 1)];
+}
+
+
+bool FrameTimings::writeCSV(const string& path) const {
+    ofstream file(path);
+    if (!file) {
+        cerr << "Falha ao gravar tempos de frame em " << path << endl;
+        return false;
+    }
+
+    file << "frame,cpu_ms,gpu_ms,frame_ms,draw_calls,triangles\n";
+    for (size_t i = 0; i < frames.size(); i++) {
+        file << i << "," << frames[i].cpuMs << ",";
+        if (frames[i].gpuMs >= 0.0f) file << frames[i].gpuMs;
+        file << "," << frames[i].frameMs << ","
+             << frames[i].drawCalls << "," << frames[i].triangles << "\n";
+    }
+
+    cout << "Tempos de " << frames.size() << " frames gravados em " << path << endl;
+    return true;
+}
+
+
+void FrameTimings::printSummary() const {
+    if (frames.empty()) return;
+
+    double total = 0.0, cpuTotal = 0.0, gpuTotal = 0.0, drawCalls = 0.0, triangles = 0.0;
+    size_t gpuFrames = 0;
+    for (const auto& frame : frames) {
+        total += frame.frameMs;
+        cpuTotal += frame.cpuMs;
+        if (frame.gpuMs >= 0.0f) {
+            gpuTotal += frame.gpuMs;
+            gpuFrames++;
+        }
+        drawCalls += frame.drawCalls;
+        triangles += (double)frame.triangles;
+    }
+
+    double n = (double)frames.size();
+    double average = total / n;
+    cout << "Frames: " << frames.size()
+         << " | media " << average << " ms (" << (average > 0.0 ? 1000.0 / average : 0.0) << " FPS)"
+         << " | CPU media " << cpuTotal / n << " ms";
+    if (gpuFrames > 0) cout << " | GPU media " << gpuTotal / gpuFrames << " ms";
+    cout << endl;
+    cout << "  Tempo de frame: p50 " << percentile(50.0f) << " ms | p95 " << percentile(95.0f)
+         << " ms | p99 " << percentile(99.0f) << " ms | max " << percentile(100.0f) << " ms" << endl;
+    cout << "  Por frame: " << drawCalls / n << " draw calls, " << triangles / n << " triangulos" << endl;
+}
+
+
+bool FrameTimings::appendSummaryCSV(const string& path, const string& scene, size_t objects, double loadMs,
+                                    double firstFrameMs) const {
+    if (frames.empty()) return false;
+
+    bool exists = ifstream(path).good();
+    ofstream file(path, ios::app);
+    if (!file) {
+        cerr << "Falha ao gravar resumo em " << path << endl;
+        return false;
+    }
+    if (!exists) {
+        file << "scene,objects,load_ms,first_frame_ms,frames,mean_ms,p50_ms,p95_ms,p99_ms,max_ms,cpu_ms,gpu_ms,draw_calls,triangles\n";
+    }
+
+    double total = 0.0, cpuTotal = 0.0, gpuTotal = 0.0, drawCalls = 0.0, triangles = 0.0;
+    size_t gpuFrames = 0;
+    for (const auto& frame : frames) {
+        total += frame.frameMs;
+        cpuTotal += frame.cpuMs;
+        if (frame.gpuMs >= 0.0f) {
+            gpuTotal += frame.gpuMs;
+            gpuFrames++;
+        }
+        drawCalls += frame.drawCalls;
+        triangles += (double)frame.triangles;
+    }
+
+    double n = (double)frames.size();
+    file << scene << "," << objects << "," << loadMs << "," << firstFrameMs << "," << frames.size() << "," << total / n << ","
+         << percentile(50.0f) << "," << percentile(95.0f) << "," << percentile(99.0f) << "," << percentile(100.0f) << ","
+         << cpuTotal / n << ",";
+    if (gpuFrames > 0) file << gpuTotal / gpuFrames;
+    file << "," << drawCalls / n << "," << triangles / n << "\n";
+
+    cout << "Resumo da execucao acrescentado a " << path << endl;
+    return true;
+}
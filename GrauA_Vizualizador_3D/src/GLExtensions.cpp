@@ -0,0 +1,82 @@
+#include "GLExtensions.h"
+#include <iostream>
+
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC   glad_glMultiDrawElementsIndirect = NULL;
+PFNGLGETPROGRAMBINARYPROC            glad_glGetProgramBinary = NULL;
+PFNGLPROGRAMBINARYPROC               glad_glProgramBinary = NULL;
+PFNGLPROGRAMPARAMETERIPROC           glad_glProgramParameteri = NULL;
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glad_glMaxShaderCompilerThreadsKHR = NULL;
+PFNGLBUFFERSTORAGEPROC               glad_glBufferStorage = NULL;
+
+bool GLExtensions::multiDrawIndirect    = false;
+bool GLExtensions::shaderStorageBuffer  = false;
+bool GLExtensions::shaderDrawParameters = false;
+bool GLExtensions::programBinary        = false;
+bool GLExtensions::parallelShaderCompile = false;
+bool GLExtensions::bufferStorage        = false;
+bool GLExtensions::textureCompressionS3TC = false;
+bool GLExtensions::textureCompressionBPTC = false;
+
+
+void GLExtensions::load(GLADloadproc loader) {
+
+    glad_glMultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)loader("glMultiDrawElementsIndirect");
+
+    multiDrawIndirect    = glad_glMultiDrawElementsIndirect != NULL &&
+                           (hasVersion(4, 3) || hasExtension("GL_ARB_multi_draw_indirect"));
+    shaderStorageBuffer  = hasVersion(4, 3) || hasExtension("GL_ARB_shader_storage_buffer_object");
+    shaderDrawParameters = hasVersion(4, 6) || hasExtension("GL_ARB_shader_draw_parameters");
+
+    cout << "Multi-draw indirect: " << (multiDrawIndirect && shaderStorageBuffer && shaderDrawParameters
+                                        ? "disponivel" : "indisponivel") << endl;
+
+    glad_glGetProgramBinary  = (PFNGLGETPROGRAMBINARYPROC)loader("glGetProgramBinary");
+    glad_glProgramBinary     = (PFNGLPROGRAMBINARYPROC)loader("glProgramBinary");
+    glad_glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)loader("glProgramParameteri");
+
+    GLint binaryFormats = 0;
+    if (hasVersion(4, 1) || hasExtension("GL_ARB_get_program_binary")) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormats);
+    }
+    programBinary = glad_glGetProgramBinary != NULL && glad_glProgramBinary != NULL &&
+                    glad_glProgramParameteri != NULL && binaryFormats > 0;
+
+    glad_glMaxShaderCompilerThreadsKHR =
+        (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)loader("glMaxShaderCompilerThreadsKHR");
+    parallelShaderCompile = glad_glMaxShaderCompilerThreadsKHR != NULL &&
+                            hasExtension("GL_KHR_parallel_shader_compile");
+
+    cout << "Cache de programas: " << (programBinary ? "disponivel" : "indisponivel")
+         << ", compilacao paralela: " << (parallelShaderCompile ? "disponivel" : "indisponivel") << endl;
+
+    glad_glBufferStorage = (PFNGLBUFFERSTORAGEPROC)loader("glBufferStorage");
+    bufferStorage = glad_glBufferStorage != NULL && (hasVersion(4, 4) || hasExtension("GL_ARB_buffer_storage"));
+
+    cout << "Buffer de staging persistente: " << (bufferStorage ? "disponivel" : "indisponivel") << endl;
+
+    textureCompressionS3TC = hasExtension("GL_EXT_texture_compression_s3tc");
+    textureCompressionBPTC = hasVersion(4, 2) || hasExtension("GL_ARB_texture_compression_bptc");
+
+    cout << "Texturas comprimidas: BC1/BC3 " << (textureCompressionS3TC ? "disponivel" : "indisponivel")
+         << ", BC7 " << (textureCompressionBPTC ? "disponivel" : "indisponivel") << endl;
+}
+
+
+bool GLExtensions::hasVersion(int major, int minor) {
+    GLint contextMajor = 0, contextMinor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &contextMajor);
+    glGetIntegerv(GL_MINOR_VERSION, &contextMinor);
+    return contextMajor > major || (contextMajor == major && contextMinor >= minor);
+}
+
+
+bool GLExtensions::hasExtension(const string& name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+    for (GLint i = 0; i < count; i++) {
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+        if (extension && name == extension) return true;
+    }
+    return false;
+}
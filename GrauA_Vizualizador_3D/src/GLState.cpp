@@ -0,0 +1,248 @@
+#include "GLState.h"
+#include "GLExtensions.h"
+#include <iostream>
+
+unsigned long long GLState::issuedCalls = 0;
+unsigned long long GLState::elidedCalls = 0;
+
+namespace {
+    const GLuint UNKNOWN = 0xFFFFFFFFu;    // estado ainda não conhecido pelo cache
+    const int    UNKNOWN_FLAG = -1;
+
+    // alvos de buffer rastreados (os demais passam direto para o driver)
+    const GLenum bufferTargets[] = {
+        GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER,
+        GL_DRAW_INDIRECT_BUFFER, GL_PIXEL_UNPACK_BUFFER, GL_PIXEL_PACK_BUFFER,
+        GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER
+    };
+    const int BUFFER_TARGET_COUNT = sizeof(bufferTargets) / sizeof(bufferTargets[0]);
+
+    // alvos de textura rastreados por unidade
+    const GLenum textureTargets[] = { GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY };
+    const int TEXTURE_TARGET_COUNT = sizeof(textureTargets) / sizeof(textureTargets[0]);
+
+    GLuint currentProgram = UNKNOWN;
+    GLuint currentVAO     = UNKNOWN;
+    GLenum currentUnit    = UNKNOWN;    // GL_TEXTURE0 + n
+    GLuint boundTextures[GLState::MAX_TEXTURE_UNITS][TEXTURE_TARGET_COUNT];
+    GLuint boundBuffers[BUFFER_TARGET_COUNT];
+
+    int depthTest = UNKNOWN_FLAG;
+    int depthMask = UNKNOWN_FLAG;
+    int blend     = UNKNOWN_FLAG;
+    GLenum blendSrc = UNKNOWN, blendDst = UNKNOWN;
+
+    bool initialized = false;
+
+    void ensureInitialized() {
+        if (!initialized) GLState::invalidate();
+    }
+
+    int bufferSlot(GLenum target) {
+        for (int i = 0; i < BUFFER_TARGET_COUNT; i++) {
+            if (bufferTargets[i] == target) return i;
+        }
+        return -1;
+    }
+
+    int textureSlot(GLenum target) {
+        for (int i = 0; i < TEXTURE_TARGET_COUNT; i++) {
+            if (textureTargets[i] == target) return i;
+        }
+        return -1;
+    }
+
+    // aplica um flag (glEnable/glDisable) apenas se mudou
+    void setCapability(int& cached, GLenum capability, bool enabled) {
+        ensureInitialized();
+        int value = enabled ? 1 : 0;
+        if (cached == value) { GLState::elidedCalls++; return; }
+        if (enabled) glEnable(capability); else glDisable(capability);
+        cached = value;
+        GLState::issuedCalls++;
+    }
+}
+
+
+void GLState::useProgram(GLuint program) {
+    ensureInitialized();
+    if (currentProgram == program) { elidedCalls++; return; }
+    glUseProgram(program);
+    currentProgram = program;
+    issuedCalls++;
+}
+
+
+void GLState::bindVertexArray(GLuint vao) {
+    ensureInitialized();
+    if (currentVAO == vao) { elidedCalls++; return; }
+    glBindVertexArray(vao);
+    currentVAO = vao;
+    issuedCalls++;
+
+    // o GL_ELEMENT_ARRAY_BUFFER faz parte do estado do VAO: o valor antigo deixa de valer
+    boundBuffers[bufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+}
+
+
+void GLState::activeTexture(GLenum unit) {
+    ensureInitialized();
+    if (currentUnit == unit) { elidedCalls++; return; }
+    glActiveTexture(unit);
+    currentUnit = unit;
+    issuedCalls++;
+}
+
+
+void GLState::bindTexture(GLenum target, GLuint texture) {
+    ensureInitialized();
+    int slot = textureSlot(target);
+    GLuint unit = (currentUnit == UNKNOWN) ? UNKNOWN : currentUnit - GL_TEXTURE0;
+
+    if (slot < 0 || unit >= MAX_TEXTURE_UNITS) {   // não rastreado: sempre emite
+        glBindTexture(target, texture);
+        issuedCalls++;
+        return;
+    }
+
+    if (boundTextures[unit][slot] == texture) { elidedCalls++; return; }
+    glBindTexture(target, texture);
+    boundTextures[unit][slot] = texture;
+    issuedCalls++;
+}
+
+
+void GLState::bindTextureUnit(GLuint unit, GLenum target, GLuint texture) {
+    ensureInitialized();
+    int slot = textureSlot(target);
+
+    // já vinculada na unidade: nem o glActiveTexture é necessário
+    if (slot >= 0 && unit < MAX_TEXTURE_UNITS && boundTextures[unit][slot] == texture) {
+        elidedCalls++;
+        return;
+    }
+
+    activeTexture(GL_TEXTURE0 + unit);
+    bindTexture(target, texture);
+}
+
+
+void GLState::bindBuffer(GLenum target, GLuint buffer) {
+    ensureInitialized();
+    int slot = bufferSlot(target);
+
+    if (slot < 0) {
+        glBindBuffer(target, buffer);
+        issuedCalls++;
+        return;
+    }
+
+    if (boundBuffers[slot] == buffer) { elidedCalls++; return; }
+    glBindBuffer(target, buffer);
+    boundBuffers[slot] = buffer;
+    issuedCalls++;
+}
+
+
+void GLState::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    ensureInitialized();
+    glBindBufferBase(target, index, buffer);    // pontos indexados não são rastreados
+    issuedCalls++;
+
+    int slot = bufferSlot(target);
+    if (slot >= 0) boundBuffers[slot] = buffer;
+}
+
+
+void GLState::setDepthTest(bool enabled) { setCapability(depthTest, GL_DEPTH_TEST, enabled); }
+
+void GLState::setBlend(bool enabled) { setCapability(blend, GL_BLEND, enabled); }
+
+void GLState::setDepthMask(bool enabled) {
+    ensureInitialized();
+    int value = enabled ? 1 : 0;
+    if (depthMask == value) { elidedCalls++; return; }
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    depthMask = value;
+    issuedCalls++;
+}
+
+void GLState::blendFunc(GLenum srcFactor, GLenum dstFactor) {
+    ensureInitialized();
+    if (blendSrc == srcFactor && blendDst == dstFactor) { elidedCalls++; return; }
+    glBlendFunc(srcFactor, dstFactor);
+    blendSrc = srcFactor;
+    blendDst = dstFactor;
+    issuedCalls++;
+}
+
+
+// O driver desvincula automaticamente objetos excluídos; o cache precisa refletir isso
+void GLState::deleteProgram(GLuint program) {
+    ensureInitialized();
+    if (program == 0) return;
+    glDeleteProgram(program);
+    if (currentProgram == program) currentProgram = UNKNOWN;  // o programa continua em uso até a troca
+}
+
+void GLState::deleteVertexArray(GLuint vao) {
+    ensureInitialized();
+    if (vao == 0) return;
+    glDeleteVertexArrays(1, &vao);
+    if (currentVAO == vao) {
+        currentVAO = 0;
+        boundBuffers[bufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+    }
+}
+
+void GLState::deleteBuffer(GLuint buffer) {
+    ensureInitialized();
+    if (buffer == 0) return;
+    glDeleteBuffers(1, &buffer);
+    for (int i = 0; i < BUFFER_TARGET_COUNT; i++) {
+        if (boundBuffers[i] == buffer) boundBuffers[i] = 0;
+    }
+}
+
+void GLState::deleteTexture(GLuint texture) {
+    ensureInitialized();
+    if (texture == 0) return;
+    glDeleteTextures(1, &texture);
+    for (unsigned int unit = 0; unit < MAX_TEXTURE_UNITS; unit++) {
+        for (int t = 0; t < TEXTURE_TARGET_COUNT; t++) {
+            if (boundTextures[unit][t] == texture) boundTextures[unit][t] = 0;
+        }
+    }
+}
+
+
+void GLState::invalidate() {
+    currentProgram = UNKNOWN;
+    currentVAO     = UNKNOWN;
+    currentUnit    = UNKNOWN;
+
+    for (unsigned int unit = 0; unit < MAX_TEXTURE_UNITS; unit++) {
+        for (int t = 0; t < TEXTURE_TARGET_COUNT; t++) boundTextures[unit][t] = UNKNOWN;
+    }
+    for (int i = 0; i < BUFFER_TARGET_COUNT; i++) boundBuffers[i] = UNKNOWN;
+
+    depthTest = depthMask = blend = UNKNOWN_FLAG;
+    blendSrc = blendDst = UNKNOWN;
+
+    initialized = true;
+}
+
+
+void GLState::resetCounters() {
+    issuedCalls = 0;
+    elidedCalls = 0;
+}
+
+
+void GLState::printReport() {
+    unsigned long long total = issuedCalls + elidedCalls;
+    if (total == 0) return;
+
+    cout << "Cache de estado OpenGL: " << issuedCalls << " chamadas emitidas, "
+         << elidedCalls << " descartadas (" << (100.0 * elidedCalls / total) << "% redundantes)" << endl;
+}
@@ -0,0 +1,145 @@
+#include "GpuTimer.h"
+#include "Profiler.h"
+#include <iostream>
+#include <cstring>
+
+GpuTimer::GpuTimer()
+    : enabled(true), lastFrameMs(0.0), resolvedFrames(0), skippedFrames(0),
+      frameActive(false), passActive(false), frameCounter(0) {
+    current.index = 0;
+}
+
+GpuTimer::~GpuTimer() {}    // as queries são liberadas em cleanup(), com o contexto ainda ativo
+
+
+GLuint GpuTimer::acquireQuery() {
+    if (pool.empty()) {
+        GLuint query;
+        glGenQueries(1, &query);
+        allQueries.push_back(query);
+        return query;
+    }
+    GLuint query = pool.back();
+    pool.pop_back();
+    return query;
+}
+
+
+void GpuTimer::beginFrame() {
+    resolved.clear();
+    if (!enabled) return;
+
+    resolve(false);
+
+    current.index = frameCounter++;
+    current.passes.clear();
+
+    // GPU atrasada demais: não mede este frame, para não acumular queries nem esperar
+    frameActive = pending.size() < MAX_PENDING_FRAMES;
+    if (!frameActive) skippedFrames++;
+}
+
+
+void GpuTimer::beginPass(const char* name) {
+    if (!frameActive) return;
+
+    if (passActive) glEndQuery(GL_TIME_ELAPSED);
+
+    PendingPass pass;
+    pass.name = name;
+    pass.query = acquireQuery();
+    pass.cpuTicks = Profiler::now();
+    glBeginQuery(GL_TIME_ELAPSED, pass.query);
+
+    current.passes.push_back(pass);
+    passActive = true;
+}
+
+
+void GpuTimer::endFrame() {
+    if (!frameActive) return;
+
+    if (passActive) {
+        glEndQuery(GL_TIME_ELAPSED);
+        passActive = false;
+    }
+    if (!current.passes.empty()) pending.push_back(current);
+    frameActive = false;
+}
+
+
+// Lê os frames mais antigos cujas queries terminaram; com wait = false, para no primeiro
+// frame ainda em execução na GPU (os seguintes também estão)
+void GpuTimer::resolve(bool wait) {
+    while (!pending.empty()) {
+        PendingFrame& frame = pending.front();
+
+        if (!wait) {
+            GLuint available = GL_FALSE;    // a última query do frame termina por último
+            glGetQueryObjectuiv(frame.passes.back().query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) break;
+        }
+
+        lastFrame.clear();
+        lastFrameMs = 0.0;
+        for (const auto& pass : frame.passes) {
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(pass.query, GL_QUERY_RESULT, &nanoseconds);
+            pool.push_back(pass.query);
+
+            double ms = nanoseconds / 1.0e6;
+            lastFrame.push_back({ pass.name, ms });
+            lastFrameMs += ms;
+
+            // acumula por nome (poucos passes: busca linear)
+            bool found = false;
+            for (auto& total : totals) {
+                if (strcmp(total.first, pass.name) == 0) {
+                    total.second += ms;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) totals.push_back({ pass.name, ms });
+
+            Profiler::addGpuEvent(pass.name, pass.cpuTicks, ms);
+        }
+
+        resolved.push_back({ frame.index, lastFrameMs });
+        resolvedFrames++;
+        pending.pop_front();
+    }
+}
+
+
+void GpuTimer::flush() {
+    if (passActive) endFrame();
+    resolve(true);
+}
+
+
+void GpuTimer::printReport() const {
+    if (resolvedFrames == 0) return;
+
+    double n = (double)resolvedFrames;
+    double total = 0.0;
+    cout << "Tempo de GPU por frame (media de " << resolvedFrames << " frames):";
+    for (const auto& pass : totals) {
+        cout << " " << pass.first << " " << pass.second / n << " ms |";
+        total += pass.second;
+    }
+    cout << " total " << total / n << " ms";
+    if (skippedFrames > 0) cout << " (" << skippedFrames << " frames sem medicao)";
+    cout << endl;
+}
+
+
+void GpuTimer::cleanup() {
+    if (!allQueries.empty()) {
+        glDeleteQueries((GLsizei)allQueries.size(), allQueries.data());
+    }
+    allQueries.clear();
+    pool.clear();
+    pending.clear();
+    frameActive = passActive = false;
+}
@@ -1,12 +1,16 @@
 #include "Group.h"
 #include <glad/glad.h>
+#include "GLState.h"
+#include "Profiler.h"
+#include "Stats.h"
 #include <iostream>
+#include <unordered_map>
 
 Group::Group()
-    : name(""), VAO(0), VBO(0), vertexCount(0) {}
+    : name(""), VAO(0), VBO(0), EBO(0), vertexCount(0), indexCount(0) {}
 
 Group::Group(const string& groupName) 
-    : name(groupName), VAO(0), VBO(0), vertexCount(0) {}
+    : name(groupName), VAO(0), VBO(0), EBO(0), vertexCount(0), indexCount(0) {}
 
 Group::~Group() { cleanup(); }
 
@@ -27,16 +31,64 @@ void Group::addFace(const Face& face) {
 void Group::setupBuffers(const vector<glm::vec3>& objVertices,      // recebe referência dos vetores que guardam a posição,
                          const vector<glm::vec2>& objTexCoords,     // textura e normais do objeto/Grupo em processamento,
                          const vector<glm::vec3>& objNormals   ) {  // acessados através dos índices das faces do grupo
+    PROFILE_SCOPE("Group::setupBuffers");
 
-    // Primeiro gera os dados sequenciais dos vértices do grupo, dentro do vetor "vertices"
+    {
+        PROFILE_SCOPE("Group::buildVertexData");
+        buildVertexData(objVertices, objTexCoords, objNormals); // dados sequenciais dos vértices (CPU)
+    }
+
+    PROFILE_SCOPE("Group::uploadBuffers");
+    uploadBuffers();    // envio dos dados para a OpenGL (GPU)
+}
+
+
+// Chave de um vértice da face: combinação dos índices de posição, textura e normal
+struct VertexKey {
+    unsigned int v, t, n;
+    bool operator==(const VertexKey& other) const { return v == other.v && t == other.t && n == other.n; }
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey& key) const {
+        return ((size_t)key.v * 73856093u) ^ ((size_t)key.t * 19349663u) ^ ((size_t)key.n * 83492791u);
+    }
+};
+
+
+// Gera os dados sequenciais dos vértices do grupo, dentro do vetor "vertices", e os índices
+// dos triângulos, dentro do vetor "indices". Não faz chamadas OpenGL.
+void Group::buildVertexData(const vector<glm::vec3>& objVertices,
+                            const vector<glm::vec2>& objTexCoords,
+                            const vector<glm::vec3>& objNormals) {
 
     vertices.clear();   // limpa dados anteriores, se houver, do vetor que guardará as informações
                         // dos vértices a serem enviados para renderização. Inseridos sequencialmente.
                         // posição<3> + texCoord<2> + normal<3> = 8 floats por vértice
+    indices.clear();
+
+    // vértices já inseridos em "vertices": a mesma combinação posição/textura/normal é reaproveitada via índice
+    unordered_map<VertexKey, unsigned int, VertexKeyHash> uniqueVertices;
+    uniqueVertices.reserve(faces.size() * 3);
     
     for (const auto& face : faces) { // para cada face do grupo faz uma iteração e guarda informações em "vertices"
 
         for (size_t i = 0; i < face.vertexIndices.size(); i++) { // para cada posição de "vertexIndices" faz uma iteração
+
+            VertexKey key;
+            key.v = face.vertexIndices[i];
+            key.t = i < face.textureIndices.size() ? face.textureIndices[i] : 0;
+            key.n = i < face.normalIndices.size()  ? face.normalIndices[i]  : 0;
+
+            auto found = uniqueVertices.find(key);
+            if (found != uniqueVertices.end()) {    // vértice repetido: só adiciona o índice
+                indices.push_back(found->second);
+                continue;
+            }
+
+            unsigned int newIndex = (unsigned int)(vertices.size() / 8);
+            uniqueVertices.emplace(key, newIndex);
+            indices.push_back(newIndex);
             
             if (face.vertexIndices[i] - 1 < objVertices.size()) {               // ajuste de índice (OBJ inicia em 1 e vector em 0)
                 const auto& vertex = objVertices[face.vertexIndices[i] - 1];    // acessa a informação da posição do vértice indiretamente, via índice
@@ -75,19 +127,45 @@ void Group::setupBuffers(const vector<glm::vec3>& objVertices,      // recebe re
         }
     }
     
-    // Calcular número de vértices do grupo
+    // Calcular número de vértices e de índices do grupo
     vertexCount = vertices.size() / 8; // 8 floats por vértice (posição<3> + texCoord<2> + normal<3>)    
+    indexCount  = indices.size();
+}
 
 
-    // Agora sim, configura os buffers OpenGL (VBO e VAO) para o grupo
+// Configura os buffers OpenGL (VBO, EBO e VAO) para o grupo
+void Group::uploadBuffers() {
+    createBuffers(true);
+    setupVertexArray();
 
-    glGenVertexArrays(1, &VAO);
+    //cout << "Grupo \"" << name << "\" configurado com " << faces.size() << " faces, "
+    //     << vertexCount << " vertices" << endl; // cada vértice tem 8 floats (posição <3>, texCoord <2>, normal <3>)
+}
+
+
+void Group::createBuffers(bool withData) {
     glGenBuffers(1, &VBO);  // optamos por usar um único VBO para posições, texturas e normais
+    glGenBuffers(1, &EBO);
+
+    // GL_COPY_WRITE_BUFFER: cria os dois buffers sem alterar o VAO vinculado
+    GLState::bindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, vertices.size() * sizeof(float), withData ? vertices.data() : nullptr,
+                 GL_STATIC_DRAW);
+
+    GLState::bindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, indices.size() * sizeof(unsigned int), withData ? indices.data() : nullptr,
+                 GL_STATIC_DRAW);
+
+    Stats::add(STAT_GPU_MEMORY, (double)(vertices.size() * sizeof(float) + indices.size() * sizeof(unsigned int)));
+}
+
+
+void Group::setupVertexArray() {
+    glGenVertexArrays(1, &VAO);
+    GLState::bindVertexArray(VAO);
     
-    glBindVertexArray(VAO);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);  // fica registrado no VAO
     
     // Position attribute
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
@@ -101,29 +179,31 @@ void Group::setupBuffers(const vector<glm::vec3>& objVertices,      // recebe re
     glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(5 * sizeof(float)));
     glEnableVertexAttribArray(2);
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-
-    //cout << "Grupo \"" << name << "\" configurado com " << faces.size() << " faces, "
-    //     << vertexCount << " vertices" << endl; // cada vértice tem 8 floats (posição <3>, texCoord <2>, normal <3>)
+    GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::bindVertexArray(0);
 }
 
 void Group::render() const {
 
     if (VAO == 0) return;
     
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
-    glBindVertexArray(0);
+    // o VAO fica vinculado: o próximo grupo que usar o mesmo VAO não precisa re-vinculá-lo
+    GLState::bindVertexArray(VAO);
+    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
 }
 
 void Group::cleanup() {
     if (VAO != 0) {
-        glDeleteVertexArrays(1, &VAO);
+        GLState::deleteVertexArray(VAO);
         VAO = 0;
     }
     if (VBO != 0) {
-        glDeleteBuffers(1, &VBO);
+        GLState::deleteBuffer(VBO);
         VBO = 0;
+        Stats::add(STAT_GPU_MEMORY, -(double)(vertices.size() * sizeof(float) + indices.size() * sizeof(unsigned int)));
+    }
+    if (EBO != 0) {
+        GLState::deleteBuffer(EBO);
+        EBO = 0;
     }
 }
\ No newline at end of file
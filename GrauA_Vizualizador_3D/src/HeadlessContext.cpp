@@ -0,0 +1,225 @@
+#include "HeadlessContext.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstring>
+
+#ifdef __linux__
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+HeadlessContext::HeadlessContext()
+    : width(0), height(0), created(false),
+      display(nullptr), context(nullptr), surface(nullptr),
+      framebuffer(0), colorBuffer(0), depthBuffer(0) {}
+
+HeadlessContext::~HeadlessContext() { destroy(); }
+
+
+#ifdef __linux__
+
+namespace {
+    bool hasExtension(const char* extensions, const char* name) {
+        if (extensions == nullptr) return false;
+        size_t length = strlen(name);
+        for (const char* found = strstr(extensions, name); found; found = strstr(found + length, name)) {
+            bool start = (found == extensions) || found[-1] == ' ';
+            bool end = found[length] == ' ' || found[length] == '\0';
+            if (start && end) return true;
+        }
+        return false;
+    }
+
+    // Display sem servidor gráfico: plataforma "surfaceless" do Mesa, ou o display padrão
+    EGLDisplay openDisplay() {
+        const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+            auto getPlatformDisplay =
+                (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+            if (getPlatformDisplay) {
+                EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+                if (display != EGL_NO_DISPLAY) return display;
+            }
+        }
+        return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+}
+
+
+bool HeadlessContext::create(int width, int height) {
+    this->width = width;
+    this->height = height;
+
+    EGLDisplay eglDisplay = openDisplay();
+    EGLint major = 0, minor = 0;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+        cerr << "Headless: falha ao inicializar a EGL" << endl;
+        return false;
+    }
+    display = eglDisplay;
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        cerr << "Headless: EGL sem suporte a OpenGL (apenas OpenGL ES?)" << endl;
+        destroy();
+        return false;
+    }
+
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(eglDisplay, configAttributes, &config, 1, &configCount) || configCount == 0) {
+        cerr << "Headless: nenhuma configuracao EGL com pbuffer e OpenGL" << endl;
+        destroy();
+        return false;
+    }
+
+    // mesma versão pedida à GLFW quando possível; 4.0 é o mínimo do projeto
+    const EGLint versions[][2] = { {4, 5}, {4, 0} };
+    EGLContext eglContext = EGL_NO_CONTEXT;
+    for (const auto& version : versions) {
+        const EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, version[0],
+            EGL_CONTEXT_MINOR_VERSION, version[1],
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttributes);
+        if (eglContext != EGL_NO_CONTEXT) break;
+    }
+    if (eglContext == EGL_NO_CONTEXT) {
+        cerr << "Headless: falha ao criar contexto OpenGL 4 core" << endl;
+        destroy();
+        return false;
+    }
+    context = eglContext;
+
+    // sem EGL_KHR_surfaceless_context o contexto precisa de uma superfície: um pbuffer mínimo,
+    // já que o desenho vai para o FBO
+    EGLSurface eglSurface = EGL_NO_SURFACE;
+    if (!hasExtension(eglQueryString(eglDisplay, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")) {
+        const EGLint pbufferAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        eglSurface = eglCreatePbufferSurface(eglDisplay, config, pbufferAttributes);
+        if (eglSurface == EGL_NO_SURFACE) {
+            cerr << "Headless: falha ao criar pbuffer" << endl;
+            destroy();
+            return false;
+        }
+        surface = eglSurface;
+    }
+
+    if (!eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext)) {
+        cerr << "Headless: falha ao ativar o contexto" << endl;
+        destroy();
+        return false;
+    }
+
+    // o FBO precisa das funções da OpenGL (carregá-las de novo em initializeOpenGL não tem efeito)
+    if (!gladLoadGLLoader((GLADloadproc)getProcAddress) || !createFramebuffer()) {
+        destroy();
+        return false;
+    }
+
+    created = true;
+    cout << "Headless: contexto EGL " << major << "." << minor
+         << (eglSurface == EGL_NO_SURFACE ? " sem superficie" : " com pbuffer")
+         << ", FBO " << width << "x" << height << endl;
+    return true;
+}
+
+
+void* HeadlessContext::getProcAddress(const char* name) {
+    return (void*)eglGetProcAddress(name);
+}
+
+
+void HeadlessContext::destroy() {
+    if (display == nullptr) return;
+
+    if (framebuffer) {
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(1, &colorBuffer);
+        glDeleteRenderbuffers(1, &depthBuffer);
+        framebuffer = colorBuffer = depthBuffer = 0;
+    }
+
+    eglMakeCurrent((EGLDisplay)display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (surface) eglDestroySurface((EGLDisplay)display, (EGLSurface)surface);
+    if (context) eglDestroyContext((EGLDisplay)display, (EGLContext)context);
+    eglTerminate((EGLDisplay)display);
+
+    display = context = surface = nullptr;
+    created = false;
+}
+
+#else
+
+bool HeadlessContext::create(int, int) {
+    cerr << "Headless: modo disponivel apenas no Linux (EGL)" << endl;
+    return false;
+}
+
+void* HeadlessContext::getProcAddress(const char*) { return nullptr; }
+
+void HeadlessContext::destroy() { created = false; }
+
+#endif
+
+
+bool HeadlessContext::createFramebuffer() {
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        cerr << "Headless: framebuffer incompleto" << endl;
+        return false;
+    }
+    return true;    // fica ligado: todos os passes desenham nele
+}
+
+
+void HeadlessContext::finishFrame() {
+    glFinish();
+}
+
+
+bool HeadlessContext::saveFrame(const string& path) const {
+    if (!created) return false;
+
+    vector<unsigned char> pixels((size_t)width * height * 3);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+    ofstream file(path, ios::binary);
+    if (!file) {
+        cerr << "Headless: falha ao gravar " << path << endl;
+        return false;
+    }
+
+    // a OpenGL lê de baixo para cima; o PPM é gravado de cima para baixo
+    file << "P6\n" << width << " " << height << "\n255\n";
+    for (int y = height - 1; y >= 0; y--) {
+        file.write((const char*)&pixels[(size_t)y * width * 3], (streamsize)width * 3);
+    }
+
+    cout << "Headless: frame final gravado em " << path << endl;
+    return true;
+}
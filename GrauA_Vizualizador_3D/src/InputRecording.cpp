@@ -0,0 +1,81 @@
+#include "InputRecording.h"
+#include <iostream>
+#include <fstream>
+
+namespace {
+    const uint32_t RECORDING_MAGIC   = 0x49524743;  // "CGRI"
+    const uint32_t RECORDING_VERSION = 1;
+
+    struct RecordingHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t frameCount;
+        uint32_t frameSize;     // sizeof(FrameInput) de quem gravou
+    };
+}
+
+
+bool InputRecording::save(const string& path) const {
+    ofstream file(path, ios::binary | ios::trunc);
+    if (!file) {
+        cerr << "Falha ao gravar entrada em " << path << endl;
+        return false;
+    }
+
+    RecordingHeader header;
+    header.magic      = RECORDING_MAGIC;
+    header.version    = RECORDING_VERSION;
+    header.frameCount = (uint32_t)frames.size();
+    header.frameSize  = sizeof(FrameInput);
+
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)frames.data(), frames.size() * sizeof(FrameInput));
+
+    cout << "Entrada de " << frames.size() << " frames gravada em " << path << endl;
+    return (bool)file;
+}
+
+
+bool InputRecording::load(const string& path) {
+    ifstream file(path, ios::binary);
+    if (!file) {
+        cerr << "Gravacao de entrada nao encontrada: " << path << endl;
+        return false;
+    }
+
+    RecordingHeader header;
+    file.read((char*)&header, sizeof(header));
+    if (!file || header.magic != RECORDING_MAGIC || header.version != RECORDING_VERSION ||
+        header.frameSize != sizeof(FrameInput)) {
+        cerr << "Gravacao de entrada invalida: " << path << endl;
+        return false;
+    }
+
+    frames.resize(header.frameCount);
+    file.read((char*)frames.data(), frames.size() * sizeof(FrameInput));
+    if (!file) {
+        cerr << "Gravacao de entrada incompleta: " << path << endl;
+        frames.clear();
+        return false;
+    }
+
+    cout << "Gravacao de entrada: " << frames.size() << " frames (" << path << ")" << endl;
+    return true;
+}
+
+
+void InputAccumulator::push(const FrameInput& input) {
+    held = input.buttons;
+    pending.buttons |= input.buttons;
+    pending.mouseX += input.mouseX;
+    pending.mouseY += input.mouseY;
+    pending.scroll += input.scroll;
+}
+
+
+FrameInput InputAccumulator::take() {
+    FrameInput input = pending;
+    pending = FrameInput();
+    pending.buttons = held;     // tecla segurada: vale também no próximo passo
+    return input;
+}
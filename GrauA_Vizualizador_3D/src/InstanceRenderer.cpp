@@ -0,0 +1,198 @@
+#include "InstanceRenderer.h"
+#include <glad/glad.h>
+#include "GLState.h"
+#include "Profiler.h"
+#include "Stats.h"
+#include <iostream>
+#include <map>
+#include <algorithm>
+
+InstanceRenderer::InstanceRenderer() : instanceGroups(0), instancedObjects(0), uploadedInstances(0) {}
+
+InstanceRenderer::~InstanceRenderer() { cleanup(); }
+
+
+// Objetos com a mesma malha (ponteiro compartilhado, ver System::loadSceneObjects)
+// e a mesma textura são reunidos em um grupo de instâncias
+bool InstanceRenderer::build(const vector<unique_ptr<OBJ3D>>& objects) {
+    PROFILE_SCOPE("InstanceRenderer::build");
+    cleanup();
+
+    map<pair<const Mesh*, unsigned int>, vector<const OBJ3D*>> candidates;
+    for (const auto& object : objects) {
+        unsigned int texture = object->hasTexture ? object->textureID : 0;
+        candidates[make_pair(object->mesh.get(), texture)].push_back(object.get());
+    }
+
+    for (auto& candidate : candidates) {
+        if (candidate.second.size() < 2) continue;  // objeto único: continua no caminho normal
+
+        InstanceBatch batch;
+        batch.mesh      = candidate.second[0]->mesh;
+        batch.textureID = candidate.first.second;
+        batch.objects   = candidate.second;
+        batch.versions.assign(batch.objects.size(), 0);
+
+        // o buffer nunca cresce: eliminações só reduzem o número de instâncias
+        vector<glm::mat4> transforms;
+        for (const OBJ3D* object : batch.objects) transforms.push_back(object->transform);
+
+        glGenBuffers(1, &batch.instanceVBO);
+        GLState::bindBuffer(GL_ARRAY_BUFFER, batch.instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, transforms.size() * sizeof(glm::mat4), transforms.data(), GL_DYNAMIC_DRAW);
+        Stats::add(STAT_GPU_MEMORY, (double)(transforms.size() * sizeof(glm::mat4)));
+
+        for (const auto& group : batch.mesh->groups) {
+            unsigned int VAO = 0;
+            if (group.VAO != 0) {
+                glGenVertexArrays(1, &VAO);
+                GLState::bindVertexArray(VAO);
+
+                // mesmo layout de atributos de Group::uploadBuffers, lido dos buffers do próprio grupo
+                GLState::bindBuffer(GL_ARRAY_BUFFER, group.VBO);
+                GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, group.EBO);
+                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+                glEnableVertexAttribArray(0);
+                glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+                glEnableVertexAttribArray(1);
+                glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(5 * sizeof(float)));
+                glEnableVertexAttribArray(2);
+
+                // matriz model por instância: 4 colunas vec4 nos locais 3 a 6
+                GLState::bindBuffer(GL_ARRAY_BUFFER, batch.instanceVBO);
+                for (int column = 0; column < 4; column++) {
+                    glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                                          (void*)(column * sizeof(glm::vec4)));
+                    glEnableVertexAttribArray(3 + column);
+                    glVertexAttribDivisor(3 + column, 1);
+                }
+            }
+            batch.VAOs.push_back(VAO);  // 0 para grupos sem geometria (mantém o índice alinhado com os grupos)
+        }
+
+        for (size_t slot = 0; slot < batch.objects.size(); slot++) {
+            batch.versions[slot] = batch.objects[slot]->transformVersion;
+            slots[batch.objects[slot]] = make_pair(batches.size(), slot);
+        }
+
+        cout << "Instancias: " << batch.objects.size() << " objetos compartilham "
+             << batch.objects[0]->modelPath << endl;
+
+        batches.push_back(move(batch));
+    }
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::bindVertexArray(0);
+
+    instanceGroups   = (unsigned int)batches.size();
+    instancedObjects = (unsigned int)slots.size();
+    uploadedInstances = 0;
+    return !batches.empty();
+}
+
+
+// Envia a matriz atual do objeto de um slot para o instance buffer
+void InstanceRenderer::uploadSlot(InstanceBatch& batch, size_t slot) {
+    const OBJ3D* object = batch.objects[slot];
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, batch.instanceVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, slot * sizeof(glm::mat4), sizeof(glm::mat4), &object->transform[0][0]);
+
+    batch.versions[slot] = object->transformVersion;
+    uploadedInstances++;
+}
+
+
+void InstanceRenderer::remove(const OBJ3D* object) {
+    auto found = slots.find(object);
+    if (found == slots.end()) return;
+
+    InstanceBatch& batch = batches[found->second.first];
+    size_t slot = found->second.second;
+    size_t last = batch.objects.size() - 1;
+    slots.erase(found);
+
+    // a última instância passa a ocupar o slot liberado
+    if (slot != last) {
+        batch.objects[slot] = batch.objects[last];
+        slots[batch.objects[slot]].second = slot;
+        uploadSlot(batch, slot);
+    }
+    batch.objects.pop_back();
+    batch.versions.pop_back();
+
+    instancedObjects--;
+    if (batch.objects.empty()) instanceGroups--;
+}
+
+
+void InstanceRenderer::update() {
+    for (auto& batch : batches) {
+        for (size_t slot = 0; slot < batch.objects.size(); slot++) {
+            if (batch.versions[slot] != batch.objects[slot]->transformVersion) {
+                uploadSlot(batch, slot);
+            }
+        }
+    }
+}
+
+
+void InstanceRenderer::enqueue(RenderQueue& queue, ShaderPermutations& shaders,
+                               const glm::vec3& cameraPos, float depthScale, bool useTextureArray) const {
+    for (const auto& batch : batches) {
+        if (batch.objects.empty()) continue;
+
+        unsigned int texture = batch.textureID;
+        int layer = -1;
+        if (texture != 0 && useTextureArray && batch.objects[0]->arrayTexture.layer >= 0) {
+            texture = batch.objects[0]->arrayTexture.arrayID;
+            layer = batch.objects[0]->arrayTexture.layer;
+        }
+
+        unsigned int features = SHADER_INSTANCED;
+        if (texture != 0) features |= SHADER_TEXTURED;
+        if (layer >= 0)   features |= SHADER_TEXTURE_ARRAY;
+
+        const Shader* shader = shaders.get(features);
+        if (shader == nullptr) continue;
+
+        // profundidade do grupo = instância mais próxima da câmera
+        float depth = 1.0f;
+        for (const OBJ3D* object : batch.objects) {
+            glm::vec3 center = glm::vec3(object->transform * glm::vec4(batch.mesh->boundingBox.center(), 1.0f));
+            depth = std::min(depth, glm::length(center - cameraPos) * depthScale);
+            queue.countNaiveObject(object->hasTexture, (unsigned int)batch.mesh->groups.size());
+        }
+
+        for (size_t i = 0; i < batch.mesh->groups.size(); i++) {
+            if (batch.VAOs[i] == 0) continue;
+
+            DrawPacket packet;
+            packet.shader        = shader;
+            packet.VAO           = batch.VAOs[i];
+            packet.indexCount    = batch.mesh->groups[i].indexCount;
+            packet.vertexCount   = batch.mesh->groups[i].vertexCount;
+            packet.instanceCount = (int)batch.objects.size();
+            packet.textureID     = texture;
+            packet.textureLayer  = layer;
+            packet.model         = glm::mat4(1.0f);
+            packet.color         = glm::vec3(0.7f, 0.7f, 0.7f);
+            packet.key = RenderQueue::makeKey(PASS_OPAQUE, shader->ID, RenderQueue::textureKey(texture, layer),
+                                              batch.VAOs[i], depth);
+
+            queue.submit(packet);
+        }
+    }
+}
+
+
+void InstanceRenderer::cleanup() {
+    for (auto& batch : batches) {
+        for (unsigned int VAO : batch.VAOs) GLState::deleteVertexArray(VAO);
+        GLState::deleteBuffer(batch.instanceVBO);
+    }
+    batches.clear();
+    slots.clear();
+    instanceGroups = 0;
+    instancedObjects = 0;
+}
@@ -0,0 +1,294 @@
+#include "JobSystem.h"
+#include "WorkStealingDeque.h"
+#include "Profiler.h"
+#include <vector>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+namespace {
+    const size_t JOB_RING_SIZE = 1024;      // jobs ainda não iniciados por thread (potência de 2)
+    const int SPIN_COUNT = 64;              // tentativas (com yield) antes de dormir
+
+    struct alignas(64) Worker {
+        WorkStealingDeque<Job, JOB_RING_SIZE> jobs;
+        Job ring[JOB_RING_SIZE];
+        size_t nextJob;
+        uint32_t random;    // escolha da primeira vítima dos roubos (xorshift)
+        thread handle;
+        atomic<bool> attached;  // vaga de thread externa ocupada (ver JobSystem::attachThread)
+
+        Worker() : nextJob(0), random(1), attached(false) {}
+    };
+
+    struct BackgroundTask {
+        function<void()> task;
+        JobCounter* counter;
+    };
+
+    vector<unique_ptr<Worker>> workers;     // [0] = thread que chamou start; no final, as vagas externas
+    unsigned int threadTotal = 1;           // thread que chamou start + threads de trabalho
+    atomic<bool> started(false);
+    atomic<bool> stopping(false);
+    thread_local int workerIndex = -1;
+
+    // threads sem trabalho dormem em "wakeUp"; quem enfileira só pega a trava se houver alguém dormindo
+    atomic<int> queuedJobs(0);
+    atomic<int> queuedBackground(0);
+    atomic<int> sleepers(0);
+    mutex sleepMutex;
+    condition_variable wakeUp;
+
+    mutex backgroundMutex;
+    deque<BackgroundTask> backgroundTasks;
+
+    void wake() {
+        if (sleepers.load() > 0) {
+            lock_guard<mutex> lock(sleepMutex);
+            wakeUp.notify_all();
+        }
+    }
+
+    void finish(JobCounter* counter) {
+        if (counter->pending.fetch_sub(1) == 1) wake();  // alguém pode estar dormindo em wait
+    }
+
+    void execute(Job* job) {
+        JobCounter* counter = job->counter;
+        job->run(*job);     // libera o slot (ver JobSystem::invoke)
+        finish(counter);
+    }
+
+    // Job da própria deque (o mais recente) ou, sem nenhum, roubado de outra thread (o mais antigo)
+    Job* takeJob(int index) {
+        Worker& self = *workers[index];
+        Job* job = self.jobs.pop();
+
+        if (!job && queuedJobs.load() > 0) {
+            self.random ^= self.random << 13;
+            self.random ^= self.random >> 17;
+            self.random ^= self.random << 5;
+            size_t count = workers.size();
+            size_t first = self.random % count;
+            for (size_t i = 0; i < count && !job; i++) {
+                size_t victim = (first + i) % count;
+                if (victim != (size_t)index) job = workers[victim]->jobs.steal();
+            }
+        }
+
+        if (job) queuedJobs.fetch_sub(1);
+        return job;
+    }
+
+    bool takeBackground(BackgroundTask& task) {
+        if (queuedBackground.load() == 0) return false;
+
+        lock_guard<mutex> lock(backgroundMutex);
+        if (backgroundTasks.empty()) return false;
+        task = move(backgroundTasks.front());
+        backgroundTasks.pop_front();
+        queuedBackground.fetch_sub(1);
+        return true;
+    }
+
+    void workerLoop(int index) {
+        workerIndex = index;
+        Profiler::setThreadName("job " + to_string(index));
+
+        int idle = 0;
+        for (;;) {
+            if (Job* job = takeJob(index)) {
+                execute(job);
+                idle = 0;
+                continue;
+            }
+            if (stopping.load()) return;
+
+            BackgroundTask background;
+            if (takeBackground(background)) {
+                background.task();
+                background.task = nullptr;  // libera as capturas antes de liberar o contador
+                finish(background.counter);
+                idle = 0;
+                continue;
+            }
+
+            if (++idle < SPIN_COUNT) {
+                this_thread::yield();
+                continue;
+            }
+
+            unique_lock<mutex> lock(sleepMutex);
+            sleepers.fetch_add(1);
+            wakeUp.wait(lock, []() {
+                return stopping.load() || queuedJobs.load() > 0 || queuedBackground.load() > 0;
+            });
+            sleepers.fetch_sub(1);
+            idle = 0;
+        }
+    }
+
+    // reserva para programas que não chamam JobSystem::stop: encerra as threads no fim do programa,
+    // depois dos objetos de main (que esperam os seus jobs). A ordem em relação aos estáticos de outros
+    // arquivos (ex.: o Log) não é definida, então main deve chamar stop
+    struct Shutdown {
+        ~Shutdown() { JobSystem::stop(); }
+    } shutdown;
+}
+
+
+void JobSystem::start(unsigned int workerCount) {
+    if (started.load()) return;
+
+    if (workerCount == 0) {
+        unsigned int cores = thread::hardware_concurrency();
+        workerCount = cores > 1 ? cores - 1 : 1;    // a thread principal é a thread 0
+    }
+
+    stopping = false;
+    workers.clear();
+    threadTotal = workerCount + 1;
+    for (unsigned int i = 0; i < threadTotal + MAX_EXTERNAL_THREADS; i++) {
+        workers.emplace_back(new Worker());
+        workers.back()->random = 0x9E3779B9u * (i + 1);
+    }
+
+    workerIndex = 0;
+    started = true;
+    for (unsigned int i = 1; i <= workerCount; i++) {
+        workers[i]->handle = thread(workerLoop, (int)i);
+    }
+}
+
+
+void JobSystem::stop() {
+    if (!started.load()) return;
+
+    {
+        lock_guard<mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (size_t i = 1; i < threadTotal; i++) workers[i]->handle.join();
+
+    started = false;
+    workerIndex = -1;
+
+    deque<BackgroundTask> discarded;
+    {
+        lock_guard<mutex> lock(backgroundMutex);
+        discarded.swap(backgroundTasks);
+        queuedBackground = 0;
+    }
+    for (auto& background : discarded) {
+        background.task = nullptr;
+        finish(background.counter);
+    }
+    workers.clear();
+}
+
+
+bool JobSystem::isStarted() {
+    return started.load();
+}
+
+
+unsigned int JobSystem::threadCount() {
+    return started.load() ? threadTotal : 1;
+}
+
+
+bool JobSystem::attachThread() {
+    if (!started.load()) return false;
+    if (workerIndex >= 0) return true;
+
+    for (size_t i = threadTotal; i < workers.size(); i++) {
+        bool expected = false;
+        if (workers[i]->attached.compare_exchange_strong(expected, true)) {
+            workerIndex = (int)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void JobSystem::detachThread() {
+    if (workerIndex < (int)threadTotal) return;    // não registrada (ou thread do próprio sistema)
+    workers[workerIndex]->attached.store(false);
+    workerIndex = -1;
+}
+
+
+void JobSystem::submitBackground(JobCounter& counter, function<void()> task) {
+    if (!started.load()) {
+        task();
+        return;
+    }
+
+    counter.pending.fetch_add(1);
+    {
+        lock_guard<mutex> lock(backgroundMutex);
+        backgroundTasks.push_back({ move(task), &counter });
+        queuedBackground.fetch_add(1);
+    }
+    wake();
+}
+
+
+void JobSystem::wait(JobCounter& counter) {
+    bool worker = workerIndex >= 0 && started.load();
+
+    int spins = 0;
+    while (counter.pending.load(memory_order_acquire) > 0) {
+        if (worker) {
+            if (Job* job = takeJob(workerIndex)) {
+                execute(job);
+                spins = 0;
+                continue;
+            }
+        }
+
+        if (++spins < SPIN_COUNT) {
+            this_thread::yield();
+            continue;
+        }
+
+        // espera longa (ex.: carregamento): dorme até o contador zerar ou chegar um job para ajudar
+        unique_lock<mutex> lock(sleepMutex);
+        sleepers.fetch_add(1);
+        wakeUp.wait(lock, [&]() { return counter.pending.load() == 0 || (worker && queuedJobs.load() > 0); });
+        sleepers.fetch_sub(1);
+        spins = 0;
+    }
+}
+
+
+Job* JobSystem::allocate() {
+    if (workerIndex < 0 || !started.load(memory_order_relaxed)) return nullptr;
+
+    Worker& self = *workers[workerIndex];
+    Job& job = self.ring[self.nextJob++ & (JOB_RING_SIZE - 1)];
+    while (!job.free.load(memory_order_acquire)) {
+        // o anel deu a volta: ajuda a executar os jobs até o que ocupa o slot começar
+        if (Job* other = takeJob(workerIndex)) execute(other);
+        else this_thread::yield();
+    }
+    job.free.store(false, memory_order_relaxed);
+    return &job;
+}
+
+
+void JobSystem::push(Job* job) {
+    queuedJobs.fetch_add(1);
+    if (!workers[workerIndex]->jobs.push(job)) {   // deque cheia: executa na hora
+        queuedJobs.fetch_sub(1);
+        execute(job);
+        return;
+    }
+    wake();
+}
@@ -0,0 +1,162 @@
+#include "LZ4Block.h"
+#include <cstring>
+#include <cstdint>
+
+namespace {
+    const size_t MIN_MATCH     = 4;     // cópia mais curta que vale uma sequência
+    const size_t LAST_LITERALS = 5;     // o bloco termina com pelo menos 5 literais (regra do formato)
+    const size_t MATCH_LIMIT   = 12;    // a última cópia começa pelo menos 12 bytes antes do fim
+    const size_t MAX_OFFSET    = 65535;
+    const int    HASH_BITS     = 16;
+
+    inline uint32_t read32(const unsigned char* p) {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t hashSequence(uint32_t sequence) {
+        return (sequence * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    // Comprimento >= 15: o restante em bytes de 255 e um byte final < 255
+    void writeLength(vector<unsigned char>& output, size_t length) {
+        for (; length >= 255; length -= 255) output.push_back(255);
+        output.push_back((unsigned char)length);
+    }
+
+    void writeSequence(vector<unsigned char>& output, const unsigned char* literals, size_t literalCount,
+                       size_t offset, size_t matchLength) {
+        size_t matchCode = matchLength - MIN_MATCH;
+        unsigned char token = (unsigned char)((literalCount < 15 ? literalCount : 15) << 4);
+        if (matchLength > 0) token |= (unsigned char)(matchCode < 15 ? matchCode : 15);
+        output.push_back(token);
+
+        if (literalCount >= 15) writeLength(output, literalCount - 15);
+        output.insert(output.end(), literals, literals + literalCount);
+
+        if (matchLength == 0) return;   // última sequência: só literais
+        output.push_back((unsigned char)(offset & 0xFF));
+        output.push_back((unsigned char)(offset >> 8));
+        if (matchCode >= 15) writeLength(output, matchCode - 15);
+    }
+
+    // Lê a continuação de um comprimento (bytes de 255 até o primeiro menor); false se passar do fim
+    bool readLength(const unsigned char*& input, const unsigned char* end, size_t& length) {
+        unsigned char byte;
+        do {
+            if (input >= end) return false;
+            byte = *input++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+}
+
+
+size_t LZ4Block::maxCompressedSize(size_t size) {
+    return size + size / 255 + 16;
+}
+
+
+size_t LZ4Block::compress(const unsigned char* input, size_t size, vector<unsigned char>& output) {
+    output.clear();
+    output.reserve(maxCompressedSize(size));
+
+    // entrada vazia (input pode ser nulo): o bloco é só o token da última sequência, sem literais
+    if (size == 0) {
+        output.push_back(0);
+        return output.size();
+    }
+
+    size_t anchor = 0;  // início dos literais ainda não escritos
+    if (size > MATCH_LIMIT) {
+        vector<int64_t> table((size_t)1 << HASH_BITS, -1);  // última posição de cada hash de 4 bytes
+        size_t limit = size - MATCH_LIMIT;
+        size_t matchEndLimit = size - LAST_LITERALS;
+
+        size_t position = 0;
+        while (position < limit) {
+            uint32_t sequence = read32(input + position);
+            uint32_t slot = hashSequence(sequence);
+            int64_t candidate = table[slot];
+            table[slot] = (int64_t)position;
+
+            if (candidate < 0 || position - (size_t)candidate > MAX_OFFSET ||
+                read32(input + candidate) != sequence) {
+                position++;
+                continue;
+            }
+
+            size_t reference = (size_t)candidate;
+            size_t end = position + MIN_MATCH;
+            while (end < matchEndLimit && input[end] == input[reference + (end - position)]) end++;
+
+            // estende a cópia para trás sobre os literais pendentes
+            while (position > anchor && reference > 0 && input[position - 1] == input[reference - 1]) {
+                position--;
+                reference--;
+            }
+
+            writeSequence(output, input + anchor, position - anchor, position - reference, end - position);
+            position = anchor = end;
+        }
+    }
+
+    writeSequence(output, input + anchor, size - anchor, 0, 0);
+    return output.size();
+}
+
+
+bool LZ4Block::decompress(const unsigned char* input, size_t size, unsigned char* output, size_t outputSize) {
+    const unsigned char* end = input + size;
+    unsigned char* out = output;
+    unsigned char* outEnd = output + outputSize;
+
+    // saída vazia (output pode ser nulo, como o data() de um vector vazio): só o bloco de compress com 0 bytes
+    if (outputSize == 0) return size == 1 && input[0] == 0;
+
+    while (input < end) {
+        unsigned char token = *input++;
+
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !readLength(input, end, literalCount)) return false;
+        if (literalCount > (size_t)(end - input) || literalCount > (size_t)(outEnd - out)) return false;
+        // sequências curtas (a maioria): cópia fixa de 16 bytes, que o compilador faz sem chamar memcpy;
+        // o excesso é sobrescrito pelo que vem depois
+        if (literalCount <= 16 && end - input >= 16 && outEnd - out >= 16) memcpy(out, input, 16);
+        else memcpy(out, input, literalCount);
+        input += literalCount;
+        out += literalCount;
+
+        if (input == end) break;    // última sequência: só literais
+
+        if (end - input < 2) return false;
+        size_t offset = input[0] | (input[1] << 8);
+        input += 2;
+        if (offset == 0 || offset > (size_t)(out - output)) return false;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(input, end, matchLength)) return false;
+        matchLength += MIN_MATCH;
+        if (matchLength > (size_t)(outEnd - out)) return false;
+
+        // a cópia pode sobrepor o que ela mesma escreve (offset < comprimento): em blocos de 8 bytes
+        // enquanto cada bloco lê só o que já foi escrito, byte a byte no resto
+        const unsigned char* match = out - offset;
+        size_t i = 0;
+        if (matchLength <= 16 && offset >= 16 && outEnd - out >= 16) {
+            memcpy(out, match, 16);
+            i = matchLength;
+        } else if (offset >= matchLength) {
+            memcpy(out, match, matchLength);
+            i = matchLength;
+        } else if (offset >= 8) {
+            for (; i + 8 <= matchLength; i += 8) memcpy(out + i, match + i, 8);
+        }
+        for (; i < matchLength; i++) out[i] = match[i];
+        out += matchLength;
+    }
+
+    return out == outEnd;
+}
@@ -0,0 +1,258 @@
+#include "Log.h"
+#include "Profiler.h"
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <sstream>
+#include <algorithm>
+
+namespace {
+    const size_t RING_SIZE = 512;           // registros por thread ainda não escritos (potência de 2)
+    const int DRAIN_INTERVAL_MS = 5;        // a thread de fundo recolhe os anéis neste intervalo
+    const int64_t RATE_WINDOW = 1000000000; // janela do limite de frequência (1 s, em ns)
+
+    // Anel de uma thread: só ela avança "tail" (escreve) e só quem esvazia avança "head" (sob drainMutex)
+    struct LogRing {
+        LogRecord records[RING_SIZE];
+        alignas(64) atomic<uint64_t> head;
+        alignas(64) atomic<uint64_t> tail;
+        atomic<uint64_t> dropped;
+
+        LogRing() : head(0), tail(0), dropped(0) {}
+    };
+
+    // Anéis de todas as threads que já registraram mensagens (continuam aqui depois que a thread termina)
+    mutex registryMutex;
+    vector<unique_ptr<LogRing>> registry;
+    thread_local LogRing* threadRing = nullptr;
+
+    thread_local LogRecord localRecord;     // sem start: montado e escrito na hora
+
+    atomic<LogSite*> sites(nullptr);        // pontos de chamada já executados
+
+    ostream* outputStream = &cout;
+    ostream* errorStream = &cerr;
+
+    thread writer;
+    atomic<bool> started(false);
+    atomic<bool> stopping(false);
+    atomic<bool> stopped(false);            // Log::stop já rodou (ex.: no fim de main): Shutdown não repete
+    mutex wakeMutex;
+    condition_variable wakeUp;
+
+    mutex drainMutex;
+    vector<LogRecord> batch;                // reaproveitado entre os lotes (sob drainMutex)
+    ostringstream outputText, errorText;
+
+    LogRing* createRing() {
+        unique_ptr<LogRing> ring(new LogRing());
+        lock_guard<mutex> lock(registryMutex);
+        registry.push_back(move(ring));
+        return registry.back().get();
+    }
+
+    bool isError(LogLevel level) { return level >= LOG_LEVEL_WARNING; }
+
+    // Monta a linha: cada "{}" do formato recebe o próximo argumento (os que faltam ficam como "{}")
+    void format(ostream& out, const LogRecord& record) {
+        const char* text = record.site->format;
+        int arg = 0;
+        for (; *text; text++) {
+            if (text[0] == '{' && text[1] == '}' && arg < record.argCount) {
+                switch (record.types[arg]) {
+                    case LogRecord::ARG_INT:    out << record.values[arg].i; break;
+                    case LogRecord::ARG_UINT:   out << record.values[arg].u; break;
+                    case LogRecord::ARG_DOUBLE: out << record.values[arg].d; break;
+                    case LogRecord::ARG_TEXT:   out << record.text + record.values[arg].text; break;
+                }
+                arg++;
+                text++;
+            } else {
+                out << *text;
+            }
+        }
+        out << '\n';
+    }
+
+    // Linhas das mensagens suprimidas pelo limite, uma por ponto quando a janela termina (todas, no final)
+    void reportSuppressed(int64_t time, bool all) {
+        for (LogSite* site = sites.load(memory_order_acquire); site; site = site->next) {
+            if (site->suppressed.load(memory_order_relaxed) == 0) continue;
+            int64_t windowStart = site->windowStart.load(memory_order_relaxed);
+            if (!all && windowStart == site->reportedWindow && time - windowStart < RATE_WINDOW) continue;
+            site->reportedWindow = windowStart;
+
+            uint32_t count = site->suppressed.exchange(0, memory_order_relaxed);
+            if (count == 0) continue;
+            ostream& out = isError(site->level) ? errorText : outputText;
+            out << "(" << count << " mensagens suprimidas: " << site->format << ")\n";
+        }
+    }
+
+    // Esvazia os anéis e escreve o lote na ordem em que as mensagens foram registradas
+    void drain(bool final) {
+        lock_guard<mutex> drainLock(drainMutex);
+
+        batch.clear();
+        {
+            lock_guard<mutex> lock(registryMutex);
+            for (auto& ring : registry) {
+                uint64_t head = ring->head.load(memory_order_relaxed);
+                uint64_t tail = ring->tail.load(memory_order_acquire);
+                for (; head != tail; head++) batch.push_back(ring->records[head & (RING_SIZE - 1)]);
+                ring->head.store(head, memory_order_release);
+            }
+        }
+        stable_sort(batch.begin(), batch.end(),
+                    [](const LogRecord& a, const LogRecord& b) { return a.time < b.time; });
+
+        outputText.str("");
+        errorText.str("");
+        for (const LogRecord& record : batch) format(isError(record.site->level) ? errorText : outputText, record);
+        reportSuppressed(Log::now(), final);
+
+        // um flush por lote em cada saída
+        if (outputText.tellp() > 0) {
+            *outputStream << outputText.str();
+            outputStream->flush();
+        }
+        if (errorText.tellp() > 0) {
+            *errorStream << errorText.str();
+            errorStream->flush();
+        }
+    }
+
+    void writerLoop() {
+        Profiler::setThreadName("log");
+
+        unique_lock<mutex> lock(wakeMutex);
+        while (!stopping.load()) {
+            wakeUp.wait_for(lock, chrono::milliseconds(DRAIN_INTERVAL_MS), []() { return stopping.load(); });
+            lock.unlock();
+            drain(false);
+            lock.lock();
+        }
+    }
+
+    // reserva para programas que não chamam Log::stop: escreve o que ficou nos anéis no fim do programa.
+    // A ordem entre os estáticos de arquivos diferentes não é definida (e os LogSite, estáticos locais
+    // construídos depois deste objeto, já foram destruídos aqui), então main deve chamar Log::stop
+    struct Shutdown {
+        ~Shutdown() { if (!stopped.load()) Log::stop(); }
+    } shutdown;
+}
+
+
+uint32_t Log::rateLimit = 100;
+
+
+LogSite::LogSite(const char* format, LogLevel level)
+    : format(format), level(level), windowStart(Log::now()), windowCount(0), suppressed(0),
+      reportedWindow(windowStart.load()), next(nullptr) {
+    // inserção sem trava na lista (estáticos locais podem ser construídos por várias threads ao mesmo tempo)
+    LogSite* head = sites.load(memory_order_relaxed);
+    do {
+        next = head;
+    } while (!sites.compare_exchange_weak(head, this, memory_order_release, memory_order_relaxed));
+}
+
+
+void Log::start(ostream& output, ostream& errors) {
+    if (started.load()) return;
+
+    outputStream = &output;
+    errorStream = &errors;
+    stopping = false;
+    stopped = false;
+    started = true;
+    writer = thread(writerLoop);
+}
+
+
+void Log::stop() {
+    stopped = true;
+    if (!started.load()) {
+        drain(true);    // só as suprimidas: sem start as mensagens já foram escritas
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    writer.join();
+
+    started = false;
+    drain(true);
+
+    uint64_t dropped = droppedCount();
+    if (dropped > 0) *errorStream << "Log: " << dropped << " mensagens descartadas (anel cheio)" << endl;
+}
+
+
+void Log::flush() {
+    drain(false);
+}
+
+
+bool Log::isStarted() {
+    return started.load();
+}
+
+
+uint64_t Log::droppedCount() {
+    lock_guard<mutex> lock(registryMutex);
+    uint64_t dropped = 0;
+    for (auto& ring : registry) dropped += ring->dropped.load(memory_order_relaxed);
+    return dropped;
+}
+
+
+// Limite de frequência por ponto de chamada: janela de 1 s reiniciada por quem a encontrar vencida
+bool Log::admit(LogSite& site, int64_t time) {
+    if (rateLimit == 0) return true;
+
+    int64_t windowStart = site.windowStart.load(memory_order_relaxed);
+    if (time - windowStart >= RATE_WINDOW &&
+        site.windowStart.compare_exchange_strong(windowStart, time, memory_order_relaxed)) {
+        site.windowCount.store(0, memory_order_relaxed);
+    }
+
+    if (site.windowCount.fetch_add(1, memory_order_relaxed) < rateLimit) return true;
+    site.suppressed.fetch_add(1, memory_order_relaxed);
+    return false;
+}
+
+
+LogRecord* Log::reserve() {
+    if (!started.load(memory_order_relaxed)) return &localRecord;
+
+    if (!threadRing) threadRing = createRing();
+    LogRing& ring = *threadRing;
+
+    uint64_t tail = ring.tail.load(memory_order_relaxed);
+    if (tail - ring.head.load(memory_order_acquire) >= RING_SIZE) {
+        ring.dropped.fetch_add(1, memory_order_relaxed);
+        return nullptr;
+    }
+    return &ring.records[tail & (RING_SIZE - 1)];
+}
+
+
+void Log::commit(LogRecord* record) {
+    if (record == &localRecord) {
+        ostringstream line;
+        format(line, *record);
+        ostream& out = isError(record->site->level) ? *errorStream : *outputStream;
+        out << line.str();
+        out.flush();
+        return;
+    }
+
+    // o registro fica visível para quem esvazia o anel só depois de preenchido
+    LogRing& ring = *threadRing;
+    ring.tail.store(ring.tail.load(memory_order_relaxed) + 1, memory_order_release);
+}
@@ -1,6 +1,8 @@
 #include "Mesh.h"
 #include "OBJReader.h"
+#include "AssetPack.h"
 #include "Shader.h"
+#include "Log.h"
 #include <iostream>
 #include <algorithm>
 #include <cfloat>
@@ -32,11 +34,43 @@ bool Mesh::readObjectModel(string& path) {
     return true;
 }
 
+bool Mesh::readObjectData(const string& path) {
+    if (!OBJReader::readFileOBJ(path, vertices, texCoords, normals, groups)) {
+        return false;
+    }
+
+    calculateBoundingBox();
+
+    for (auto& group : groups) { group.buildVertexData(vertices, texCoords, normals); }
+
+    return true;
+}
+
+bool Mesh::readObjectData(const string& path, const vector<unsigned char>& contents) {
+    MemoryStreamBuffer buffer;
+    buffer.set(contents.data(), contents.size());
+    istream objFile(&buffer);
+    if (!OBJReader::readOBJ(objFile, path, vertices, texCoords, normals, groups)) {
+        return false;
+    }
+
+    calculateBoundingBox();
+
+    for (auto& group : groups) { group.buildVertexData(vertices, texCoords, normals); }
+
+    return true;
+}
+
+// Envia para a OpenGL os vértices e índices gerados por readObjectData
+void Mesh::uploadBuffers() {
+    for (auto& group : groups) { group.uploadBuffers(); }
+}
+
 // Configura buffers OpenGL (VBOs, VAOs) para cada grupo da malha
 void Mesh::setupBuffers() {
     for (auto& group : groups) { group.setupBuffers(vertices, texCoords, normals);}
 
-    cout << "Buffers OpenGL configurados" << endl;
+    LOG_INFO("Buffers OpenGL configurados");
 }
 
 // Renderiza a malha chamando render() de cada grupo
@@ -0,0 +1,178 @@
+#include "MipChain.h"
+#include "Profiler.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    const float KAISER_WIDTH = 3.0f;    // raio do filtro, em texels do nível de destino
+    const float KAISER_ALPHA = 4.0f;    // forma da janela (maior = menos ondulação, menos nitidez)
+    const float PI = 3.14159265358979f;
+
+    // Função de Bessel modificada de ordem 0 (série de potências)
+    float besselI0(float x) {
+        float sum = 1.0f, term = 1.0f;
+        for (int k = 1; k < 32 && term > sum * 1e-7f; k++) {
+            float half = x / (2.0f * k);
+            term *= half * half;
+            sum += term;
+        }
+        return sum;
+    }
+
+    float sinc(float x) {
+        if (std::fabs(x) < 1e-5f) return 1.0f;
+        return std::sin(PI * x) / (PI * x);
+    }
+
+    float kaiser(float t) {
+        if (std::fabs(t) >= KAISER_WIDTH) return 0.0f;
+        float ratio = t / KAISER_WIDTH;
+        return sinc(t) * besselI0(KAISER_ALPHA * std::sqrt(1.0f - ratio * ratio)) / besselI0(KAISER_ALPHA);
+    }
+
+    int wrap(int index, int size) {
+        index %= size;
+        return index < 0 ? index + size : index;
+    }
+}
+
+
+int MipChain::levelCount(int width, int height) {
+    int levels = 1;
+    for (int size = std::max(width, height); size > 1; size /= 2) levels++;
+    return levels;
+}
+
+
+void MipChain::build(const unsigned char* data, int width, int height, int channels, MipFilter filter,
+                     vector<MipLevel>& levels) {
+    levels.clear();
+    if (filter == MIP_FILTER_GPU || data == nullptr) return;
+    PROFILE_SCOPE("MipChain::build");
+
+    levels.resize(levelCount(width, height) - 1);
+    for (auto& level : levels) {
+        downsample(data, width, height, channels, filter, level);
+        data = level.pixels.data();
+        width = level.width;
+        height = level.height;
+    }
+}
+
+
+void MipChain::computeTaps(int sourceSize, int destinationSize, MipFilter filter, vector<Taps>& taps) {
+    float scale = (float)sourceSize / destinationSize;  // texels de origem por texel de destino
+    taps.assign(destinationSize, Taps());
+
+    for (int x = 0; x < destinationSize; x++) {
+        Taps& tap = taps[x];
+        float sum = 0.0f;
+
+        if (filter == MIP_FILTER_BOX) {
+            // fração de cada texel de origem dentro do intervalo coberto pelo texel de destino
+            float start = x * scale, end = (x + 1) * scale;
+            tap.first = (int)std::floor(start);
+            for (int i = tap.first; i < (int)std::ceil(end); i++) {
+                float weight = std::min(end, i + 1.0f) - std::max(start, (float)i);
+                tap.weights.push_back(weight);
+                sum += weight;
+            }
+        } else {
+            // filtro avaliado no centro de cada texel de origem, em unidades do nível de destino
+            float center = (x + 0.5f) * scale;
+            float radius = KAISER_WIDTH * scale;
+            tap.first = (int)std::floor(center - radius);
+            for (int i = tap.first; i < (int)std::ceil(center + radius); i++) {
+                float weight = kaiser((i + 0.5f - center) / scale);
+                tap.weights.push_back(weight);
+                sum += weight;
+            }
+        }
+
+        for (float& weight : tap.weights) weight /= sum;
+    }
+}
+
+
+void MipChain::downsample(const unsigned char* source, int width, int height, int channels, MipFilter filter,
+                          MipLevel& level) {
+    level.width = std::max(1, width / 2);
+    level.height = std::max(1, height / 2);
+
+    // caso comum (dimensões pares): a caixa é a média de 2x2 texels, sem tabela de pesos
+    if (filter == MIP_FILTER_BOX && width % 2 == 0 && height % 2 == 0) {
+        size_t sourceRow = (size_t)width * channels;
+        level.pixels.resize((size_t)level.width * level.height * channels);
+        unsigned char* output = level.pixels.data();
+
+        for (int y = 0; y < level.height; y++) {
+            const unsigned char* top = source + (size_t)2 * y * sourceRow;
+            const unsigned char* bottom = top + sourceRow;
+            for (int x = 0; x < level.width; x++, top += 2 * channels, bottom += 2 * channels) {
+                for (int c = 0; c < channels; c++) {
+                    int sum = top[c] + top[channels + c] + bottom[c] + bottom[channels + c];
+                    *output++ = (unsigned char)((sum + 2) / 4);
+                }
+            }
+        }
+        return;
+    }
+
+    vector<Taps> columns, rows;
+    computeTaps(width, level.width, filter, columns);
+    computeTaps(height, level.height, filter, rows);
+
+    // linhas: width x height -> level.width x height (em float, para não arredondar duas vezes)
+    vector<float> horizontal((size_t)level.width * height * channels);
+    for (int y = 0; y < height; y++) {
+        const unsigned char* row = source + (size_t)y * width * channels;
+        float* output = &horizontal[(size_t)y * level.width * channels];
+
+        for (int x = 0; x < level.width; x++) {
+            const Taps& tap = columns[x];
+            float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            for (size_t i = 0; i < tap.weights.size(); i++) {
+                const unsigned char* texel = row + (size_t)wrap(tap.first + (int)i, width) * channels;
+                for (int c = 0; c < channels; c++) sum[c] += tap.weights[i] * texel[c];
+            }
+            for (int c = 0; c < channels; c++) output[x * channels + c] = sum[c];
+        }
+    }
+
+    // colunas: level.width x height -> level.width x level.height
+    size_t rowSize = (size_t)level.width * channels;
+    level.pixels.assign(rowSize * level.height, 0);
+    vector<float> sum(rowSize);
+
+    for (int y = 0; y < level.height; y++) {
+        const Taps& tap = rows[y];
+        std::fill(sum.begin(), sum.end(), 0.0f);
+        for (size_t i = 0; i < tap.weights.size(); i++) {
+            const float* row = &horizontal[(size_t)wrap(tap.first + (int)i, height) * rowSize];
+            for (size_t j = 0; j < rowSize; j++) sum[j] += tap.weights[i] * row[j];
+        }
+
+        unsigned char* output = &level.pixels[y * rowSize];
+        for (size_t j = 0; j < rowSize; j++) {
+            output[j] = (unsigned char)std::min(255.0f, std::max(0.0f, sum[j] + 0.5f));    // o Kaiser pode passar de 0..255
+        }
+    }
+}
+
+
+const char* MipChain::filterName(MipFilter filter) {
+    switch (filter) {
+        case MIP_FILTER_BOX:    return "box";
+        case MIP_FILTER_KAISER: return "kaiser";
+        default:                return "gpu";
+    }
+}
+
+
+bool MipChain::parseFilter(const string& name, MipFilter& filter) {
+    if (name == "gpu")         filter = MIP_FILTER_GPU;
+    else if (name == "box")    filter = MIP_FILTER_BOX;
+    else if (name == "kaiser") filter = MIP_FILTER_KAISER;
+    else return false;
+    return true;
+}
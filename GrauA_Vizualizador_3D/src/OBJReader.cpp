@@ -1,4 +1,6 @@
 #include "OBJReader.h"
+#include "AssetPack.h"
+#include "Profiler.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -14,14 +16,29 @@ bool OBJReader::readFileOBJ(const string& path,
                             vector<glm::vec2>& texCoords,
                             vector<glm::vec3>& normals,
                             vector<Group>& groups)          {
+    PROFILE_SCOPE("OBJReader::readFileOBJ");
 
-    ifstream objFile(path);    // Abre o arquivo OBJ para leitura
+    AssetStream objFile(path); // Abre o arquivo OBJ para leitura (do pacote montado ou do disco)
 
     if (!objFile.is_open()) {  // Debug
         cerr << "Falha ao abrir arquivo OBJ: " << path << endl;
         return false;
     }
-    
+
+    bool result = readOBJ(objFile, path, vertices, texCoords, normals, groups);
+
+    objFile.close();    // Fecha o arquivo .obj
+
+    return result;
+}
+
+// Interpreta o conteúdo de um OBJ já aberto (arquivo, pacote ou memória - ver Mesh::readObjectData)
+bool OBJReader::readOBJ(istream& objFile,
+                        const string& path,
+                        vector<glm::vec3>& vertices,
+                        vector<glm::vec2>& texCoords,
+                        vector<glm::vec3>& normals,
+                        vector<Group>& groups)          {
     vertices.clear();
     texCoords.clear();
     normals.clear();
@@ -77,8 +94,6 @@ bool OBJReader::readFileOBJ(const string& path,
         }
     }
 
-    objFile.close();    // Fecha o arquivo .obj
-
     return true;
 }
 
@@ -1,58 +1,93 @@
 #include "OBJ3D.h"
+#include "Log.h"
 #include <iostream>
 
 OBJ3D::OBJ3D() 
-    : transform(1.0f), 
+    : mesh(make_shared<Mesh>()),
+      transform(1.0f), 
       position (0.0f), 
       rotation (0.0f), 
       scale    (1.0f), 
       eliminable(true), 
       name(""),
       textureID(0),
-      hasTexture(false)
+      hasTexture(false),
+      transformVersion(0)
     { updateTransform(); }
 
 OBJ3D::OBJ3D(string& objName)
-    : transform(1.0f),
+    : mesh(make_shared<Mesh>()),
+      transform(1.0f),
       position (0.0f),
       rotation (0.0f),
       scale    (1.0f),
       eliminable(true),
       name(objName),
       textureID(0),
-      hasTexture(false)
+      hasTexture(false),
+      transformVersion(0)
     { updateTransform(); }
 
-OBJ3D::~OBJ3D() { mesh.cleanup(); }
+OBJ3D::~OBJ3D() {}  // a malha é liberada quando o último objeto que a compartilha é destruído
 
 bool OBJ3D::loadObject(string& path) {
 
-    if (!mesh.readObjectModel(path)) {
-        cerr << "Falha ao carregar arquivo OBJ: " << path << endl;
+    modelPath = path;
+
+    if (!mesh->readObjectModel(path)) {
+        LOG_ERROR("Falha ao carregar arquivo OBJ: {}", path);
         return false;
     }
 
-    cout << "Arquivo OBJ3D \"" << name << "\" carregado com sucesso de: " << path << endl;
+    LOG_INFO("Arquivo OBJ3D \"{}\" carregado com sucesso de: {}", name, path);
     return true;
 }
 
-void OBJ3D::render(const Shader& shader) const {
-    shader.setMat4("model", transform);
-    
-    // Set texture uniforms
-    if (hasTexture) {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        shader.setBool("hasDiffuseMap", true);
-        shader.setInt("diffuseMap", 0);
-    } else {
-        shader.setBool("hasDiffuseMap", false);
+void OBJ3D::setMesh(const shared_ptr<Mesh>& sharedMesh, const string& path) {
+    mesh = sharedMesh;
+    modelPath = path;
+}
+
+void OBJ3D::enqueue(RenderQueue& queue, ShaderPermutations& shaders, const glm::vec3& cameraPos, float depthScale,
+                    bool useTextureArray) const {
+    unsigned int texture = hasTexture ? textureID : 0;
+    int layer = -1;
+    if (hasTexture && useTextureArray && arrayTexture.layer >= 0) {
+        texture = arrayTexture.arrayID;
+        layer = arrayTexture.layer;
     }
-    
-    // Set default object color
-    shader.setVec3("objectColor", glm::vec3(0.7f, 0.7f, 0.7f));
-    
-    mesh.render(shader);
+
+    unsigned int features = 0;
+    if (hasTexture) features |= SHADER_TEXTURED;
+    if (layer >= 0) features |= SHADER_TEXTURE_ARRAY;
+
+    const Shader* shader = shaders.get(features);
+    if (shader == nullptr) return;
+
+    // distância do centro da bounding box até a câmera, usada para ordenar do mais próximo ao mais distante
+    glm::vec3 center = glm::vec3(transform * glm::vec4(mesh->boundingBox.center(), 1.0f));
+    float depth = glm::length(center - cameraPos) * depthScale;
+
+    for (const auto& group : mesh->groups) {
+        if (group.VAO == 0) continue;
+
+        DrawPacket packet;
+        packet.shader      = shader;
+        packet.VAO         = group.VAO;
+        packet.indexCount  = group.indexCount;
+        packet.vertexCount = group.vertexCount;
+        packet.instanceCount = 0;
+        packet.textureID   = texture;
+        packet.textureLayer = layer;
+        packet.model       = transform;
+        packet.color       = glm::vec3(0.7f, 0.7f, 0.7f);
+        packet.key = RenderQueue::makeKey(PASS_OPAQUE, shader->ID, RenderQueue::textureKey(texture, layer),
+                                          group.VAO, depth);
+
+        queue.submit(packet);
+    }
+
+    queue.countNaiveObject(hasTexture, (unsigned int)mesh->groups.size());
 }
 
 void OBJ3D::setPosition(const glm::vec3& pos) {
@@ -75,13 +110,15 @@ void OBJ3D::setEliminable(bool canEliminate) {
 }
 
 void OBJ3D::setTexture(const string& texturePath) {
+    this->texturePath = texturePath;
+
     if (!texturePath.empty()) {
         textureID = Texture::loadTexture(texturePath);
         hasTexture = (textureID != 0);
         if (hasTexture) {
-            cout << "Textura carregada para objeto \"" << name << "\": " << texturePath << endl;
+            LOG_INFO("Textura carregada para objeto \"{}\": {}", name, texturePath);
         } else {
-            cerr << "Falha ao carregar textura para objeto \"" << name << "\": " << texturePath << endl;
+            LOG_ERROR("Falha ao carregar textura para objeto \"{}\": {}", name, texturePath);
         }
     } else {
         hasTexture = false;
@@ -89,6 +126,12 @@ void OBJ3D::setTexture(const string& texturePath) {
     }
 }
 
+void OBJ3D::setTexture(const string& texturePath, unsigned int sharedTextureID) {
+    this->texturePath = texturePath;
+    textureID = sharedTextureID;
+    hasTexture = (textureID != 0);
+}
+
 void OBJ3D::translate(const glm::vec3& offset) {
     position += offset;
     updateTransform();
@@ -122,6 +165,8 @@ void OBJ3D::updateTransform() {
     
     // Aplica escala
     transform = glm::scale(transform, scale);
+
+    transformVersion++; // avisa quem guarda cópias da matriz (ex.: instâncias) que ela mudou
 }
 
 
@@ -131,14 +176,14 @@ BoundingBox OBJ3D::getTransformedBoundingBox() const {
 
     // Transforma todos os 8 cantos da caixa delimitadora
     glm::vec3 corners[8] = {
-        mesh.boundingBox.min,
-        glm::vec3(mesh.boundingBox.max.x, mesh.boundingBox.min.y, mesh.boundingBox.min.z),
-        glm::vec3(mesh.boundingBox.min.x, mesh.boundingBox.max.y, mesh.boundingBox.min.z),
-        glm::vec3(mesh.boundingBox.min.x, mesh.boundingBox.min.y, mesh.boundingBox.max.z),
-        glm::vec3(mesh.boundingBox.max.x, mesh.boundingBox.max.y, mesh.boundingBox.min.z),
-        glm::vec3(mesh.boundingBox.max.x, mesh.boundingBox.min.y, mesh.boundingBox.max.z),
-        glm::vec3(mesh.boundingBox.min.x, mesh.boundingBox.max.y, mesh.boundingBox.max.z),
-        mesh.boundingBox.max
+        mesh->boundingBox.min,
+        glm::vec3(mesh->boundingBox.max.x, mesh->boundingBox.min.y, mesh->boundingBox.min.z),
+        glm::vec3(mesh->boundingBox.min.x, mesh->boundingBox.max.y, mesh->boundingBox.min.z),
+        glm::vec3(mesh->boundingBox.min.x, mesh->boundingBox.min.y, mesh->boundingBox.max.z),
+        glm::vec3(mesh->boundingBox.max.x, mesh->boundingBox.max.y, mesh->boundingBox.min.z),
+        glm::vec3(mesh->boundingBox.max.x, mesh->boundingBox.min.y, mesh->boundingBox.max.z),
+        glm::vec3(mesh->boundingBox.min.x, mesh->boundingBox.max.y, mesh->boundingBox.max.z),
+        mesh->boundingBox.max
     };
     
     for (int i = 0; i < 8; i++) {
@@ -160,5 +205,5 @@ bool OBJ3D::rayIntersect(const glm::vec3& rayOrigin, const glm::vec3& rayDirecti
     glm::vec4 localDirection = invTransform * glm::vec4(rayDirection, 0.0f); // direção do raio no espaço do objeto
     
     // verifica interseção com a bounding box da malha no espaço do objeto
-    return mesh.rayIntersect(glm::vec3(localOrigin), glm::normalize(glm::vec3(localDirection)), distance);
+    return mesh->rayIntersect(glm::vec3(localOrigin), glm::normalize(glm::vec3(localDirection)), distance);
 }
\ No newline at end of file
@@ -0,0 +1,423 @@
+#include "PerfOverlay.h"
+#include "Stats.h"
+#include "GLState.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+#include <cstdio>
+#include <algorithm>
+
+namespace {
+    // Fonte bitmap 5x7: uma linha por byte, de cima para baixo; bit 4 = pixel mais à esquerda.
+    // Caracteres ASCII 32..95 (minúsculas são desenhadas como maiúsculas); os ausentes ficam em branco.
+    struct Glyph {
+        char character;
+        unsigned char rows[7];
+    };
+
+    const Glyph font[] = {
+        { ' ', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },
+        { '%', { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 } },
+        { '(', { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 } },
+        { ')', { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 } },
+        { '+', { 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 } },
+        { ',', { 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 } },
+        { '-', { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 } },
+        { '.', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C } },
+        { '/', { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 } },
+        { '0', { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E } },
+        { '1', { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+        { '2', { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F } },
+        { '3', { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E } },
+        { '4', { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 } },
+        { '5', { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E } },
+        { '6', { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E } },
+        { '7', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 } },
+        { '8', { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E } },
+        { '9', { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C } },
+        { ':', { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 } },
+        { '<', { 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02 } },
+        { '=', { 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 } },
+        { '>', { 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08 } },
+        { 'A', { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+        { 'B', { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E } },
+        { 'C', { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E } },
+        { 'D', { 0x1E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x1E } },
+        { 'E', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F } },
+        { 'F', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 } },
+        { 'G', { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F } },
+        { 'H', { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+        { 'I', { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+        { 'J', { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C } },
+        { 'K', { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 } },
+        { 'L', { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F } },
+        { 'M', { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 } },
+        { 'N', { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 } },
+        { 'O', { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+        { 'P', { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 } },
+        { 'Q', { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D } },
+        { 'R', { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 } },
+        { 'S', { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E } },
+        { 'T', { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 } },
+        { 'U', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+        { 'V', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 } },
+        { 'W', { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A } },
+        { 'X', { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 } },
+        { 'Y', { 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04 } },
+        { 'Z', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F } },
+        { '[', { 0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E } },
+        { ']', { 0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E } },
+        { '_', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F } },
+    };
+
+    const int CELL = 8;                 // cada caractere ocupa uma célula 8x8 do atlas
+    const int ATLAS_COLUMNS = 16;
+    const int ATLAS_ROWS = 5;           // 4 linhas de caracteres + a célula sólida (índice 64)
+    const int ATLAS_WIDTH = CELL * ATLAS_COLUMNS;
+    const int ATLAS_HEIGHT = CELL * ATLAS_ROWS;
+    const int SOLID_CELL = 64;
+    static_assert(SOLID_CELL < ATLAS_COLUMNS * ATLAS_ROWS, "a celula solida precisa caber no atlas");
+
+    const float SCALE = 2.0f;           // pixels de tela por pixel da fonte
+    const float CHAR_ADVANCE = 6.0f * SCALE;
+    const float LINE_HEIGHT = 10.0f * SCALE;
+
+    const float BUDGET_60 = 1000.0f / 60.0f;
+    const float BUDGET_30 = 1000.0f / 30.0f;
+
+    const glm::vec4 TEXT_COLOR(1.0f, 1.0f, 1.0f, 1.0f);
+    const glm::vec4 LABEL_COLOR(0.65f, 0.75f, 0.85f, 1.0f);
+    const glm::vec4 PANEL_COLOR(0.0f, 0.0f, 0.0f, 0.6f);
+    const glm::vec4 GOOD_COLOR(0.3f, 0.9f, 0.3f, 1.0f);
+    const glm::vec4 WARN_COLOR(0.95f, 0.8f, 0.2f, 1.0f);
+    const glm::vec4 BAD_COLOR(0.95f, 0.3f, 0.25f, 1.0f);
+
+    const char* vertexSource = R"(
+        #version 400 core
+        layout (location = 0) in vec2 position;
+        layout (location = 1) in vec2 texCoord;
+        layout (location = 2) in vec4 color;
+
+        out vec2 uv;
+        out vec4 vertexColor;
+
+        uniform mat4 projection;
+
+        void main() {
+            gl_Position = projection * vec4(position, 0.0, 1.0);
+            uv = texCoord;
+            vertexColor = color;
+        }
+    )";
+
+    const char* fragmentSource = R"(
+        #version 400 core
+        out vec4 FragColor;
+
+        in vec2 uv;
+        in vec4 vertexColor;
+
+        uniform sampler2D font;
+
+        void main() {
+            FragColor = vec4(vertexColor.rgb, vertexColor.a * texture(font, uv).r);
+        }
+    )";
+
+    const glm::vec4& frameColor(float ms) {
+        if (ms <= BUDGET_60) return GOOD_COLOR;
+        if (ms <= BUDGET_30) return WARN_COLOR;
+        return BAD_COLOR;
+    }
+
+    string format(const char* pattern, double value) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), pattern, value);
+        return buffer;
+    }
+
+    string megabytes(double bytes) {
+        return format("%.1f MB", bytes / (1024.0 * 1024.0));
+    }
+}
+
+
+const int PerfOverlay::GRAPH_SAMPLES;   // definição fora da classe: min() recebe a constante por referência
+
+
+PerfOverlay::PerfOverlay()
+    : visible(false), VAO(0), VBO(0), fontTexture(0), bufferCapacity(0),
+      historyHead(0), historyCount(0), memoryTimer(0.0), smoothedFrameMs(0.0f) {
+    fill(history, history + GRAPH_SAMPLES, 0.0f);
+}
+
+PerfOverlay::~PerfOverlay() {}     // recursos liberados em cleanup(), com o contexto ainda ativo
+
+
+bool PerfOverlay::initialize() {
+    shader.reset(new Shader());
+    if (!shader->loadFromStrings(vertexSource, fragmentSource)) {
+        cerr << "Falha ao compilar shader do overlay de desempenho" << endl;
+        shader.reset();
+        return false;
+    }
+    GLState::useProgram(shader->ID);
+    shader->setInt("font", 0);
+
+    buildFontAtlas();
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    GLState::bindVertexArray(VAO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, VBO);
+
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(4 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    GLState::bindVertexArray(0);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    Stats::add(STAT_GPU_MEMORY, ATLAS_WIDTH * ATLAS_HEIGHT);
+    return true;
+}
+
+
+// Atlas R8 com todos os caracteres da tabela e uma célula totalmente branca, usada pelos retângulos
+// (assim texto, painel e gráfico saem do mesmo shader e do mesmo draw call)
+void PerfOverlay::buildFontAtlas() {
+    vector<unsigned char> pixels(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+
+    for (const Glyph& glyph : font) {
+        int index = glyph.character - 32;
+        if (index < 0 || index >= SOLID_CELL) continue;    // fora de 32..95: não há célula no atlas
+        int cellX = (index % ATLAS_COLUMNS) * CELL;
+        int cellY = (index / ATLAS_COLUMNS) * CELL;
+        for (int row = 0; row < 7; row++) {
+            for (int column = 0; column < 5; column++) {
+                if (glyph.rows[row] & (0x10 >> column)) {
+                    pixels[(cellY + row) * ATLAS_WIDTH + cellX + column] = 255;
+                }
+            }
+        }
+    }
+
+    int solidX = (SOLID_CELL % ATLAS_COLUMNS) * CELL;
+    int solidY = (SOLID_CELL / ATLAS_COLUMNS) * CELL;
+    for (int row = 0; row < CELL; row++) {
+        fill_n(&pixels[(solidY + row) * ATLAS_WIDTH + solidX], CELL, (unsigned char)255);
+    }
+
+    glGenTextures(1, &fontTexture);
+    GLState::bindTextureUnit(0, GL_TEXTURE_2D, fontTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_WIDTH, ATLAS_HEIGHT, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+
+void PerfOverlay::recordFrame(float frameMs) {
+    history[historyHead] = frameMs;
+    historyHead = (historyHead + 1) % GRAPH_SAMPLES;
+    historyCount = min(historyCount + 1, GRAPH_SAMPLES);
+
+    // FPS suavizado para o texto não trocar a cada frame
+    smoothedFrameMs = smoothedFrameMs > 0.0f ? smoothedFrameMs * 0.9f + frameMs * 0.1f : frameMs;
+
+    memoryTimer -= frameMs / 1000.0;
+    if (memoryTimer <= 0.0) {
+        Stats::set(STAT_CPU_MEMORY, (double)Stats::processMemory());
+        memoryTimer = 0.5;
+    }
+}
+
+
+// Retângulo com dois triângulos; sem coordenadas de textura, usa o centro da célula sólida
+void PerfOverlay::addQuad(float x, float y, float w, float h, const glm::vec4& color,
+                          float u0, float v0, float u1, float v1) {
+    if (u0 < 0.0f) {
+        u0 = u1 = ((SOLID_CELL % ATLAS_COLUMNS) * CELL + CELL * 0.5f) / ATLAS_WIDTH;
+        v0 = v1 = ((SOLID_CELL / ATLAS_COLUMNS) * CELL + CELL * 0.5f) / ATLAS_HEIGHT;
+    }
+
+    const float corners[6][4] = {
+        { x,     y,     u0, v0 }, { x + w, y,     u1, v0 }, { x + w, y + h, u1, v1 },
+        { x,     y,     u0, v0 }, { x + w, y + h, u1, v1 }, { x,     y + h, u0, v1 }
+    };
+    for (const auto& corner : corners) {
+        vertices.insert(vertices.end(), { corner[0], corner[1], corner[2], corner[3],
+                                          color.r, color.g, color.b, color.a });
+    }
+}
+
+
+float PerfOverlay::addText(float x, float y, const string& text, const glm::vec4& color) {
+    for (char c : text) {
+        if (c >= 'a' && c <= 'z') c = c - 'a' + 'A';
+        if (c > 32 && c < 96) {
+            int index = c - 32;
+            float u0 = (float)((index % ATLAS_COLUMNS) * CELL) / ATLAS_WIDTH;
+            float v0 = (float)((index / ATLAS_COLUMNS) * CELL) / ATLAS_HEIGHT;
+            float u1 = u0 + 5.0f / ATLAS_WIDTH;
+            float v1 = v0 + 7.0f / ATLAS_HEIGHT;
+            addQuad(x, y, 5.0f * SCALE, 7.0f * SCALE, color, u0, v0, u1, v1);
+        }
+        x += CHAR_ADVANCE;
+    }
+    return x;
+}
+
+
+// Uma barra por frame, da mais antiga (esquerda) à mais recente; escala mínima de 33,3 ms,
+// com linhas de referência em 16,7 ms (60 FPS) e 33,3 ms (30 FPS)
+void PerfOverlay::addGraph(float x, float y, float w, float h) {
+    addQuad(x, y, w, h, PANEL_COLOR);
+
+    float maxMs = BUDGET_30 * 1.2f;
+    for (int i = 0; i < historyCount; i++) maxMs = max(maxMs, history[i]);
+
+    float barWidth = w / GRAPH_SAMPLES;
+    int first = (historyHead - historyCount + GRAPH_SAMPLES) % GRAPH_SAMPLES;
+    for (int i = 0; i < historyCount; i++) {
+        float ms = history[(first + i) % GRAPH_SAMPLES];
+        float barHeight = max(1.0f, h * ms / maxMs);
+        float barX = x + (GRAPH_SAMPLES - historyCount + i) * barWidth;
+        addQuad(barX, y + h - barHeight, max(1.0f, barWidth - 1.0f), barHeight, frameColor(ms));
+    }
+
+    addQuad(x, y + h - h * BUDGET_60 / maxMs, w, 1.0f, glm::vec4(glm::vec3(GOOD_COLOR), 0.6f));
+    addQuad(x, y + h - h * BUDGET_30 / maxMs, w, 1.0f, glm::vec4(glm::vec3(WARN_COLOR), 0.6f));
+}
+
+
+void PerfOverlay::render(int width, int height) {
+    if (!visible || !isInitialized() || width <= 0 || height <= 0) return;
+
+    vertices.clear();
+
+    const float margin = 10.0f;
+    const float padding = 8.0f;
+    const float panelWidth = 44.0f * CHAR_ADVANCE + 2.0f * padding;
+    const float graphHeight = 80.0f;
+    const bool loading = Stats::get(STAT_ASSETS_PENDING) > 0;
+    const bool streaming = Stats::get(STAT_TEXTURE_BUDGET) > 0;
+    const int lineCount = 8 + (loading ? 1 : 0) + (streaming ? 1 : 0);
+
+    float panelHeight = 2.0f * padding + lineCount * LINE_HEIGHT + graphHeight + padding;
+    addQuad(margin, margin, panelWidth, panelHeight, PANEL_COLOR);
+
+    float x = margin + padding;
+    float y = margin + padding;
+
+    float fps = smoothedFrameMs > 0.0f ? 1000.0f / smoothedFrameMs : 0.0f;
+    float after = addText(x, y, format("%.1f FPS", fps), frameColor(smoothedFrameMs));
+    addText(after + CHAR_ADVANCE, y, format("%.2f MS", Stats::get(STAT_FRAME_MS)), TEXT_COLOR);
+    y += LINE_HEIGHT;
+
+    after = addText(x, y, "CPU ", LABEL_COLOR);
+    after = addText(after, y, format("%.2f MS", Stats::get(STAT_CPU_MS)), TEXT_COLOR);
+    after = addText(after + CHAR_ADVANCE, y, "GPU ", LABEL_COLOR);
+    addText(after, y, format("%.2f MS", Stats::get(STAT_GPU_MS)), TEXT_COLOR);
+    y += LINE_HEIGHT;
+
+    after = addText(x, y, "DRAW CALLS ", LABEL_COLOR);
+    after = addText(after, y, format("%.0f", Stats::get(STAT_DRAW_CALLS)), TEXT_COLOR);
+    after = addText(after + CHAR_ADVANCE, y, "TRIANGULOS ", LABEL_COLOR);
+    addText(after, y, format("%.0f", Stats::get(STAT_TRIANGLES)), TEXT_COLOR);
+    y += LINE_HEIGHT;
+
+    after = addText(x, y, "MUDANCAS DE ESTADO ", LABEL_COLOR);
+    addText(after, y, format("%.0f", Stats::get(STAT_STATE_CHANGES)), TEXT_COLOR);
+    y += LINE_HEIGHT;
+
+    after = addText(x, y, "OBJETOS VISIVEIS ", LABEL_COLOR);
+    after = addText(after, y, format("%.0f", Stats::get(STAT_VISIBLE_OBJECTS)), TEXT_COLOR);
+    after = addText(after + CHAR_ADVANCE, y, "DESCARTADOS ", LABEL_COLOR);
+    addText(after, y, format("%.0f", Stats::get(STAT_CULLED_OBJECTS)), TEXT_COLOR);
+    y += LINE_HEIGHT;
+
+    after = addText(x, y, "PROJETEIS ", LABEL_COLOR);
+    after = addText(after, y, format("%.0f", Stats::get(STAT_PROJECTILES)), TEXT_COLOR);
+    after = addText(after + CHAR_ADVANCE, y, "TESTES DE COLISAO ", LABEL_COLOR);
+    addText(after, y, format("%.0f", Stats::get(STAT_COLLISION_TESTS)), TEXT_COLOR);
+    y += LINE_HEIGHT;
+
+    after = addText(x, y, "MEMORIA CPU ", LABEL_COLOR);
+    after = addText(after, y, megabytes(Stats::get(STAT_CPU_MEMORY)), TEXT_COLOR);
+    after = addText(after + CHAR_ADVANCE, y, "GPU ", LABEL_COLOR);
+    addText(after, y, megabytes(Stats::get(STAT_GPU_MEMORY)), TEXT_COLOR);
+    y += LINE_HEIGHT;
+
+    // carregamento assíncrono em andamento (ver AssetLoader)
+    if (loading) {
+        double loaded = Stats::get(STAT_ASSETS_LOADED);
+        double total = loaded + Stats::get(STAT_ASSETS_PENDING);
+        after = addText(x, y, "CARREGANDO ", LABEL_COLOR);
+        after = addText(after, y, format("%.0f / ", loaded) + format("%.0f", total), WARN_COLOR);
+        after = addText(after + CHAR_ADVANCE, y, "ENVIO ", LABEL_COLOR);
+        addText(after, y, megabytes(Stats::get(STAT_UPLOAD_BYTES)), TEXT_COLOR);
+        y += LINE_HEIGHT;
+    }
+
+    // streaming de texturas (ver TextureStreamer): residente / orçamento, texturas esperando níveis
+    if (streaming) {
+        double resident = Stats::get(STAT_TEXTURE_RESIDENT);
+        bool full = resident > 0.95 * Stats::get(STAT_TEXTURE_BUDGET);
+        after = addText(x, y, "TEXTURAS ", LABEL_COLOR);
+        after = addText(after, y, megabytes(resident) + " / " + megabytes(Stats::get(STAT_TEXTURE_BUDGET)),
+                        full ? WARN_COLOR : TEXT_COLOR);
+        after = addText(after + CHAR_ADVANCE, y, "PEDIDOS ", LABEL_COLOR);
+        addText(after, y, format("%.0f", Stats::get(STAT_TEXTURE_PENDING)), TEXT_COLOR);
+        y += LINE_HEIGHT;
+    }
+
+    addText(x, y, "TEMPO DE FRAME (16.7 / 33.3 MS)", LABEL_COLOR);
+    y += LINE_HEIGHT;
+
+    addGraph(x, y, panelWidth - 2.0f * padding, graphHeight);
+
+    // Envio: o buffer é realocado (orphaning) a cada frame para não esperar o draw anterior
+    GLState::bindVertexArray(VAO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, VBO);
+    size_t bytes = vertices.size() * sizeof(float);
+    if (vertices.size() > bufferCapacity) {
+        Stats::add(STAT_GPU_MEMORY, (double)(vertices.size() * 2 - bufferCapacity) * sizeof(float));
+        bufferCapacity = vertices.size() * 2;
+    }
+    glBufferData(GL_ARRAY_BUFFER, bufferCapacity * sizeof(float), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, vertices.data());
+
+    GLState::useProgram(shader->ID);
+    shader->setMat4("projection", glm::ortho(0.0f, (float)width, (float)height, 0.0f));
+    GLState::bindTextureUnit(0, GL_TEXTURE_2D, fontTexture);
+
+    GLState::setDepthTest(false);
+    GLState::setBlend(true);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(vertices.size() / 8));
+
+    GLState::setBlend(false);
+    GLState::setDepthTest(true);
+    GLState::bindVertexArray(0);
+}
+
+
+void PerfOverlay::cleanup() {
+    if (VAO != 0) {
+        GLState::deleteVertexArray(VAO);
+        GLState::deleteBuffer(VBO);
+        GLState::deleteTexture(fontTexture);
+        VAO = VBO = fontTexture = 0;
+        Stats::add(STAT_GPU_MEMORY, -(double)(ATLAS_WIDTH * ATLAS_HEIGHT + bufferCapacity * sizeof(float)));
+    }
+    bufferCapacity = 0;
+    shader.reset();
+}
@@ -0,0 +1,146 @@
+#include "Profiler.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+
+#ifdef ENABLE_PROFILER
+
+namespace {
+    // Buffers de todas as threads que já gravaram escopos (o mutex só é usado no registro e na exportação)
+    mutex registryMutex;
+    vector<unique_ptr<Profiler::ThreadBuffer>> registry;
+
+    // Referência para converter ticks em microssegundos: instante inicial nos dois relógios
+    const uint64_t startTicks = Profiler::now();
+    const chrono::steady_clock::time_point startClock = chrono::steady_clock::now();
+
+    // Linha "GPU" do trace (escrita pela thread que lê os resultados do GpuTimer)
+    Profiler::ThreadBuffer* gpuBuffer = nullptr;
+    uint64_t gpuTrackEnd = 0;
+
+    string escape(const string& text) {
+        string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+}
+
+
+bool Profiler::isCompiledIn() { return true; }
+
+
+Profiler::ThreadBuffer* Profiler::createBuffer(const string& name) {
+    unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+    buffer->written.store(0);
+    buffer->depth = 0;
+
+    lock_guard<mutex> lock(registryMutex);
+    buffer->threadIndex = (uint32_t)registry.size();
+    buffer->threadName = name.empty() ? "thread " + to_string(buffer->threadIndex) : name;
+    registry.push_back(move(buffer));
+    return registry.back().get();   // continua válido depois que a thread termina (exportação no final)
+}
+
+
+// Sem nome até setThreadName ("thread N"); main nomeia a thread principal antes de criar as demais
+Profiler::ThreadBuffer* Profiler::registerThread() {
+    return createBuffer("");
+}
+
+
+double Profiler::ticksPerMicrosecond() {
+    uint64_t ticks = now();
+    double elapsedUs = chrono::duration<double, micro>(chrono::steady_clock::now() - startClock).count();
+    return elapsedUs > 0.0 ? (double)(ticks - startTicks) / elapsedUs : 1000.0;
+}
+
+
+void Profiler::addGpuEvent(const char* name, uint64_t submitTicks, double durationMs) {
+    if (gpuBuffer == nullptr) gpuBuffer = createBuffer("GPU");
+
+    uint64_t start = max(submitTicks, gpuTrackEnd);     // passes da GPU não se sobrepõem
+    uint64_t end = start + (uint64_t)(durationMs * 1000.0 * ticksPerMicrosecond());
+    push(*gpuBuffer, name, start, end, 0);
+    gpuTrackEnd = end;
+}
+
+
+void Profiler::setThreadName(const string& name) {
+    ThreadBuffer& buffer = threadBuffer();
+    lock_guard<mutex> lock(registryMutex);
+    buffer.threadName = name;
+}
+
+
+bool Profiler::writeChromeTrace(const string& path) {
+    // ticks por microssegundo medidos entre o início do programa e agora (TSC invariante nas CPUs atuais)
+    double ticksPerUs = ticksPerMicrosecond();
+
+    ofstream file(path);
+    if (!file) {
+        cerr << "Profiler: falha ao gravar " << path << endl;
+        return false;
+    }
+
+    lock_guard<mutex> lock(registryMutex);
+
+    size_t eventCount = 0, droppedCount = 0;
+    bool first = true;
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    for (const auto& buffer : registry) {
+        if (!first) file << ",\n";
+        first = false;
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadIndex
+             << ",\"args\":{\"name\":\"" << escape(buffer->threadName) << "\"}}";
+
+        uint64_t written = buffer->written.load(memory_order_acquire);
+        uint64_t available = min<uint64_t>(written, RING_SIZE);
+        droppedCount += (size_t)(written - available);
+
+        for (uint64_t i = written - available; i < written; i++) {
+            const Event& event = buffer->events[i & (RING_SIZE - 1)];
+            double start = (double)(int64_t)(event.start - startTicks) / ticksPerUs;
+            double duration = (double)(event.end - event.start) / ticksPerUs;
+
+            file << ",\n{\"name\":\"" << escape(event.name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                 << buffer->threadIndex << ",\"ts\":" << fixed << start << ",\"dur\":" << duration
+                 << ",\"args\":{\"depth\":" << event.depth << "}}";
+            eventCount++;
+        }
+    }
+
+    file << "\n]}\n";
+
+    cout << "Profiler: " << eventCount << " escopos de " << registry.size() << " threads gravados em " << path;
+    if (droppedCount > 0) cout << " (" << droppedCount << " mais antigos sobrescritos)";
+    cout << endl;
+    return true;
+}
+
+#else
+
+bool Profiler::isCompiledIn() { return false; }
+
+Profiler::ThreadBuffer* Profiler::registerThread() { return nullptr; }
+
+Profiler::ThreadBuffer* Profiler::createBuffer(const string&) { return nullptr; }
+
+void Profiler::setThreadName(const string&) {}
+
+void Profiler::addGpuEvent(const char*, uint64_t, double) {}
+
+double Profiler::ticksPerMicrosecond() { return 1000.0; }
+
+bool Profiler::writeChromeTrace(const string&) {
+    cerr << "Profiler: compile com -DENABLE_PROFILER para gerar o trace" << endl;
+    return false;
+}
+
+#endif
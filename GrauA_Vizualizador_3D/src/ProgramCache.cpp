@@ -0,0 +1,149 @@
+#include "ProgramCache.h"
+#include "GLExtensions.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <cstring>
+#include <filesystem>
+
+string ProgramCache::directory = "shader_cache";
+bool ProgramCache::enabled = true;
+
+unsigned int ProgramCache::hits = 0;
+unsigned int ProgramCache::misses = 0;
+unsigned int ProgramCache::rejected = 0;
+
+namespace {
+    const uint32_t CACHE_MAGIC   = 0x43504743;  // "CGPC" (o "CGRP" é do AssetPack)
+    const uint32_t CACHE_VERSION = 1;
+
+    // Cabeçalho de cada arquivo do cache, seguido de "length" bytes do binário
+    struct CacheHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;       // repetida no arquivo para detectar colisões de nome
+        uint32_t format;    // binaryFormat devolvido por glGetProgramBinary
+        uint32_t length;
+    };
+
+    uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+        const unsigned char* bytes = (const unsigned char*)data;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t fnv1a(uint64_t hash, const char* text) {
+        if (text == nullptr) return hash;
+        return fnv1a(hash, text, strlen(text) + 1);    // inclui o '\0' como separador
+    }
+}
+
+
+uint64_t ProgramCache::makeKey(const string& vertexSource, const string& fragmentSource) {
+    uint64_t hash = 14695981039346656037ull;
+    hash = fnv1a(hash, vertexSource.c_str());
+    hash = fnv1a(hash, fragmentSource.c_str());
+    hash = fnv1a(hash, (const char*)glGetString(GL_RENDERER));
+    hash = fnv1a(hash, (const char*)glGetString(GL_VERSION));
+    return hash;
+}
+
+
+string ProgramCache::pathFor(uint64_t key) {
+    ostringstream name;
+    name << directory << "/" << hex << setw(16) << setfill('0') << key << ".bin";
+    return name.str();
+}
+
+
+bool ProgramCache::load(GLuint program, uint64_t key) {
+    if (!enabled || !GLExtensions::programBinary) return false;
+
+    ifstream file(pathFor(key), ios::binary | ios::ate);
+    if (!file) {
+        misses++;
+        return false;
+    }
+    uint64_t fileSize = (uint64_t)file.tellg();
+    file.seekg(0);
+
+    CacheHeader header;
+    file.read((char*)&header, sizeof(header));
+
+    // o tamanho vem do arquivo: conferido com o que sobra dele antes de alocar (arquivo corrompido)
+    vector<char> binary;
+    bool valid = file && header.magic == CACHE_MAGIC && header.version == CACHE_VERSION && header.key == key &&
+                 header.length <= fileSize - sizeof(header);
+    if (valid) {
+        binary.resize(header.length);
+        file.read(binary.data(), header.length);
+        valid = (bool)file;
+    }
+
+    if (!valid) {
+        cerr << "Cache de programas: arquivo invalido " << pathFor(key) << endl;
+        rejected++;
+        return false;
+    }
+
+    // o driver pode recusar o binário (formato de outra versão): o chamador compila do código fonte
+    glProgramBinary(program, header.format, binary.data(), (GLsizei)header.length);
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        while (glGetError() != GL_NO_ERROR) {}  // formato desconhecido gera GL_INVALID_ENUM: já tratado aqui
+        rejected++;
+        return false;
+    }
+
+    hits++;
+    return true;
+}
+
+
+void ProgramCache::store(GLuint program, uint64_t key) {
+    if (!enabled || !GLExtensions::programBinary) return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    vector<char> binary(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) return;
+
+    error_code error;
+    filesystem::create_directories(directory, error);
+
+    ofstream file(pathFor(key), ios::binary | ios::trunc);
+    if (!file) {
+        cerr << "Cache de programas: falha ao gravar " << pathFor(key) << endl;
+        return;
+    }
+
+    CacheHeader header;
+    header.magic   = CACHE_MAGIC;
+    header.version = CACHE_VERSION;
+    header.key     = key;
+    header.format  = format;
+    header.length  = (uint32_t)written;
+
+    file.write((const char*)&header, sizeof(header));
+    file.write(binary.data(), written);
+}
+
+
+void ProgramCache::printReport() {
+    if (hits + misses + rejected == 0) return;
+
+    cout << "Cache de programas: " << hits << " carregados do disco, " << misses << " compilados, "
+         << rejected << " recusados" << endl;
+}
@@ -1,18 +1,19 @@
 #include "Projetil.h"
 #include <glad/glad.h>
+#include "GLState.h"
 #include <iostream>
 
 
 Projetil::Projetil() 
-    : position(0.0f), direction(0.0f, 0.0f, 1.0f), speed(10.0f), 
+    : position(0.0f), previousPosition(0.0f), direction(0.0f, 0.0f, 1.0f), speed(10.0f), 
       lifetime(0.0f), maxLifetime(5.0f), active(false), VAO(0), VBO(0) {
     setupMesh();
 }
 
-Projetil::Projetil(const glm::vec3& startPos, const glm::vec3& dir, float projetilSpeed, float maxLife)
-    : position(startPos), direction(glm::normalize(dir)), speed(projetilSpeed),
+Projetil::Projetil(const glm::vec3& startPos, const glm::vec3& dir, float projetilSpeed, float maxLife, bool createMesh)
+    : position(startPos), previousPosition(startPos), direction(glm::normalize(dir)), speed(projetilSpeed),
       lifetime(0.0f), maxLifetime(maxLife), active(true), VAO(0), VBO(0) {
-    setupMesh();
+    if (createMesh) setupMesh();
 }
 
 Projetil::~Projetil() {
@@ -22,6 +23,7 @@ Projetil::~Projetil() {
 void Projetil::update(float deltaTime) {
     if (!active) return;
     // Atualiza a posição do projétil e verifica se deve ser desativado
+    previousPosition = position;
     position += direction * speed * deltaTime;
     lifetime += deltaTime;
     
@@ -40,9 +42,30 @@ void Projetil::draw(const Shader& shader) const {
     shader.setMat4("model", model);
     shader.setVec3("objectColor", 1.0f, 1.0f, 0.0f); // Projétil amarelo
 
-    glBindVertexArray(VAO);
+    GLState::bindVertexArray(VAO);
     glDrawArrays(GL_TRIANGLES, 0, 36); // Cubo tem 36 vértices
-    glBindVertexArray(0);
+}
+
+void Projetil::enqueue(RenderQueue& queue, ShaderPermutations& shaders) const {
+    if (!active || VAO == 0) return;
+
+    const Shader* shader = shaders.get(0);  // cor sólida: a mesma variante dos objetos sem textura
+    if (shader == nullptr) return;
+
+    DrawPacket packet;
+    packet.shader      = shader;
+    packet.VAO         = VAO;
+    packet.indexCount  = 0;
+    packet.vertexCount = 36; // Cubo tem 36 vértices
+    packet.instanceCount = 0;
+    packet.textureID   = 0;
+    packet.textureLayer = -1;
+    packet.model       = glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(0.05f));
+    packet.color       = glm::vec3(1.0f, 1.0f, 0.0f); // Projétil amarelo
+    packet.key = RenderQueue::makeKey(PASS_PROJECTILE, shader->ID, 0, VAO, 0.0f);
+
+    queue.submit(packet);
+    queue.countNaiveProjectile();
 }
 
 void Projetil::reflect(const glm::vec3& normal) {
@@ -101,25 +124,25 @@ void Projetil::setupMesh() {
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     
-    glBindVertexArray(VAO);
+    GLState::bindVertexArray(VAO);
     
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
     
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::bindVertexArray(0);
 }
 
 void Projetil::cleanup() {    // libera recursos da OpenGL
     if (VAO != 0) {
-        glDeleteVertexArrays(1, &VAO);
+        GLState::deleteVertexArray(VAO);
         VAO = 0;
     }
     if (VBO != 0) {
-        glDeleteBuffers(1, &VBO);
+        GLState::deleteBuffer(VBO);
         VBO = 0;
     }
 }
\ No newline at end of file
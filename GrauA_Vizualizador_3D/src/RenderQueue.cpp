@@ -0,0 +1,250 @@
+#include "RenderQueue.h"
+#include <glad/glad.h>
+#include "GLState.h"
+#include "Profiler.h"
+#include <iostream>
+#include <algorithm>
+
+RenderQueue::RenderQueue() : frames(0), gpuTimer(nullptr) {}
+
+
+// Monta a chave de ordenação de 64 bits.
+// Ordem dos campos (do mais para o menos significativo): pass, shader, textura, malha, profundidade.
+// Assim, pacotes que compartilham shader e textura ficam contíguos e os binds repetidos desaparecem.
+uint64_t RenderQueue::makeKey(RenderPass pass, unsigned int shaderID, unsigned int textureID,
+                              unsigned int meshID, float depth) {
+
+    // profundidade normalizada [0,1] -> 16 bits (mais próximo primeiro, reduz overdraw)
+    float clamped = std::min(std::max(depth, 0.0f), 1.0f);
+    uint64_t depthBits = (uint64_t)(clamped * 65535.0f);
+
+    return ((uint64_t)(pass      & 0xF)     << 60) |
+           ((uint64_t)(shaderID  & 0xFF)    << 52) |
+           ((uint64_t)(textureID & 0xFFFF)  << 36) |
+           ((uint64_t)(meshID    & 0xFFFFF) << 16) |
+           depthBits;
+}
+
+
+const char* RenderQueue::passName(RenderPass pass) {
+    switch (pass) {
+        case PASS_OPAQUE:     return "Cena";
+        case PASS_PROJECTILE: return "Projeteis";
+    }
+    return "Pass";
+}
+
+
+unsigned int RenderQueue::textureKey(unsigned int textureID, int layer) {
+    if (layer < 0) return textureID;
+    return ((textureID & 0xFF) << 8) | ((unsigned int)layer & 0xFF);
+}
+
+
+void RenderQueue::clear() {
+    packets.clear();
+
+    // Referência "antes" (desenho direto com o antigo uber shader, sem fila nem variantes): por frame,
+    // use() + projection e view, dois uniforms de modo/cor antes dos objetos e dois antes dos projéteis
+    naiveStats = RenderStats();
+    naiveStats.programBinds   = 1;
+    naiveStats.uniformUpdates = 6;
+}
+
+
+void RenderQueue::submit(const DrawPacket& packet) {
+    packets.push_back(packet);
+}
+
+
+// Desenho direto de um objeto no uber shader: model + (activeTexture, bindTexture e os dois uniforms
+// da textura | o uniform de modo) + cor e bind/unbind do VAO para cada grupo
+void RenderQueue::countNaiveObject(bool textured, unsigned int groupCount) {
+    naiveStats.uniformUpdates += textured ? 4 : 3;
+    naiveStats.textureBinds   += textured ? 2 : 0;
+    naiveStats.vaoBinds       += 2 * groupCount;
+    naiveStats.drawCalls      += groupCount;
+}
+
+
+// Projetil::draw: model + objectColor e bind/unbind do VAO
+void RenderQueue::countNaiveProjectile() {
+    naiveStats.uniformUpdates += 2;
+    naiveStats.vaoBinds       += 2;
+    naiveStats.drawCalls      += 1;
+}
+
+
+void RenderQueue::radixSort() {
+    size_t count = packets.size();
+
+    sortKeys.resize(count);
+    sortIndices.resize(count);
+    sortKeysTmp.resize(count);
+    sortIndicesTmp.resize(count);
+
+    for (size_t i = 0; i < count; i++) {
+        sortKeys[i] = packets[i].key;
+        sortIndices[i] = (uint32_t)i;
+    }
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t histogram[256] = {0};
+
+        for (size_t i = 0; i < count; i++) {
+            histogram[(sortKeys[i] >> shift) & 0xFF]++;
+        }
+
+        // todas as chaves têm o mesmo byte nesta posição: a passada não muda a ordem
+        if (count == 0 || histogram[(sortKeys[0] >> shift) & 0xFF] == count) continue;
+
+        size_t offset = 0;
+        for (int b = 0; b < 256; b++) {
+            size_t c = histogram[b];
+            histogram[b] = offset;
+            offset += c;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            size_t dst = histogram[(sortKeys[i] >> shift) & 0xFF]++;
+            sortKeysTmp[dst] = sortKeys[i];
+            sortIndicesTmp[dst] = sortIndices[i];
+        }
+
+        sortKeys.swap(sortKeysTmp);
+        sortIndices.swap(sortIndicesTmp);
+    }
+}
+
+
+void RenderQueue::flush(const glm::mat4& view, const glm::mat4& projection) {
+    PROFILE_SCOPE("RenderQueue::flush");
+    stats = RenderStats();
+
+    radixSort();
+
+    const Shader* currentShader = nullptr;
+    unsigned int currentVAO = 0;
+    unsigned int currentTexture = 0;    // GL_TEXTURE_2D na unidade 0
+    unsigned int currentArray = 0;      // GL_TEXTURE_2D_ARRAY na unidade 1
+    int  currentLayer = -2;             // -2 = valor do uniform textureLayer desconhecido
+    bool colorValid = false;
+    glm::vec3 currentColor(0.0f);
+    int currentPass = -1;
+
+    for (uint32_t index : sortIndices) {
+        const DrawPacket& packet = packets[index];
+
+        // os pacotes estão ordenados por pass (bits mais altos da chave): um intervalo de GPU por pass
+        int pass = (int)(packet.key >> 60);
+        if (gpuTimer && pass != currentPass) {
+            gpuTimer->beginPass(passName((RenderPass)pass));
+            currentPass = pass;
+        }
+
+        // troca de programa (variante de shader): reenvia os uniforms comuns a todo o frame.
+        // O pass e a presença de textura já estão embutidos na variante, sem uniforms de controle.
+        if (packet.shader != currentShader) {
+            currentShader = packet.shader;
+            currentShader->use();
+            currentShader->setMat4("projection", projection);
+            currentShader->setMat4("view", view);
+            stats.programBinds++;
+            stats.uniformUpdates += 2;
+
+            if (packet.textureLayer >= 0) {
+                currentShader->setInt("diffuseArray", 1);   // variante TEXTURE_ARRAY: array na unidade 1
+                stats.uniformUpdates++;
+            }
+
+            currentLayer = -2;
+            colorValid = false;
+        }
+
+        if (packet.textureLayer >= 0) {
+            // texture array: o bind só muda quando muda o array; a camada é um uniform
+            if (packet.textureID != currentArray) {
+                GLState::bindTextureUnit(1, GL_TEXTURE_2D_ARRAY, packet.textureID);
+                stats.textureBinds++;
+                currentArray = packet.textureID;
+            }
+        } else if (packet.textureID != 0 && packet.textureID != currentTexture) {
+            GLState::bindTextureUnit(0, GL_TEXTURE_2D, packet.textureID);
+            stats.textureBinds++;
+            currentTexture = packet.textureID;
+        }
+
+        if (packet.textureLayer >= 0 && packet.textureLayer != currentLayer) {
+            currentShader->setInt("textureLayer", packet.textureLayer);
+            stats.uniformUpdates++;
+            currentLayer = packet.textureLayer;
+        }
+
+        // a cor sólida só existe nas variantes sem textura
+        if (packet.textureID == 0 && (!colorValid || packet.color != currentColor)) {
+            currentShader->setVec3("objectColor", packet.color);
+            stats.uniformUpdates++;
+            currentColor = packet.color;
+            colorValid = true;
+        }
+
+        // pacotes instanciados leem a matriz model do instance buffer
+        if (packet.instanceCount == 0) {
+            currentShader->setMat4("model", packet.model);
+            stats.uniformUpdates++;
+        }
+
+        if (packet.VAO != currentVAO) {
+            GLState::bindVertexArray(packet.VAO);
+            stats.vaoBinds++;
+            currentVAO = packet.VAO;
+        }
+
+        if (packet.instanceCount > 0) {
+            glDrawElementsInstanced(GL_TRIANGLES, packet.indexCount, GL_UNSIGNED_INT, 0, packet.instanceCount);
+            stats.instancedDrawCalls++;
+            stats.triangles += (unsigned long long)(packet.indexCount / 3) * packet.instanceCount;
+        } else if (packet.indexCount > 0) {
+            glDrawElements(GL_TRIANGLES, packet.indexCount, GL_UNSIGNED_INT, 0);
+            stats.triangles += packet.indexCount / 3;
+        } else {
+            glDrawArrays(GL_TRIANGLES, 0, packet.vertexCount);
+            stats.triangles += packet.vertexCount / 3;
+        }
+        stats.drawCalls++;
+    }
+
+    // acumula para o relatório
+    frames++;
+    totalStats.drawCalls           += stats.drawCalls;
+    totalStats.instancedDrawCalls  += stats.instancedDrawCalls;
+    totalStats.programBinds        += stats.programBinds;
+    totalStats.textureBinds        += stats.textureBinds;
+    totalStats.vaoBinds            += stats.vaoBinds;
+    totalStats.uniformUpdates      += stats.uniformUpdates;
+    totalStats.triangles           += stats.triangles;
+    totalNaiveStats.drawCalls      += naiveStats.drawCalls;
+    totalNaiveStats.programBinds   += naiveStats.programBinds;
+    totalNaiveStats.textureBinds   += naiveStats.textureBinds;
+    totalNaiveStats.vaoBinds       += naiveStats.vaoBinds;
+    totalNaiveStats.uniformUpdates += naiveStats.uniformUpdates;
+}
+
+
+void RenderQueue::printReport() const {
+    if (frames == 0) return;
+
+    double n = (double)frames;
+
+    cout << "Mudancas de estado por frame (media de " << frames << " frames) - antes / depois da fila:" << endl;
+    cout << "  Programas: " << totalNaiveStats.programBinds   / n << " / " << totalStats.programBinds   / n << endl;
+    cout << "  Texturas:  " << totalNaiveStats.textureBinds   / n << " / " << totalStats.textureBinds   / n << endl;
+    cout << "  VAOs:      " << totalNaiveStats.vaoBinds       / n << " / " << totalStats.vaoBinds       / n << endl;
+    cout << "  Uniforms:  " << totalNaiveStats.uniformUpdates / n << " / " << totalStats.uniformUpdates / n << endl;
+    cout << "  Total:     " << totalNaiveStats.stateChanges() / n << " / " << totalStats.stateChanges() / n << endl;
+    cout << "  Draw calls: " << totalNaiveStats.drawCalls     / n << " / " << totalStats.drawCalls      / n;
+    if (totalStats.instancedDrawCalls > 0) {
+        cout << " (" << totalStats.instancedDrawCalls / n << " instanciados)";
+    }
+    cout << endl;
+}
@@ -0,0 +1,205 @@
+#include "SceneGenerator.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+
+namespace {
+    const float PI = 3.14159265f;
+}
+
+
+bool SceneGenerator::generate(const SceneGeneratorOptions& options) {
+    error_code error;
+    filesystem::create_directories(options.directory + "/models", error);
+    filesystem::create_directories(options.directory + "/textures", error);
+    if (error) {
+        cerr << "Falha ao criar " << options.directory << ": " << error.message() << endl;
+        return false;
+    }
+
+    mt19937 random(options.seed);
+
+    // Malhas e texturas compartilhadas por todos os objetos
+    unsigned int meshCount = max(1u, options.meshes);
+    vector<string> meshPaths, texturePaths;
+    for (unsigned int i = 0; i < meshCount; i++) {
+        meshPaths.push_back(options.directory + "/models/malha_" + to_string(i) + ".obj");
+        if (!writeMesh(meshPaths.back(), options.meshFaces, random)) return false;
+    }
+    for (unsigned int i = 0; i < options.textures; i++) {
+        texturePaths.push_back(options.directory + "/textures/textura_" + to_string(i) + ".ppm");
+        if (!writeTexture(texturePaths.back(), options.textureSize, i)) return false;
+    }
+
+    // Combinação c = malha (c % meshCount) + textura (c / meshCount). As primeiras "sharedCombinations"
+    // recebem os objetos compartilhados; as demais, um objeto exclusivo cada.
+    size_t combinations = (size_t)meshCount * max(1u, options.textures);
+    size_t shared = (size_t)llround(min(max(options.instancing, 0.0f), 1.0f) * options.objects);
+    if (shared < 2) shared = 0;     // instância isolada não forma grupo
+    size_t exclusive = options.objects - shared;
+
+    // grupos de ~sqrt(shared) objetos, sem tomar as combinações que os exclusivos precisam (resta ao menos uma)
+    size_t sharedCombinations = 0;
+    if (shared > 0) {
+        size_t available = combinations - min(exclusive, combinations - 1);
+        sharedCombinations = min(available, (size_t)ceil(sqrt((double)shared)));
+    }
+    size_t exclusiveCombinations = combinations - sharedCombinations;
+
+    if (exclusive > exclusiveCombinations) {
+        cout << "Aviso: " << exclusive << " objetos exclusivos para " << exclusiveCombinations
+             << " combinacoes malha + textura; os excedentes repetem combinacoes (aumente --meshes ou --textures)" << endl;
+    }
+
+    // Região ocupada: cresce com a raiz cúbica da quantidade, mantendo a densidade aproximada
+    float extent = options.extent > 0.0f ? options.extent : max(10.0f, 2.5f * cbrt((float)options.objects));
+
+    vector<glm::vec3> clusters;
+    if (options.distribution == DISTRIBUTION_CLUSTERED) {
+        uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        size_t clusterCount = max<size_t>(1, (size_t)sqrt((double)options.objects) / 4);
+        for (size_t i = 0; i < clusterCount; i++) {
+            clusters.emplace_back(unit(random) * extent, unit(random) * extent * 0.25f, unit(random) * extent);
+        }
+    }
+
+    string scenePath = options.directory + "/cena.txt";
+    FILE* scene = fopen(scenePath.c_str(), "w");
+    if (!scene) {
+        cerr << "Falha ao criar " << scenePath << endl;
+        return false;
+    }
+
+    fprintf(scene, "# Cena gerada (--generate-scene): %zu objetos, %u malhas de %u faces, %u texturas, "
+                   "instanciamento %.2f, semente %u\n",
+            options.objects, meshCount, options.meshFaces, options.textures, options.instancing, options.seed);
+    fprintf(scene, "# Nome Path posX posY posZ rotX rotY rotZ scaleX scaleY scaleZ eliminavel textura\n");
+
+    uniform_real_distribution<float> angle(0.0f, 2.0f * PI);
+    uniform_real_distribution<float> size(0.5f, 1.5f);
+    uniform_real_distribution<float> chance(0.0f, 1.0f);
+
+    for (size_t i = 0; i < options.objects; i++) {
+        size_t combination;
+        if (i < shared) combination = i % sharedCombinations;
+        else if (exclusiveCombinations > 0) combination = sharedCombinations + (i - shared) % exclusiveCombinations;
+        else combination = (i - shared) % combinations;
+
+        const string& mesh = meshPaths[combination % meshCount];
+        glm::vec3 position = randomPosition(options, extent, clusters, random, i);
+        float rotation = angle(random);
+        float scale = size(random);
+        int eliminable = chance(random) < 0.25f ? 1 : 0;
+
+        fprintf(scene, "Obj%zu %s %.3f %.3f %.3f 0.0 %.3f 0.0 %.3f %.3f %.3f %d",
+                i, mesh.c_str(), position.x, position.y, position.z, rotation, scale, scale, scale, eliminable);
+        if (!texturePaths.empty()) fprintf(scene, " %s", texturePaths[combination / meshCount].c_str());
+        fprintf(scene, "\n");
+    }
+    fclose(scene);
+
+    cout << "Cena gerada em " << scenePath << ": " << options.objects << " objetos ("
+         << shared << " em " << sharedCombinations << " grupos de instancias, " << exclusive << " exclusivos), "
+         << meshCount << " malhas, " << options.textures << " texturas, regiao de " << 2.0f * extent << " unidades" << endl;
+    cout << "Para usar: visualizador3d --scene " << scenePath << endl;
+    return true;
+}
+
+
+// Esfera UV com o raio perturbado por ondas de fase aleatória (cada malha tem um formato diferente).
+// Com n faixas e 2n fatias ficam 4n² - 4n triângulos, o mais próximo possível de "faces".
+bool SceneGenerator::writeMesh(const string& path, unsigned int faces, mt19937& random) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        cerr << "Falha ao criar " << path << endl;
+        return false;
+    }
+
+    unsigned int stacks = max(2u, (unsigned int)lround(0.5 + sqrt(faces / 4.0)));
+    unsigned int slices = stacks * 2;
+
+    uniform_real_distribution<float> phase(0.0f, 2.0f * PI);
+    uniform_real_distribution<float> amplitude(0.05f, 0.2f);
+    float phaseA = phase(random), phaseB = phase(random), amplitudeA = amplitude(random), amplitudeB = amplitude(random);
+
+    fprintf(file, "# Malha sintetica: esfera deformada %ux%u\ng malha\n", stacks, slices);
+    for (unsigned int i = 0; i <= stacks; i++) {
+        float theta = PI * i / stacks;
+        for (unsigned int j = 0; j <= slices; j++) {
+            float phi = 2.0f * PI * j / slices;
+            glm::vec3 direction(sin(theta) * cos(phi), cos(theta), sin(theta) * sin(phi));
+            float radius = 1.0f + amplitudeA * sin(3.0f * phi + phaseA) * sin(theta) + amplitudeB * sin(2.0f * theta + phaseB);
+
+            fprintf(file, "v %.5f %.5f %.5f\n", direction.x * radius, direction.y * radius, direction.z * radius);
+            fprintf(file, "vt %.5f %.5f\n", (float)j / slices, 1.0f - (float)i / stacks);
+            fprintf(file, "vn %.5f %.5f %.5f\n", direction.x, direction.y, direction.z);
+        }
+    }
+
+    // v, vt e vn têm o mesmo índice; os triângulos degenerados dos polos são omitidos
+    for (unsigned int i = 0; i < stacks; i++) {
+        for (unsigned int j = 0; j < slices; j++) {
+            unsigned int a = i * (slices + 1) + j + 1, b = a + 1;
+            unsigned int c = a + slices + 1, d = c + 1;
+            if (i != stacks - 1) fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, c, c, c, d, d, d);
+            if (i != 0)          fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, d, d, d, b, b, b);
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+
+// Xadrez com cor própria por índice (matiz girando pelo ângulo áureo), em PPM binário (lido pelo stb_image)
+bool SceneGenerator::writeTexture(const string& path, unsigned int size, unsigned int index) {
+    ofstream file(path, ios::binary);
+    if (!file) {
+        cerr << "Falha ao criar " << path << endl;
+        return false;
+    }
+
+    float hue = fmod(index * 0.618034f, 1.0f) * 6.0f;
+    float fraction = hue - floor(hue);
+    glm::vec3 colors[6] = { { 1, fraction, 0 }, { 1 - fraction, 1, 0 }, { 0, 1, fraction },
+                            { 0, 1 - fraction, 1 }, { fraction, 0, 1 }, { 1, 0, 1 - fraction } };
+    glm::vec3 color = colors[(int)hue % 6];
+
+    file << "P6\n" << size << " " << size << "\n255\n";
+    unsigned int cell = max(1u, size / 8);
+    vector<unsigned char> row(size * 3);
+    for (unsigned int y = 0; y < size; y++) {
+        for (unsigned int x = 0; x < size; x++) {
+            float shade = ((x / cell + y / cell) % 2) ? 1.0f : 0.35f;
+            for (int channel = 0; channel < 3; channel++) {
+                row[x * 3 + channel] = (unsigned char)(255.0f * (0.15f + 0.85f * color[channel] * shade));
+            }
+        }
+        file.write((const char*)row.data(), row.size());
+    }
+    return (bool)file;
+}
+
+
+glm::vec3 SceneGenerator::randomPosition(const SceneGeneratorOptions& options, float extent,
+                                         const vector<glm::vec3>& clusters, mt19937& random, size_t index) {
+    uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    switch (options.distribution) {
+        case DISTRIBUTION_GRID: {
+            size_t side = (size_t)ceil(sqrt((double)options.objects));
+            float spacing = 2.0f * extent / side;
+            return glm::vec3(-extent + spacing * (index % side + 0.5f), 0.0f, -extent + spacing * (index / side + 0.5f));
+        }
+        case DISTRIBUTION_CLUSTERED: {
+            normal_distribution<float> spread(0.0f, extent * 0.05f);
+            const glm::vec3& center = clusters[index % clusters.size()];
+            return center + glm::vec3(spread(random), spread(random) * 0.25f, spread(random));
+        }
+        default:
+            return glm::vec3(unit(random) * extent, unit(random) * extent * 0.25f, unit(random) * extent);
+    }
+}
@@ -1,11 +1,15 @@
 #include "Shader.h"
+#include "GLState.h"
+#include "GLExtensions.h"
+#include "ProgramCache.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 
-Shader::Shader() : ID(0) {}
+Shader::Shader() : ID(0), loadedFromCache(false), pendingVertex(0), pendingFragment(0), cacheKey(0), pending(false) {}
 
-Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath) : ID(0) {
+Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
+    : ID(0), loadedFromCache(false), pendingVertex(0), pendingFragment(0), cacheKey(0), pending(false) {
     loadFromFiles(vertexPath, fragmentPath);
 }
 
@@ -26,36 +30,73 @@ bool Shader::loadFromFiles(const std::string& vertexPath, const std::string& fra
 }
 
 bool Shader::loadFromStrings(const std::string& vertexSource, const std::string& fragmentSource) {
+    return beginLoad(vertexSource, fragmentSource) && finishLoad();
+}
+
+bool Shader::beginLoad(const std::string& vertexSource, const std::string& fragmentSource) {
     cleanup();
-    
-    // Compile shaders
-    unsigned int vertex = compileShader(vertexSource, GL_VERTEX_SHADER);
-    unsigned int fragment = compileShader(fragmentSource, GL_FRAGMENT_SHADER);
-    
-    if (vertex == 0 || fragment == 0) {
-        if (vertex != 0) glDeleteShader(vertex);
-        if (fragment != 0) glDeleteShader(fragment);
-        return false;
+
+    ID = glCreateProgram();
+    cacheKey = ProgramCache::makeKey(vertexSource, fragmentSource);
+
+    // Programa já compilado em uma execução anterior: nada a compilar
+    loadedFromCache = ProgramCache::load(ID, cacheKey);
+    if (loadedFromCache) {
+        pending = false;
+        return true;
     }
+
+    // Sem binário válido no cache: o mesmo programa é compilado e linkado normalmente
+    // Compile shaders (sem consultar o resultado, para não bloquear a compilação paralela)
+    pendingVertex = compileShader(vertexSource, GL_VERTEX_SHADER);
+    pendingFragment = compileShader(fragmentSource, GL_FRAGMENT_SHADER);
     
     // Create shader program
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
+    glAttachShader(ID, pendingVertex);
+    glAttachShader(ID, pendingFragment);
+    if (GLExtensions::programBinary) {
+        glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(ID);
+
+    pending = true;
+    return true;
+}
+
+bool Shader::isReady() const {
+    if (!pending || !GLExtensions::parallelShaderCompile) return true;
+
+    GLint done = GL_FALSE;
+    glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &done);
+    return done == GL_TRUE;
+}
+
+bool Shader::finishLoad() {
+    if (ID == 0) return false;
+
+    if (!pending) {
+        std::cout << "Shader program loaded from cache (ID: " << ID << ")" << std::endl;
+        return true;
+    }
+    pending = false;
+
+    // Check for compilation and linking errors
+    bool ok = checkCompileErrors(pendingVertex, "VERTEX") &&
+              checkCompileErrors(pendingFragment, "FRAGMENT") &&
+              checkCompileErrors(ID, "PROGRAM");
     
-    // Check for linking errors
-    if (!checkCompileErrors(ID, "PROGRAM")) {
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
-        glDeleteProgram(ID);
+    // Delete shaders as they're linked into program now
+    glDeleteShader(pendingVertex);
+    glDeleteShader(pendingFragment);
+    pendingVertex = pendingFragment = 0;
+
+    if (!ok) {
+        GLState::deleteProgram(ID);
         ID = 0;
         return false;
     }
-    
-    // Delete shaders as they're linked into program now
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+
+    ProgramCache::store(ID, cacheKey);
     
     std::cout << "Shader program created successfully (ID: " << ID << ")" << std::endl;
     return true;
@@ -63,7 +104,7 @@ bool Shader::loadFromStrings(const std::string& vertexSource, const std::string&
 
 void Shader::use() const {
     if (ID != 0) {
-        glUseProgram(ID);
+        GLState::useProgram(ID);
     }
 }
 
@@ -91,13 +132,7 @@ unsigned int Shader::compileShader(const std::string& source, GLenum shaderType)
     unsigned int shader = glCreateShader(shaderType);
     const char* sourceCStr = source.c_str();
     glShaderSource(shader, 1, &sourceCStr, NULL);
-    glCompileShader(shader);
-    
-    std::string type = (shaderType == GL_VERTEX_SHADER) ? "VERTEX" : "FRAGMENT";
-    if (!checkCompileErrors(shader, type)) {
-        glDeleteShader(shader);
-        return 0;
-    }
+    glCompileShader(shader);    // erros verificados em finishLoad (checkCompileErrors)
     
     return shader;
 }
@@ -126,8 +161,12 @@ bool Shader::checkCompileErrors(unsigned int shader, const std::string& type) co
 }
 
 void Shader::cleanup() {
+    if (pendingVertex != 0)   { glDeleteShader(pendingVertex);   pendingVertex = 0; }
+    if (pendingFragment != 0) { glDeleteShader(pendingFragment); pendingFragment = 0; }
+    pending = false;
+
     if (ID != 0) {
-        glDeleteProgram(ID);
+        GLState::deleteProgram(ID);
         ID = 0;
     }
 }
@@ -0,0 +1,108 @@
+#include "ShaderPermutations.h"
+#include <iostream>
+
+namespace {
+    const char* featureNames[SHADER_FEATURE_COUNT] = {
+        "TEXTURED", "INSTANCED", "TEXTURE_ARRAY"
+    };
+}
+
+ShaderPermutations::ShaderPermutations() {}
+
+ShaderPermutations::~ShaderPermutations() { cleanup(); }
+
+
+void ShaderPermutations::setSources(const string& vertexSource, const string& fragmentSource) {
+    cleanup();  // variantes antigas foram compiladas de outro código
+    this->vertexSource = vertexSource;
+    this->fragmentSource = fragmentSource;
+}
+
+
+unsigned int ShaderPermutations::normalize(unsigned int features) {
+    if (!(features & SHADER_TEXTURED)) {
+        features &= ~SHADER_TEXTURE_ARRAY;
+    }
+    return features;
+}
+
+
+string ShaderPermutations::defines(unsigned int features) {
+    string definitions;
+    for (int bit = 0; bit < SHADER_FEATURE_COUNT; bit++) {
+        if (features & (1u << bit)) {
+            definitions += "#define ";
+            definitions += featureNames[bit];
+            definitions += "\n";
+        }
+    }
+    return definitions;
+}
+
+
+string ShaderPermutations::injectDefines(const string& source, const string& definitions) {
+    size_t version = source.find("#version");
+    if (version == string::npos) return definitions + source;
+
+    size_t lineEnd = source.find('\n', version);
+    if (lineEnd == string::npos) return source + "\n" + definitions;
+
+    return source.substr(0, lineEnd + 1) + definitions + source.substr(lineEnd + 1);
+}
+
+
+const Shader* ShaderPermutations::get(unsigned int features) {
+    features = normalize(features);
+
+    auto found = variants.find(features);
+    if (found != variants.end()) {
+        return found->second->ID != 0 ? found->second.get() : nullptr;
+    }
+
+    string definitions = defines(features);
+    unique_ptr<Shader> shader(new Shader());
+
+    if (!shader->loadFromStrings(injectDefines(vertexSource, definitions),
+                                 injectDefines(fragmentSource, definitions))) {
+        cerr << "Falha ao compilar variante de shader (mascara " << features << ")" << endl;
+    }
+
+    const Shader* result = shader->ID != 0 ? shader.get() : nullptr;
+    variants[features] = move(shader);
+    return result;
+}
+
+
+// Dispara a compilação de todas as variantes antes de esperar por qualquer uma delas:
+// com KHR_parallel_shader_compile o driver compila as variantes em paralelo
+bool ShaderPermutations::prepare(const vector<unsigned int>& featureSets) {
+    vector<Shader*> started;
+    for (unsigned int features : featureSets) {
+        features = normalize(features);
+        if (variants.count(features)) continue;
+
+        string definitions = defines(features);
+        unique_ptr<Shader> shader(new Shader());
+        shader->beginLoad(injectDefines(vertexSource, definitions), injectDefines(fragmentSource, definitions));
+
+        started.push_back(shader.get());
+        variants[features] = move(shader);
+    }
+
+    for (Shader* shader : started) {
+        if (!shader->finishLoad()) {
+            cerr << "Falha ao compilar variante de shader" << endl;
+        }
+    }
+
+    bool ok = true;
+    for (unsigned int features : featureSets) {
+        if (get(features) == nullptr) ok = false;
+    }
+    return ok;
+}
+
+
+void ShaderPermutations::cleanup() {
+    variants.clear();   // ~Shader libera cada programa
+}
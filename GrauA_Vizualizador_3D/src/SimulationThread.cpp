@@ -0,0 +1,97 @@
+#include "SimulationThread.h"
+#include "Profiler.h"
+#include "JobSystem.h"
+#include "Log.h"
+#include <algorithm>
+
+SimulationThread::SimulationThread()
+    : period(1.0f / 60.0f), stopping(false), finished(false), late(0) {}
+
+SimulationThread::~SimulationThread() { stop(); }
+
+
+void SimulationThread::start(float tickTime, Step stepFunction) {
+    if (isStarted()) return;
+
+    step = move(stepFunction);
+    period = tickTime;
+    stopping = false;
+    finished = false;
+    late = 0;
+    worker = thread(&SimulationThread::run, this);
+}
+
+
+void SimulationThread::stop() {
+    if (!isStarted()) return;
+    stopping = true;
+    worker.join();
+}
+
+
+void SimulationThread::pushInput(const FrameInput& frameInput) {
+    lock_guard<mutex> lock(inputMutex);
+    pendingInput.push(frameInput);
+}
+
+
+FrameInput SimulationThread::takeInput() {
+    lock_guard<mutex> lock(inputMutex);
+    return pendingInput.take();
+}
+
+
+const SimulationSnapshot& SimulationThread::latest(float& alpha) {
+    snapshots.update();
+    const SimulationSnapshot& snapshot = snapshots.read();
+
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - snapshot.time).count();
+    alpha = snapshot.tick == 0 ? 1.0f : (float)std::min(std::max(elapsed / period, 0.0), 1.0);
+    return snapshot;
+}
+
+
+// Laço da simulação: um passo a cada "period" segundos, no relógio absoluto (sem deriva)
+void SimulationThread::run() {
+    Profiler::setThreadName("simulacao");
+
+    // registrada no JobSystem, a thread divide as colisões do passo com as threads de trabalho
+    // (sem vaga, o parallelFor do passo roda inteiro aqui)
+    if (!JobSystem::attachThread() && JobSystem::isStarted()) {
+        LOG_WARNING("Simulacao: sem vaga no JobSystem, colisoes em serie nesta thread");
+    }
+
+    auto tickDuration = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(period));
+    auto next = chrono::steady_clock::now();
+    uint64_t tick = 0;
+
+    while (!stopping.load()) {
+        FrameInput input = takeInput();
+
+        SimulationSnapshot& snapshot = snapshots.write();
+        bool simulated;
+        {
+            PROFILE_SCOPE("SimulationThread::step");
+            simulated = step(input, period, snapshot);
+        }
+        if (!simulated) {
+            finished = true;    // o último snapshot publicado continua valendo
+            break;
+        }
+        snapshot.tick = ++tick;
+        snapshot.time = chrono::steady_clock::now();
+        snapshots.publish();
+
+        // passo atrasado: segue imediatamente; muito atrasado (ex.: passo de 1 s), recomeça a contagem
+        next += tickDuration;
+        auto now = chrono::steady_clock::now();
+        if (chrono::duration<double>(now - next).count() > MAX_LAG) {
+            next = now;
+            late++;
+        } else {
+            this_thread::sleep_until(next);
+        }
+    }
+
+    JobSystem::detachThread();
+}
@@ -0,0 +1,249 @@
+#include "StaticBatch.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include "Stats.h"
+#include "Frustum.h"
+#include "JobSystem.h"
+#include <iostream>
+#include <algorithm>
+
+namespace {
+    const size_t CULL_GRAIN = 64;   // objetos por job (~15 µs: o custo de um job fica abaixo de 1%)
+}
+
+StaticBatch::StaticBatch()
+    : multiDrawCalls(0), commandCount(0), triangleCount(0), visibleObjects(0), culledObjects(0), commandRebuilds(0),
+      VAO(0), VBO(0), EBO(0), commandBuffer(0), objectBuffer(0), dirty(true),
+      commandsUseTextureArray(false) {}
+
+StaticBatch::~StaticBatch() { cleanup(); }
+
+
+bool StaticBatch::isSupported() {
+    return GLExtensions::multiDrawIndirect && GLExtensions::shaderStorageBuffer && GLExtensions::shaderDrawParameters;
+}
+
+
+// Junta a geometria de todos os grupos de todas as malhas em um único VBO/EBO.
+// Cada grupo vira uma faixa (firstIndex, indexCount, baseVertex) dentro dos buffers compartilhados.
+bool StaticBatch::build(const vector<unique_ptr<OBJ3D>>& objects) {
+    PROFILE_SCOPE("StaticBatch::build");
+    cleanup();
+
+    vector<float> allVertices;          // 8 floats por vértice, mesmo layout de Group::vertices
+    vector<unsigned int> allIndices;
+
+    for (const auto& object : objects) {
+        if (meshRanges.count(object->modelPath)) continue;  // malha já copiada por outro objeto
+
+        vector<MeshRange>& ranges = meshRanges[object->modelPath];
+
+        for (const auto& group : object->mesh->groups) {
+            if (group.indexCount == 0) continue;
+
+            MeshRange range;
+            range.firstIndex = (unsigned int)allIndices.size();
+            range.indexCount = (unsigned int)group.indexCount;
+            range.baseVertex = (int)(allVertices.size() / 8);
+            ranges.push_back(range);
+
+            allVertices.insert(allVertices.end(), group.vertices.begin(), group.vertices.end());
+            allIndices.insert(allIndices.end(), group.indices.begin(), group.indices.end());
+        }
+    }
+
+    if (allIndices.empty()) return false;
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+    glGenBuffers(1, &commandBuffer);
+    glGenBuffers(1, &objectBuffer);
+
+    GLState::bindVertexArray(VAO);
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, allVertices.size() * sizeof(float), allVertices.data(), GL_STATIC_DRAW);
+
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, allIndices.size() * sizeof(unsigned int), allIndices.data(), GL_STATIC_DRAW);
+    Stats::add(STAT_GPU_MEMORY, (double)(allVertices.size() * sizeof(float) + allIndices.size() * sizeof(unsigned int)));
+
+    // mesmo layout de atributos de Group::uploadBuffers
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(5 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::bindVertexArray(0);
+
+    dirty = true;
+    commandRebuilds = 0;
+
+    cout << "Batch estatico: " << meshRanges.size() << " malhas, " << allVertices.size() / 8
+         << " vertices, " << allIndices.size() << " indices" << endl;
+    return true;
+}
+
+
+unsigned int StaticBatch::textureOf(const OBJ3D& object, int& layer) const {
+    layer = -1;
+    if (!object.hasTexture) return 0;
+
+    if (commandsUseTextureArray && object.arrayTexture.layer >= 0) {
+        layer = object.arrayTexture.layer;
+        return object.arrayTexture.arrayID;
+    }
+    return object.textureID;
+}
+
+
+// Gera um comando por grupo de cada objeto visível, ordenados por textura,
+// e os dados por comando (model, cor, material) lidos pelo shader via gl_DrawID
+void StaticBatch::rebuildCommands(const vector<unique_ptr<OBJ3D>>& objects) {
+    commands.clear();
+    objectData.clear();
+    textureRanges.clear();
+
+    // objetos visíveis, agrupados por textura (ordem estável dentro de cada textura)
+    vector<size_t> order;
+    for (size_t i = 0; i < objects.size(); i++) {
+        if (visibility[i]) order.push_back(i);
+    }
+    stable_sort(order.begin(), order.end(), [this, &objects](size_t a, size_t b) {
+        int layerA, layerB;
+        unsigned int textureA = textureOf(*objects[a], layerA);
+        unsigned int textureB = textureOf(*objects[b], layerB);
+        if (textureA != textureB) return textureA < textureB;
+        return layerA < layerB;     // mesmo nome de textura: arrays (>= 0) depois das 2D comuns
+    });
+
+    for (size_t index : order) {
+        const OBJ3D& object = *objects[index];
+        auto found = meshRanges.find(object.modelPath);
+        if (found == meshRanges.end()) continue;
+
+        int layer;
+        unsigned int texture = textureOf(object, layer);
+        bool isArray = layer >= 0;
+        if (textureRanges.empty() || textureRanges.back().textureID != texture ||
+            textureRanges.back().isArray != isArray) {
+            TextureRange range;
+            range.textureID = texture;
+            range.isArray = isArray;
+            range.first = (unsigned int)commands.size();
+            range.count = 0;
+            textureRanges.push_back(range);
+        }
+
+        for (const auto& meshRange : found->second) {
+            DrawElementsIndirectCommand command;
+            command.count         = meshRange.indexCount;
+            command.instanceCount = 1;
+            command.firstIndex    = meshRange.firstIndex;
+            command.baseVertex    = meshRange.baseVertex;
+            command.baseInstance  = 0;
+            commands.push_back(command);
+
+            ObjectData data;
+            data.model    = object.transform;
+            data.color    = glm::vec4(0.7f, 0.7f, 0.7f, 1.0f);
+            data.material = glm::ivec4(object.hasTexture ? 1 : 0, layer, 0, 0);
+            objectData.push_back(data);
+
+            textureRanges.back().count++;
+        }
+    }
+
+    // orphaning: o driver aloca um novo armazenamento em vez de esperar os frames em voo
+    GLState::bindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand),
+                 commands.empty() ? NULL : commands.data(), GL_DYNAMIC_DRAW);
+
+    GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, objectBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, objectData.size() * sizeof(ObjectData),
+                 objectData.empty() ? NULL : objectData.data(), GL_DYNAMIC_DRAW);
+
+    commandCount = (unsigned int)commands.size();
+    triangleCount = 0;
+    for (const auto& command : commands) {
+        triangleCount += command.count / 3 * command.instanceCount;
+    }
+    commandRebuilds++;
+    dirty = false;
+}
+
+
+void StaticBatch::render(const vector<unique_ptr<OBJ3D>>& objects, const Shader& shader,
+                         const glm::mat4& view, const glm::mat4& projection, bool useTextureArray) {
+    PROFILE_SCOPE("StaticBatch::render");
+    multiDrawCalls = 0;
+    if (!isBuilt()) return;
+
+    // visibilidade de cada objeto neste frame, em pedaços de CULL_GRAIN objetos nas threads do JobSystem
+    Frustum frustum(projection * view);
+    currentVisibility.resize(objects.size());
+    JobSystem::parallelFor(objects.size(), CULL_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            currentVisibility[i] = frustum.intersects(objects[i]->getTransformedBoundingBox()) ? 1 : 0;
+        }
+    });
+    visibleObjects = 0;
+    for (uint8_t visible : currentVisibility) visibleObjects += visible;
+    culledObjects = (unsigned int)objects.size() - visibleObjects;
+
+    if (useTextureArray != commandsUseTextureArray) {
+        commandsUseTextureArray = useTextureArray;
+        dirty = true;
+    }
+
+    if (dirty || currentVisibility != visibility) {
+        visibility.swap(currentVisibility);
+        rebuildCommands(objects);
+    }
+
+    if (commands.empty()) return;
+
+    shader.use();
+    shader.setMat4("projection", projection);
+    shader.setMat4("view", view);
+    shader.setInt("diffuseMap", 0);
+    shader.setInt("diffuseArray", 1);
+
+    GLState::bindVertexArray(VAO);
+    GLState::bindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, objectBuffer);
+
+    for (const auto& range : textureRanges) {
+        if (range.isArray) {
+            GLState::bindTextureUnit(1, GL_TEXTURE_2D_ARRAY, range.textureID);
+        } else if (range.textureID != 0) {
+            GLState::bindTextureUnit(0, GL_TEXTURE_2D, range.textureID);
+        }
+        shader.setInt("drawOffset", (int)range.first);  // gl_DrawID recomeça em 0 a cada chamada
+
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                    (const void*)(range.first * sizeof(DrawElementsIndirectCommand)),
+                                    (GLsizei)range.count, 0);
+        multiDrawCalls++;
+    }
+}
+
+
+void StaticBatch::cleanup() {
+    if (VAO != 0)           { GLState::deleteVertexArray(VAO);     VAO = 0; }
+    if (VBO != 0)           { GLState::deleteBuffer(VBO);          VBO = 0; }
+    if (EBO != 0)           { GLState::deleteBuffer(EBO);          EBO = 0; }
+    if (commandBuffer != 0) { GLState::deleteBuffer(commandBuffer); commandBuffer = 0; }
+    if (objectBuffer != 0)  { GLState::deleteBuffer(objectBuffer);  objectBuffer = 0; }
+
+    meshRanges.clear();
+    visibility.clear();
+    commands.clear();
+    objectData.clear();
+    textureRanges.clear();
+    dirty = true;
+}
@@ -0,0 +1,44 @@
+#include "Stats.h"
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+double Stats::values[STAT_COUNT] = {};
+
+namespace {
+    const char* statNames[STAT_COUNT] = {
+        "frame_ms", "cpu_ms", "gpu_ms", "draw_calls", "triangles", "state_changes",
+        "visible_objects", "culled_objects", "projectiles", "collision_tests", "cpu_memory", "gpu_memory",
+        "assets_loaded", "assets_pending", "upload_bytes", "texture_resident", "texture_budget", "texture_pending",
+        "texture_evictions"
+    };
+}
+
+
+const char* Stats::name(StatId id) {
+    return id < STAT_COUNT ? statNames[id] : "";
+}
+
+
+size_t Stats::processMemory() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#else
+    // segundo campo de /proc/self/statm: páginas residentes
+    ifstream statm("/proc/self/statm");
+    size_t totalPages = 0, residentPages = 0;
+    if (statm >> totalPages >> residentPages) {
+        return residentPages * (size_t)sysconf(_SC_PAGESIZE);
+    }
+    return 0;
+#endif
+}
@@ -1,22 +1,70 @@
 #include "System.h"
+#include "GLState.h"
+#include "GLExtensions.h"
+#include "ProgramCache.h"
+#include "CameraPath.h"
+#include "AssetPack.h"
+#include "Profiler.h"
+#include "Stats.h"
+#include "JobSystem.h"
+#include "Log.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <set>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
 
 // Variáveis estáticas para controle de entrada
 static System* systemInstance = nullptr;
 static bool tiroDisparado = false;
+static bool teclaModoPressionada = false;
+static bool teclaInstanciasPressionada = false;
+static bool teclaTexturasPressionada = false;
+static bool teclaOverlayPressionada = false;
 
 System::System() : window(nullptr), 
-                   camera(glm::vec3(0.0f, 2.0f, 10.0f)),
+                   framebufferWidth(SCREEN_WIDTH),
+                   framebufferHeight(SCREEN_HEIGHT),
                    deltaTime(0.0f),
-                   lastFrame(0.0f),
+                   lastFrame(0.0),
+                   camera(glm::vec3(0.0f, 2.0f, 10.0f)),
+                   useMultiDraw(false),
+                   useInstancing(true),
+                   useTextureArrays(true),
+                   sceneFile("Configurador_Cena.txt"),
+                   sceneLoadMs(0.0),
+                   firstFrameMs(-1.0),
+                   asyncLoading(true),
+                   mipFilter(MIP_FILTER_GPU),
+                   sceneLoading(false),
+                   assetsReady(0),
+                   texturesArrived(false),
                    firstMouse(true),
                    lastX(SCREEN_WIDTH  / 2.0f),
-                   lastY(SCREEN_HEIGHT / 2.0f)
+                   lastY(SCREEN_HEIGHT / 2.0f),
+                   mouseDeltaX(0.0f),
+                   mouseDeltaY(0.0f),
+                   scrollDelta(0.0f),
+                   recordingInput(false),
+                   replayingInput(false),
+                   replayPosition(0),
+                   fixedDeltaTime(1.0f / 60.0f),
+                   simSceneVersion(0),
+                   appliedSceneVersion(0),
+                   fixedStep(false),
+                   tickTime(1.0f / 60.0f),
+                   maxSteps(5),
+                   stepAccumulator(0.0),
+                   stepCount(0),
+                   steppedFrames(0),
+                   clampedFrames(0)
 {
     systemInstance = this;
+    renderQueue.gpuTimer = &gpuTimer;   // a fila abre um intervalo de GPU por pass
 
     // Inicializando o array de controle das teclas
     for (int i = 0; i < 1024; i++) { keys[i] = false; }
@@ -27,13 +75,59 @@ System::~System() { shutdown(); }
 
 
 void System::shutdown() {
+    simulation.stop();      // a thread da simulação lê os objetos da cena
+    Log::flush();           // mensagens pendentes antes dos relatórios
+    bool context = hasContext();
+
+    if (context) {
+        renderQueue.printReport();  // relatório de mudanças de estado (antes x depois da fila)
+        GLState::printReport();     // chamadas emitidas x descartadas pelo cache de estado
+        ProgramCache::printReport();
+        gpuTimer.printReport();     // tempo de GPU médio por pass
+        textureStreamer.printReport();
+
+        if (fixedStep && steppedFrames > 0) {
+            cout << "Passo fixo: " << stepCount << " passos em " << steppedFrames << " frames ("
+                 << (double)stepCount / steppedFrames << " por frame), " << clampedFrames
+                 << " frames no limite de " << maxSteps << " passos" << endl;
+        }
+    }
+
+    if (context) {
+        if (staticBatch.isBuilt()) {
+            cout << "Multi-draw indirect: " << staticBatch.commandRebuilds
+                 << " reconstrucoes do buffer de comandos" << endl;
+        }
+        staticBatch.cleanup();  // libera os buffers compartilhados enquanto o contexto existe
+
+        if (instanceRenderer.isBuilt()) {
+            cout << "Instanciamento: " << instanceRenderer.uploadedInstances
+                 << " matrizes reenviadas ao instance buffer" << endl;
+        }
+        instanceRenderer.cleanup();
+        textureArrays.cleanup();
+        uploads.cleanup();
+        gpuTimer.cleanup();
+        overlay.cleanup();
+        shaders.cleanup();      // programas das variantes
+        projetilModel.reset();
+    }
+
+    assetLoader.stop();     // descarta o que ainda não foi lido
+    textureStreamer.stop();
+
+    simObjects.clear();
+    simProjeteis.clear();
     sceneObjects.clear();
     projeteis.clear();
+    meshCache.clear();
+    textureCache.clear();
     
     if (window) {
         glfwDestroyWindow(window);
         window = nullptr;
     }
+    headless.destroy();
     glfwTerminate();
 
     cout << "Desligamento do sistema concluido" << endl;
@@ -74,21 +168,44 @@ bool System::initializeGLFW() {
 }
 
 
+// Cria o contexto sem janela (EGL) e o FBO onde a cena será desenhada - ver HeadlessContext.h
+bool System::initializeHeadless(int width, int height) {
+    if (!headless.create(width, height)) {
+        return false;
+    }
+
+    framebufferWidth = width;
+    framebufferHeight = height;
+    return true;
+}
+
+
 // Inicializa OpenGL (GLAD, Viewport, Depth Test)
 bool System::initializeOpenGL() {
 
+    // as funções vêm da GLFW (janela) ou da EGL (modo headless)
+    GLADloadproc loader = window ? (GLADloadproc)glfwGetProcAddress : (GLADloadproc)HeadlessContext::getProcAddress;
+
     // GLAD: Inicializa e carrega todos os ponteiros de funções da OpenGL
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+    if (!gladLoadGLLoader(loader)) {
         cerr << "Falha ao inicializar GLAD" << endl;
         return false;
     }
+
+    // Funções de versões posteriores à 4.0 (multi-draw indirect, etc - ver GLExtensions.h)
+    GLExtensions::load(loader);
+
+    // deixa o driver escolher quantas threads usar para compilar shaders em segundo plano
+    if (GLExtensions::parallelShaderCompile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+    }
     
     // para desenhar apenas os fragmentos mais próximos da câmera
-    glEnable(GL_DEPTH_TEST);        // Ativa o teste de profundidade (z-buffer)
+    GLState::setDepthTest(true);    // Ativa o teste de profundidade (z-buffer)
     glClear(GL_DEPTH_BUFFER_BIT);   // Limpa o buffer de profundidade
 
     // Definindo as dimensões da viewport
-    glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    glViewport(0, 0, framebufferWidth, framebufferHeight);
     
     // Imprimir informações do OpenGL e Placa de Vídeo
     cout << "Versao OpenGL: " << glGetString(GL_VERSION) << endl;
@@ -102,28 +219,38 @@ bool System::initializeOpenGL() {
 
 // Carrega os shaders
 bool System::loadShaders() {
+    PROFILE_SCOPE("System::loadShaders");
+    auto inicio = chrono::steady_clock::now();  // tempo de preparação dos shaders (cache frio x quente)
+
     // Código fonte do Vertex Shader (em GLSL - Graphics Library Shading Language)
+    // Compilado em variantes: os blocos #ifdef dependem dos #define de ShaderPermutations
+    // (TEXTURED, INSTANCED, TEXTURE_ARRAY)
     string vertexShaderSource = R"(
         #version 400 core
         layout (location = 0) in vec3 coordenadasDaGeometria;
         layout (location = 1) in vec2 coordenadasDaTextura;
         layout (location = 2) in vec3 coordenadasDaNormal;
-        
+    #ifdef INSTANCED
+        layout (location = 3) in mat4 instanceModel; // matriz model por instância (ver InstanceRenderer)
+    #else
+        uniform mat4 model;
+    #endif
+    #ifdef TEXTURED
         out vec2 textureCoord;
+    #endif
         
-        uniform mat4 model;
         uniform mat4 view;
         uniform mat4 projection;
-        uniform bool isProjectile; // flag para diferenciar projéteis de objetos da cena
         
         void main() {
+        #ifdef INSTANCED
+            gl_Position = projection * view * instanceModel * vec4(coordenadasDaGeometria, 1.0);
+        #else
             gl_Position = projection * view * model * vec4(coordenadasDaGeometria, 1.0);
-            // Só passa coordenadas de textura se não for projétil
-            if (!isProjectile) {
-                textureCoord = coordenadasDaTextura;
-            } else {
-                textureCoord = vec2(0.0, 0.0); // valor padrão para projéteis
-            } 
+        #endif
+        #ifdef TEXTURED
+            textureCoord = coordenadasDaTextura; // projéteis e objetos sem textura não usam coordenadas de textura
+        #endif
         }
     )";
    		// "coordenadasDaGeometria" recebe as informações que estão no local 0 -> definidas em glVertexAttribPointer(0, xxxxxxxx);
@@ -141,39 +268,126 @@ bool System::loadShaders() {
         #version 400 core
         out vec4 FragColor;
         
+    #ifdef TEXTURED
         in vec2 textureCoord;
-        
+      #ifdef TEXTURE_ARRAY
+        uniform sampler2DArray diffuseArray; // texturas empacotadas (ver TextureArray)
+        uniform int textureLayer;            // camada de diffuseArray com a textura difusa
+      #else
         uniform sampler2D diffuseMap;
-        uniform sampler2D normalMap;
-        uniform bool hasDiffuseMap;
-        uniform bool hasNormalMap;
-        uniform bool isProjectile; // flag para diferenciar projéteis de objetos da cena
-        uniform vec3 objectColor;
+      #endif
+    #else
+        uniform vec3 objectColor;            // cor sólida (projéteis ou objetos sem textura)
+    #endif
         
         void main() {
+        #ifdef TEXTURED
+          #ifdef TEXTURE_ARRAY
+            vec3 result = texture(diffuseArray, vec3(textureCoord, textureLayer)).rgb;
+          #else
+            vec3 result = texture(diffuseMap, textureCoord).rgb;
+          #endif
+        #else
             vec3 result = objectColor;
-            
-            // Se não for projétil e tem textura, usa a textura
-            if (!isProjectile && hasDiffuseMap) {
-                result = texture(diffuseMap, textureCoord).rgb;
-            }
-            // Caso contrário, usa a cor sólida (para projéteis ou objetos sem textura)
+        #endif
             
             FragColor = vec4(result, 1.0);
         }
     )";
     
-    // Compila e linka os shaders
-    if (!mainShader.loadFromStrings(vertexShaderSource, fragmentShaderSource)) {
+    // Variantes usadas pela cena, compiladas (ou lidas do cache de programas) todas juntas no carregamento
+    shaders.setSources(vertexShaderSource, fragmentShaderSource);
+
+    shaders.prepare({ 0, SHADER_TEXTURED, SHADER_TEXTURED | SHADER_TEXTURE_ARRAY,
+                      SHADER_INSTANCED, SHADER_INSTANCED | SHADER_TEXTURED,
+                      SHADER_INSTANCED | SHADER_TEXTURED | SHADER_TEXTURE_ARRAY });
+
+    if (!shaders.get(0) || !shaders.get(SHADER_TEXTURED)) {
         return false;
     }
-    
+    if (!shaders.get(SHADER_INSTANCED)) {
+        cerr << "Falha ao compilar shaders de instancias - instanciamento desativado" << endl;
+    }
+
+    // Shader do caminho multi-draw indirect: model, cor e material de cada comando vêm de um SSBO,
+    // indexado por drawOffset + gl_DrawID (drawOffset = primeiro comando da chamada)
+    if (StaticBatch::isSupported()) {
+        string multiDrawVertexSource = R"(
+            #version 450 core
+            #extension GL_ARB_shader_draw_parameters : require
+            layout (location = 0) in vec3 coordenadasDaGeometria;
+            layout (location = 1) in vec2 coordenadasDaTextura;
+            layout (location = 2) in vec3 coordenadasDaNormal;
+
+            struct ObjectData {
+                mat4  model;
+                vec4  color;
+                ivec4 material; // x = tem textura, y = camada no texture array (-1 = diffuseMap)
+            };
+
+            layout (std430, binding = 0) readonly buffer ObjectBuffer {
+                ObjectData objects[];
+            };
+
+            out vec2 textureCoord;
+            flat out vec3 color;
+            flat out int hasDiffuseMap;
+            flat out int textureLayer;
+
+            uniform mat4 view;
+            uniform mat4 projection;
+            uniform int drawOffset;
+
+            void main() {
+                ObjectData object = objects[drawOffset + gl_DrawIDARB];
+                gl_Position = projection * view * object.model * vec4(coordenadasDaGeometria, 1.0);
+                textureCoord = coordenadasDaTextura;
+                color = object.color.rgb;
+                hasDiffuseMap = object.material.x;
+                textureLayer = object.material.y;
+            }
+        )";
+
+        string multiDrawFragmentSource = R"(
+            #version 450 core
+            out vec4 FragColor;
+
+            in vec2 textureCoord;
+            flat in vec3 color;
+            flat in int hasDiffuseMap;
+            flat in int textureLayer;
+
+            uniform sampler2D diffuseMap;
+            uniform sampler2DArray diffuseArray;
+
+            void main() {
+                vec3 result = color;
+                if (hasDiffuseMap != 0) {
+                    result = textureLayer >= 0 ? texture(diffuseArray, vec3(textureCoord, textureLayer)).rgb
+                                               : texture(diffuseMap, textureCoord).rgb;
+                }
+                FragColor = vec4(result, 1.0);
+            }
+        )";
+
+        if (!multiDrawShader.loadFromStrings(multiDrawVertexSource, multiDrawFragmentSource)) {
+            cerr << "Falha ao compilar shader multi-draw indirect - usando a fila de renderizacao" << endl;
+        }
+    }
+
+    overlay.initialize();   // sem o overlay (F3) o visualizador continua funcionando
+
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+    cout << "Shaders prontos em " << ms << " ms (" << ProgramCache::hits << " do cache de programas)" << endl;
+
     return true;
 }
 
 
 // Carrega os objetos na cena
 bool System::loadSceneObjects() {
+    PROFILE_SCOPE("System::loadSceneObjects");
+    loadStart = chrono::steady_clock::now();
                                                      // na apresentação: ver readFileConfiguration() logo abaixo
     auto sceneObjectsInfo = readFileConfiguration(); // lê as configurações dos objetos da cena, a partir do arquivo de configuração,
                                                      // e retorna um vetor (sceneObjectsInfo) de estruturas ObjectInfo
@@ -182,40 +396,361 @@ bool System::loadSceneObjects() {
         auto object = make_unique<OBJ3D>(sceneObject.name); // cria um novo objeto 3D com o nome
                                                             // especificado no arquivo de configuração
 
+        // Modelo já carregado por outro objeto: compartilha a malha (e os buffers OpenGL) em vez de reler o .obj
+        bool loaded = false;
+        auto cachedMesh = meshCache.find(sceneObject.modelPath);
+        if (cachedMesh != meshCache.end()) {
+            object->setMesh(cachedMesh->second, sceneObject.modelPath);
+            loaded = true;
+        }
+        // Carregamento assíncrono: a malha fica vazia (nada a desenhar) até a thread de trabalho lê-la;
+        // enquanto isso um cubo unitário serve de bounding box para as colisões
+        else if (asyncLoading) {
+            auto mesh = make_shared<Mesh>();
+            mesh->boundingBox.expand(vec3(-0.5f));
+            mesh->boundingBox.expand(vec3(0.5f));
+            meshCache[sceneObject.modelPath] = mesh;
+            object->setMesh(mesh, sceneObject.modelPath);
+            assetLoader.loadMesh(sceneObject.modelPath);
+            loaded = true;
+        }
         // Tenta carregar o modelo (arquivo .obj), se falhar não adiciona o objeto à cena
-        if (object->loadObject(sceneObject.modelPath)) {
+        else if (object->loadObject(sceneObject.modelPath)) {
+            meshCache[sceneObject.modelPath] = object->mesh;
+            loaded = true;
+        }
+
+        if (loaded) {
             object->setPosition(sceneObject.position);
             object->setRotation(sceneObject.rotation);
             object->setScale(sceneObject.scale);
             object->setEliminable(sceneObject.eliminable);
             
-            // Load texture if specified
+            // Load texture if specified (uma única textura OpenGL por arquivo)
             if (!sceneObject.texturePath.empty()) {
-                object->setTexture(sceneObject.texturePath);
+                auto cachedTexture = textureCache.find(sceneObject.texturePath);
+                if (cachedTexture != textureCache.end()) {
+                    object->setTexture(sceneObject.texturePath, cachedTexture->second);
+                } else if (textureStreamer.isEnabled()) {
+                    // só a cauda dos mipmaps, lida pelo TextureStreamer; os objetos a recebem em updateStreaming
+                    object->setTexture(sceneObject.texturePath, 0);
+                    textureCache[sceneObject.texturePath] = 0;
+                    textureStreamer.add(sceneObject.texturePath);
+                } else if (asyncLoading) {
+                    // sem textura (ID 0) até a imagem ser decodificada; a camada do array já sai pronta da thread
+                    object->setTexture(sceneObject.texturePath, 0);
+                    textureCache[sceneObject.texturePath] = 0;
+                    assetLoader.loadImage(sceneObject.texturePath, true, mipFilter);
+                } else {
+                    // a imagem é decodificada uma vez: a camada do texture array sai dos mesmos pixels
+                    unsigned int textureID = Texture::loadTexture(sceneObject.texturePath, &textureArrays);
+                    object->setTexture(sceneObject.texturePath, textureID);
+                    textureCache[sceneObject.texturePath] = textureID;
+                    if (textureID == 0) {
+                        LOG_ERROR("Falha ao carregar textura para objeto \"{}\": {}", sceneObject.name, sceneObject.texturePath);
+                    }
+                }
             }
 
             sceneObjects.push_back(move(object));   // adiciona o objeto 3D criado à lista de objetos da cena
 
-            cout << "Objeto carregado: " << sceneObject.name << endl;
+            if (!asyncLoading) LOG_INFO("Objeto carregado: {}", sceneObject.name);
         }
         else {
-            cout << "Falha ao carregar objeto: " << sceneObject.name
-                 << " de " << sceneObject.modelPath << endl;
+            LOG_WARNING("Falha ao carregar objeto: {} de {}", sceneObject.name, sceneObject.modelPath);
         }
     }
 
+    Log::flush();   // mensagens dos objetos antes dos relatórios da carga
+
+    if (textureStreamer.isEnabled()) {
+        uploads.initialize();   // os níveis pedidos são enviados em partes também no carregamento síncrono
+        cout << "Streaming de texturas: orcamento de " << textureStreamer.budgetBytes / (1024 * 1024)
+             << " MB, cauda de " << textureStreamer.tailSize << " texels" << endl;
+    }
+
+    if (asyncLoading && (!assetLoader.isDone() || textureStreamer.pendingTails() > 0)) {
+        sceneLoading = true;
+        uploads.initialize();
+        Stats::set(STAT_ASSETS_PENDING, (double)assetLoader.requestedCount());
+        cout << "Carregamento assincrono: " << sceneObjects.size() << " objetos, " << meshCache.size() << " malhas e "
+             << textureCache.size() << " texturas em " << JobSystem::threadCount() - 1 << " threads (mipmaps: "
+             << MipChain::filterName(mipFilter) << ", leitura: " << FileReader::backendName(assetLoader.readBackend())
+             << ")" << endl;
+        return true;
+    }
+
+    // carregamento síncrono: as caudas das texturas em streaming chegam antes do primeiro frame
+    if (textureStreamer.isEnabled()) {
+        textureStreamer.wait();
+        updateStreaming();
+    }
+
+    finalizeScene();
     return true;
 }
 
 
+// Cozinha (compressão em blocos + mipmaps, ver TextureCooker) cada textura usada pela cena, uma vez por arquivo
+bool System::cookTextures(const RunOptions& options) {
+    vector<string> paths;
+    set<string> seen;
+    for (const auto& object : readFileConfiguration()) {
+        if (!object.texturePath.empty() && seen.insert(object.texturePath).second) paths.push_back(object.texturePath);
+    }
+
+    if (paths.empty()) {
+        cerr << "Nenhuma textura na cena: " << sceneFile << endl;
+        return false;
+    }
+    return TextureCooker::cookAll(paths, options.cook, options.mipFilter);
+}
+
+
+// Empacota (ver AssetPack) a configuração da cena e cada modelo e textura que ela usa, uma vez por arquivo
+bool System::packAssets(const RunOptions& options) {
+    vector<ObjectInfo> objects = readFileConfiguration();
+    if (objects.empty()) {
+        cerr << "Nenhum objeto na cena: " << sceneFile << endl;
+        return false;
+    }
+
+    vector<string> paths = { sceneFile };
+    set<string> seen = { sceneFile };
+    for (const auto& object : objects) {
+        if (seen.insert(object.modelPath).second) paths.push_back(object.modelPath);
+        if (!object.texturePath.empty() && seen.insert(object.texturePath).second) paths.push_back(object.texturePath);
+    }
+    return AssetPack::build(options.packOutput, paths, options.packCompress);
+}
+
+
+// Passa à UploadQueue as malhas e imagens que as threads de trabalho terminaram e envia à OpenGL
+// a parte dos dados que cabe no limite do frame
+void System::updateLoading() {
+    if (!sceneLoading) return;
+    PROFILE_SCOPE("System::updateLoading");
+
+    vector<LoadedMesh> meshes;
+    vector<LoadedImage> images;
+    assetLoader.collect(meshes, images);
+
+    for (auto& loaded : meshes) {
+        if (!loaded.mesh) {
+            // mesmo resultado do carregamento síncrono: os objetos com o modelo saem da cena
+            LOG_WARNING("Falha ao carregar modelo: {}", loaded.path);
+            for (auto object = sceneObjects.begin(); object != sceneObjects.end();) {
+                if ((*object)->modelPath == loaded.path) object = sceneObjects.erase(object);
+                else ++object;
+            }
+            meshCache.erase(loaded.path);
+            assetsReady++;
+            continue;
+        }
+
+        // a malha compartilhada pelos objetos recebe os dados lidos (e a bounding box real)
+        shared_ptr<Mesh> mesh = meshCache[loaded.path];
+        mesh->vertices = move(loaded.mesh->vertices);
+        mesh->texCoords = move(loaded.mesh->texCoords);
+        mesh->normals = move(loaded.mesh->normals);
+        mesh->groups = move(loaded.mesh->groups);
+        mesh->boundingBox = loaded.mesh->boundingBox;
+
+        // buffers vazios agora, conteúdo em partes; cada grupo passa a ser desenhado quando o VAO é criado
+        for (auto& group : mesh->groups) {
+            group.createBuffers(false);
+            uploads.uploadBuffer(group.VBO, group.vertices.data(), group.vertices.size() * sizeof(float), mesh);
+            uploads.uploadBuffer(group.EBO, group.indices.data(), group.indices.size() * sizeof(unsigned int), mesh,
+                                 [&group]() { group.setupVertexArray(); });
+        }
+        uploads.uploadBuffer(0, nullptr, 0, mesh, [this]() { assetsReady++; });  // marca o fim da malha
+    }
+
+    // textura completa: entra no cache e passa aos objetos que a esperam (sem os mipmaps da CPU ou do
+    // arquivo cozido, glGenerateMipmap depois do nível 0)
+    auto completion = [this](const string& path, unsigned int textureID, bool generateMips) -> function<void()> {
+        return [this, path, textureID, generateMips]() {
+            if (generateMips) {
+                GLState::bindTexture(GL_TEXTURE_2D, textureID);
+                glGenerateMipmap(GL_TEXTURE_2D);
+            }
+            textureCache[path] = textureID;
+            texturesArrived = true;
+            assetsReady++;
+        };
+    };
+
+    for (auto& image : images) {
+        if (!image.data && !image.compressed) {
+            LOG_WARNING("Falha ao carregar textura: {}", image.path);
+            assetsReady++;
+            continue;
+        }
+
+        // textura cozida: os níveis já comprimidos seguem em ordem na fila; completa com o último
+        if (image.compressed) {
+            CookedTexture& cooked = image.cooked;
+            if (!cooked.layerLevels.empty()) {
+                textureArrays.addCompressedLayer(image.path, cooked.format, move(cooked.layerLevels));
+            }
+
+            const MipLevel& base = cooked.levels[0];
+            unsigned int textureID = Texture::allocateCompressed(base.width, base.height, cooked.format,
+                                                                 (int)cooked.levels.size());
+            GLenum format = Texture::compressedFormatFor(cooked.format);
+            auto levels = make_shared<vector<MipLevel>>(move(cooked.levels));
+            for (size_t level = 0; level < levels->size(); level++) {
+                const MipLevel& mip = (*levels)[level];
+                uploads.uploadCompressed(textureID, (int)level, mip.width, mip.height, format, mip.pixels.data(),
+                                         mip.pixels.size(), levels,
+                                         level + 1 == levels->size() ? completion(image.path, textureID, false) : nullptr);
+            }
+            continue;
+        }
+
+        if (image.layerSize > 0) {
+            textureArrays.addLayer(image.path, image.layerSize, move(image.layerPixels), move(image.layerMips));
+        }
+
+        // com os mipmaps gerados na CPU, os níveis seguem o nível 0 na fila e a textura fica completa
+        // com o último deles
+        bool cpuMips = !image.mips.empty();
+        unsigned int textureID = Texture::allocateTexture(image.width, image.height, image.channels, cpuMips);
+        function<void()> complete = completion(image.path, textureID, !cpuMips);
+
+        const unsigned char* pixels = image.data;
+        uploads.uploadTexture(textureID, 0, image.width, image.height, image.channels, pixels,
+                              AssetLoader::takeData(image), cpuMips ? nullptr : complete);
+
+        auto mips = make_shared<vector<MipLevel>>(move(image.mips));
+        for (size_t level = 0; level < mips->size(); level++) {
+            const MipLevel& mip = (*mips)[level];
+            uploads.uploadTexture(textureID, (int)level + 1, mip.width, mip.height, image.channels, mip.pixels.data(),
+                                  mips, level + 1 == mips->size() ? complete : nullptr);
+        }
+    }
+
+    uploads.update();
+
+    // objetos que esperavam uma das texturas completadas neste frame
+    if (texturesArrived) {
+        for (auto& object : sceneObjects) {
+            if (object->hasTexture || object->texturePath.empty()) continue;
+            auto texture = textureCache.find(object->texturePath);
+            if (texture != textureCache.end() && texture->second != 0) {
+                object->setTexture(object->texturePath, texture->second);
+            }
+        }
+        texturesArrived = false;
+    }
+
+    Stats::set(STAT_UPLOAD_BYTES, (double)uploads.lastFrameBytes());
+    Stats::set(STAT_ASSETS_LOADED, (double)assetsReady);
+    Stats::set(STAT_ASSETS_PENDING, (double)(assetLoader.requestedCount() - assetsReady));
+
+    if (assetLoader.isDone() && uploads.isIdle() && textureStreamer.pendingTails() == 0) {
+        sceneLoading = false;
+        finalizeScene();
+    }
+}
+
+
+void System::finishLoading() {
+    while (sceneLoading) {
+        assetLoader.wait();
+        textureStreamer.wait();
+        updateStreaming();
+        updateLoading();
+    }
+}
+
+
+void System::finalizeScene() {
+    PROFILE_SCOPE("System::finalizeScene");
+
+    // Empacota as texturas da cena em texture arrays (uma camada por arquivo; as camadas já
+    // saem prontas das threads ou de Texture::loadTexture, addTexture só decodifica o que faltar).
+    // Com streaming não há arrays: cada camada ficaria residente em tamanho cheio
+    for (const auto& texture : textureCache) {
+        if (texture.second != 0 && !textureStreamer.isEnabled()) textureArrays.addTexture(texture.first);
+    }
+    if (textureArrays.build()) {
+        for (auto& object : sceneObjects) {
+            if (object->hasTexture) object->arrayTexture = textureArrays.find(object->texturePath);
+        }
+    }
+
+    // Objetos repetidos (mesma malha e textura) passam a ser desenhados por instanciamento
+    if (shaders.get(SHADER_INSTANCED) != nullptr) {
+        instanceRenderer.build(sceneObjects);
+    }
+
+    // Copia a geometria estática para os buffers compartilhados do caminho multi-draw indirect
+    if (multiDrawShader.ID != 0) {
+        staticBatch.build(sceneObjects);
+    }
+
+    sceneLoadMs = chrono::duration<double, milli>(chrono::steady_clock::now() - loadStart).count();
+    cout << "Cena carregada: " << sceneObjects.size() << " objetos, " << meshCache.size() << " malhas, "
+         << textureCache.size() << " texturas em " << sceneLoadMs << " ms" << endl;
+    if (assetLoader.bytesRead() > 0) {
+        cout << "Leitura em lote (" << FileReader::backendName(assetLoader.readBackend()) << "): "
+             << assetLoader.bytesRead() / (1024 * 1024) << " MB" << endl;
+    }
+}
+
+
+void System::updateStreaming() {
+    if (!textureStreamer.isEnabled()) return;
+    PROFILE_SCOPE("System::updateStreaming");
+
+    // tamanho de cada objeto na tela: diagonal da bounding box, projetada à distância da face mais próxima
+    // (calculado nas threads do JobSystem; o registro no TextureStreamer fica na thread principal)
+    float pixelsPerUnit = framebufferHeight / (2.0f * std::tan(radians(camera.Zoom) * 0.5f));
+    vector<float> screenPixels(sceneObjects.size());
+    JobSystem::parallelFor(sceneObjects.size(), 64, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            if (!sceneObjects[i]->hasTexture) continue;
+            BoundingBox box = sceneObjects[i]->getTransformedBoundingBox();
+            float size = length(box.max - box.min);
+            float distance = std::max(length(box.center() - camera.Position) - 0.5f * size, 0.1f);
+            screenPixels[i] = size * pixelsPerUnit / distance;
+        }
+    });
+    for (size_t i = 0; i < sceneObjects.size(); i++) {
+        if (sceneObjects[i]->hasTexture) textureStreamer.use(sceneObjects[i]->textureID, screenPixels[i]);
+    }
+
+    // caudas que chegaram: a textura passa aos objetos que a esperam
+    vector<pair<string, unsigned int>> arrived;
+    textureStreamer.update(arrived);
+    for (const auto& texture : arrived) textureCache[texture.first] = texture.second;
+    if (!arrived.empty()) {
+        for (auto& object : sceneObjects) {
+            if (object->hasTexture || object->texturePath.empty()) continue;
+            auto texture = textureCache.find(object->texturePath);
+            if (texture != textureCache.end() && texture->second != 0) {
+                object->setTexture(object->texturePath, texture->second);
+            }
+        }
+    }
+
+    if (!sceneLoading) uploads.update();    // durante o carregamento os envios seguem em updateLoading
+}
+
+
 // Carrega as informações/configurações dos objetos da cena a partir do arquivo de configuração da cena - "Configurador_Cena.txt"
+// (ou o arquivo de --scene, ex.: uma cena gerada por SceneGenerator)
 // (Nome Path posX posY posZ rotX rotY rotZ scaleX scaleY scaleZ Eliminável(S/N) TexturePath)
 vector<ObjectInfo> System::readFileConfiguration() {
 
     vector<ObjectInfo> sceneObjectsInfo;  // ObjectInfo é uma estrutura para armazenar informações sobre um determinado objeto 3D
                                           // sceneObjectsInfo é um vetor que armazena várias dessas estruturas (qtd = nº de objetos da cena)
 
-    ifstream configFile("Configurador_Cena.txt");   // abre o arquivo de configuração para leitura
+    AssetStream configFile(sceneFile);  // abre o arquivo de configuração para leitura (pacote ou disco)
+    if (!configFile) {
+        cerr << "Falha ao abrir configuracao da cena: " << sceneFile << endl;
+    }
 
     string line;  // variável temporária para armazenar cada linha lida do arquivo de configuração
 
@@ -251,98 +786,293 @@ vector<ObjectInfo> System::readFileConfiguration() {
 }
 
 
-// Processa a entrada do usuário
+// Processa a entrada do usuário (ou o próximo frame da gravação, no modo de reprodução)
 void System::processInput() {
+    PROFILE_SCOPE("System::processInput");
+    FrameInput input;
+
+    if (replayingInput) {
+        if (replayPosition < inputRecording.size()) {
+            input = inputRecording.frames[replayPosition++];
+        }
+        // o mouse real é descartado; ESC continua encerrando
+        mouseDeltaX = mouseDeltaY = scrollDelta = 0.0f;
+        if (window && glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+            glfwSetWindowShouldClose(window, true);
+    } else {
+        input = readInput();
+        if (recordingInput) inputRecording.frames.push_back(input);
+    }
+
+    applyInput(input);
+}
+
+
+// Lê o estado do teclado e o movimento do mouse acumulado pelos callbacks
+FrameInput System::readInput() {
+    FrameInput input;
 
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
-    
-    // movimentação da câmera
+
     if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
-        camera.ProcessKeyboard(FORWARD, deltaTime);
+        input.buttons |= INPUT_FORWARD;
     if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
-        camera.ProcessKeyboard(BACKWARD, deltaTime);
+        input.buttons |= INPUT_BACKWARD;
     if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
-        camera.ProcessKeyboard(LEFT, deltaTime);
+        input.buttons |= INPUT_LEFT;
     if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
-        camera.ProcessKeyboard(RIGHT, deltaTime);
+        input.buttons |= INPUT_RIGHT;
+    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) input.buttons |= INPUT_SHOOT;
+    if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS)     input.buttons |= INPUT_TOGGLE_MULTIDRAW;
+    if (glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS)     input.buttons |= INPUT_TOGGLE_INSTANCING;
+    if (glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS)     input.buttons |= INPUT_TOGGLE_TEXTURES;
+    if (glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS)    input.buttons |= INPUT_TOGGLE_OVERLAY;
+
+    input.mouseX = mouseDeltaX;
+    input.mouseY = mouseDeltaY;
+    input.scroll = scrollDelta;
+    mouseDeltaX = mouseDeltaY = scrollDelta = 0.0f;
+
+    return input;
+}
+
+
+// Aplica a entrada de um frame (real ou reproduzida) à câmera, aos disparos e aos modos de renderização
+void System::applyInput(const FrameInput& input) {
+    applySimulationInput(input, camera, projeteis, deltaTime, true);
+    applyRenderToggles(input);
+}
+
+
+// Câmera e disparos: com --sim-thread, executada pela thread da simulação (câmera e projéteis dela)
+void System::applySimulationInput(const FrameInput& input, Camera& target, vector<unique_ptr<Projetil>>& shots,
+                                  float dt, bool createMesh) {
+
+    // movimentação da câmera
+    if (input.buttons & INPUT_FORWARD)  target.ProcessKeyboard(FORWARD, dt);
+    if (input.buttons & INPUT_BACKWARD) target.ProcessKeyboard(BACKWARD, dt);
+    if (input.buttons & INPUT_LEFT)     target.ProcessKeyboard(LEFT, dt);
+    if (input.buttons & INPUT_RIGHT)    target.ProcessKeyboard(RIGHT, dt);
+
+    if (input.mouseX != 0.0f || input.mouseY != 0.0f)
+        target.ProcessMouseMovement(input.mouseX, input.mouseY, true);
+    if (input.scroll != 0.0f)
+        target.ProcessMouseScroll(input.scroll);
     
     // Disparo
-    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS && !tiroDisparado) {
-        disparo();
+    if ((input.buttons & INPUT_SHOOT) && !tiroDisparado) {
+        disparo(target, shots, createMesh);
         tiroDisparado = true;
     }
-    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_RELEASE) {
+    if (!(input.buttons & INPUT_SHOOT)) {
         tiroDisparado = false;
     }
 }
 
 
+// Modos de renderização (sempre na thread principal)
+void System::applyRenderToggles(const FrameInput& input) {
+
+    // Alterna entre a fila de renderização e o multi-draw indirect
+    if ((input.buttons & INPUT_TOGGLE_MULTIDRAW) && !teclaModoPressionada) {
+        teclaModoPressionada = true;
+        if (staticBatch.isBuilt()) {
+            useMultiDraw = !useMultiDraw;
+            cout << "Renderizacao: " << (useMultiDraw ? "multi-draw indirect" : "fila de renderizacao") << endl;
+        } else {
+            cout << "Multi-draw indirect indisponivel neste contexto" << endl;
+        }
+    }
+    if (!(input.buttons & INPUT_TOGGLE_MULTIDRAW)) {
+        teclaModoPressionada = false;
+    }
+
+    // Liga/desliga o instanciamento dos objetos repetidos
+    if ((input.buttons & INPUT_TOGGLE_INSTANCING) && !teclaInstanciasPressionada) {
+        teclaInstanciasPressionada = true;
+        useInstancing = !useInstancing;
+        cout << "Instanciamento: " << (useInstancing ? "ativado" : "desativado") << endl;
+    }
+    if (!(input.buttons & INPUT_TOGGLE_INSTANCING)) {
+        teclaInstanciasPressionada = false;
+    }
+
+    // Alterna entre texturas 2D individuais e texture arrays
+    if ((input.buttons & INPUT_TOGGLE_TEXTURES) && !teclaTexturasPressionada) {
+        teclaTexturasPressionada = true;
+        if (textureArrays.isBuilt()) {
+            useTextureArrays = !useTextureArrays;
+            cout << "Texturas: " << (useTextureArrays ? "texture arrays" : "texturas individuais") << endl;
+        } else {
+            cout << "Texture arrays indisponiveis" << endl;
+        }
+    }
+    if (!(input.buttons & INPUT_TOGGLE_TEXTURES)) {
+        teclaTexturasPressionada = false;
+    }
+
+    // Mostra/oculta o overlay de desempenho
+    if ((input.buttons & INPUT_TOGGLE_OVERLAY) && !teclaOverlayPressionada) {
+        teclaOverlayPressionada = true;
+        overlay.visible = !overlay.visible && overlay.isInitialized();
+    }
+    if (!(input.buttons & INPUT_TOGGLE_OVERLAY)) {
+        teclaOverlayPressionada = false;
+    }
+}
+
+
 // Renderiza a cena
 void System::render() {
+    PROFILE_SCOPE("System::render");
+
+    // resultados de GPU de frames anteriores que já terminaram (sem esperar pelos demais)
+    gpuTimer.beginFrame();
+    for (const auto& frame : gpuTimer.newlyResolved()) {
+        timings.setGpuTime(frame.first, (float)frame.second);
+    }
+
+    gpuTimer.beginPass("Clear");
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // Calcula a matriz de projeção - glm::perspective(FOV, razão de aspecto, Near, Far) - razão de aspecto = largura/altura
-    glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCREEN_WIDTH / (float)SCREEN_HEIGHT, 0.1f, 100.0f);
+    glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)framebufferWidth / (float)framebufferHeight, 0.1f, 100.0f);
 
     // Calcula a matriz de visualização - glm::lookAt(posição da câmera, ponto para onde a câmera está olhando, vetor up da câmera)
     glm::mat4 view = camera.GetViewMatrix(); // glm::lookAt(Position, Position + Front, Up)
     
-    // renderiza objetos da cena
-    mainShader.use();
-    mainShader.setMat4("projection", projection);
-    mainShader.setMat4("view", view);
-    //mainShader.setVec3("viewPos", camera.Position);
-    mainShader.setBool("isProjectile", false); // objetos da cena não são projéteis
-    mainShader.setVec3("objectColor", 1.0f, 1.0f, 1.0f);
-    
-    for (const auto& obj : sceneObjects) { // renderiza cada objeto da cena
-        obj->render(mainShader);
+    // coleta os pacotes de desenho do frame: objetos da cena e projéteis
+    renderQueue.clear();
+
+    // texturas amostradas das camadas dos texture arrays (um bind por array em vez de um por textura)
+    bool textureArray = useTextureArrays && textureArrays.isBuilt();
+
+    // no modo multi-draw indirect os objetos da cena são desenhados pelo staticBatch;
+    // a fila continua responsável pelos projéteis
+    if (useMultiDraw && staticBatch.isBuilt()) {
+        gpuTimer.beginPass(RenderQueue::passName(PASS_OPAQUE));
+        staticBatch.render(sceneObjects, multiDrawShader, view, projection, textureArray);
+    } else {
+        const float farPlane = 100.0f;
+        bool instancing = useInstancing && instanceRenderer.isBuilt();
+
+        if (instancing) {
+            instanceRenderer.update();  // reenvia só as matrizes que mudaram
+            instanceRenderer.enqueue(renderQueue, shaders, camera.Position, 1.0f / farPlane, textureArray);
+        }
+
+        for (const auto& obj : sceneObjects) {
+            if (instancing && instanceRenderer.isInstanced(obj.get())) continue;
+            obj->enqueue(renderQueue, shaders, camera.Position, 1.0f / farPlane, textureArray);
+        }
     }
-    
-    // Render projeteis
-    mainShader.setBool("isProjectile", true); // agora renderizando projéteis
-    mainShader.setBool("hasDiffuseMap", false); // projéteis não usam texturas
-    
+
     for (const auto& projetil : projeteis) {
         if (projetil->isActive()) {
-            projetil->draw(mainShader);
+            projetil->enqueue(renderQueue, shaders);
         }
     }
+
+    // projéteis da thread de simulação: uma malha só, na posição interpolada de cada um
+    for (const vec3& position : projectilePositions) {
+        projetilModel->position = position;
+        projetilModel->enqueue(renderQueue, shaders);
+    }
+
+    // ordena pela chave (pass, shader, textura, malha, profundidade) e submete sem binds redundantes
+    renderQueue.flush(view, projection);
+
+    // carga do frame para o overlay e o relatório de tempos
+    const RenderStats& stats = renderQueue.stats;
+    Stats::set(STAT_DRAW_CALLS, stats.drawCalls);
+    Stats::set(STAT_TRIANGLES, (double)stats.triangles);
+    Stats::set(STAT_STATE_CHANGES, stats.stateChanges());
+    Stats::set(STAT_GPU_MS, gpuTimer.lastFrameMs);
+    if (useMultiDraw && staticBatch.isBuilt()) {
+        Stats::add(STAT_DRAW_CALLS, staticBatch.multiDrawCalls);
+        Stats::add(STAT_TRIANGLES, staticBatch.triangleCount);
+        Stats::set(STAT_VISIBLE_OBJECTS, staticBatch.visibleObjects);
+        Stats::set(STAT_CULLED_OBJECTS, staticBatch.culledObjects);
+    } else {
+        Stats::set(STAT_VISIBLE_OBJECTS, (double)sceneObjects.size());    // a fila não faz culling
+        Stats::set(STAT_CULLED_OBJECTS, 0);
+    }
+
+    // o overlay é desenhado por último, sobre a cena, com seu próprio intervalo de GPU
+    if (overlay.visible) {
+        gpuTimer.beginPass("Overlay");
+        overlay.render(framebufferWidth, framebufferHeight);
+    }
+    gpuTimer.endFrame();
+}
+
+
+void System::recordFrame(float cpuMs, float frameMs, bool keepTiming) {
+    if (firstFrameMs < 0.0) {
+        firstFrameMs = chrono::duration<double, milli>(chrono::steady_clock::now() - loadStart).count();
+        cout << "Primeiro frame em " << firstFrameMs << " ms desde o inicio do carregamento ("
+             << (asyncLoading ? "assincrono" : "sincrono") << ")" << endl;
+    }
+
+    Stats::set(STAT_CPU_MS, cpuMs);
+    Stats::set(STAT_FRAME_MS, frameMs);
+    overlay.recordFrame(frameMs);
+
+    if (keepTiming) {
+        timings.record(cpuMs, frameMs, (unsigned int)Stats::get(STAT_DRAW_CALLS),
+                       (unsigned long long)Stats::get(STAT_TRIANGLES), gpuTimer.currentFrame());
+    }
 }
 
 
 // realiza o disparo de um projétil a partir da posição e direção da câmera
-void System::disparo() {
-    glm::vec3 projetilPos = camera.Position + camera.Front * 0.5f;  // posição inicial do projétil ligeiramente à frente da câmera
+void System::disparo(const Camera& origem, vector<unique_ptr<Projetil>>& destino, bool createMesh) {
+    glm::vec3 projetilPos = origem.Position + origem.Front * 0.5f;  // posição inicial do projétil ligeiramente à frente da câmera
                                                                     // para evitar colisão imediata com a própria câmera
-    glm::vec3 projetilDir = camera.Front; // Retorna a direção da câmera para disparo
+    glm::vec3 projetilDir = origem.Front; // Retorna a direção da câmera para disparo
 
-    auto projetil = std::make_unique<Projetil>(projetilPos, projetilDir, 10.0f, 5.0f); // cria um novo projétil
-    projeteis.push_back(std::move(projetil));   // adiciona o projétil à lista de projéteis ativos
+    auto projetil = std::make_unique<Projetil>(projetilPos, projetilDir, 10.0f, 5.0f, createMesh); // cria um novo projétil
+    destino.push_back(std::move(projetil));     // adiciona o projétil à lista de projéteis ativos
 }
 
 
-// Atualiza a posição dos projéteis e remove os inativos
-void System::updateProjeteis() {
-    for (auto& projetil : projeteis) {
-        if (projetil->isActive()) {
-            projetil->update(deltaTime);
+namespace {
+    // Atualiza a posição dos projéteis e remove os inativos (lista da thread principal ou da simulação)
+    void advanceProjeteis(vector<unique_ptr<Projetil>>& projeteis, float deltaTime) {
+        for (auto& projetil : projeteis) {
+            if (projetil->isActive()) {
+                projetil->update(deltaTime);
+            }
         }
+
+        // Remove projeteis inativos
+        projeteis.erase(remove_if(projeteis.begin(), projeteis.end(),
+                                    [](const unique_ptr<Projetil>& projetil) {
+                                        return !projetil->isActive();
+                                    }), projeteis.end());
     }
-    
-    // Remove projeteis inativos
-    projeteis.erase(remove_if(projeteis.begin(), projeteis.end(),
-                                [](const unique_ptr<Projetil>& projetil) {
-                                    return !projetil->isActive();
-                                }), projeteis.end());
+}
+
+
+// Atualiza a posição dos projéteis e remove os inativos
+void System::updateProjeteis() {
+    PROFILE_SCOPE("System::updateProjeteis");
+    advanceProjeteis(projeteis, deltaTime);
+    Stats::set(STAT_PROJECTILES, (double)projeteis.size());
 }
 
 
 // funções de callback estáticas
 void System::framebuffer_size_callback(GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
+
+    // janela minimizada tem tamanho 0: mantém a razão de aspecto anterior
+    if (systemInstance && width > 0 && height > 0) {
+        systemInstance->framebufferWidth = width;
+        systemInstance->framebufferHeight = height;
+    }
 }
 
 
@@ -362,14 +1092,16 @@ void System::mouse_callback(GLFWwindow* window, double xpos, double ypos) {
     systemInstance->lastX = xpos;
     systemInstance->lastY = ypos;
     
-    systemInstance->camera.ProcessMouseMovement(xoffset, yoffset, true);
+    // aplicado à câmera em processInput, junto com o restante da entrada do frame (e gravado, se for o caso)
+    systemInstance->mouseDeltaX += xoffset;
+    systemInstance->mouseDeltaY += yoffset;
 }
 
 
 // scroll_callback para zoom da câmera
 void System::scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
     if (systemInstance) {
-        systemInstance->camera.ProcessMouseScroll(yoffset);
+        systemInstance->scrollDelta += yoffset;
     }
 }
 
@@ -387,51 +1119,579 @@ void System::key_callback(GLFWwindow* window, int key, int scancode, int action,
 }
 
 
-// Verifica colisões entre projéteis e objetos da cena - tem problema na reflexão!
-void System::checkCollisions() {
-    const float MIN_DISTANCE = 0.1f; // Distância mínima segura antes de verificar colisões
+namespace {
+    // Colisões entre os projéteis e uma lista de objetos (os unique_ptr de sceneObjects, ou os ponteiros
+    // da simulação): reflete os projéteis e marca em "removed" os objetos eliminados, sem removê-los.
+    // Retorna true se algum foi eliminado
+    template <typename ObjectList>
+    bool resolveCollisions(vector<unique_ptr<Projetil>>& projeteis, const ObjectList& objects, float deltaTime,
+                           vector<bool>& removed, unsigned int& testCount) {
+        const float MIN_DISTANCE = 0.1f; // Distância mínima segura antes de verificar colisões
+        const size_t COLLISION_GRAIN = 64;  // objetos por job
+        const size_t NO_HIT = (size_t)-1;
+        testCount = 0;
 
-    for (auto& projetil : projeteis) {
-        if (!projetil->isActive()) continue;
-        
         // Só verifica colisões se o projétil já percorreu distância mínima
-        if (projetil->lifetime < MIN_DISTANCE / projetil->speed) {
-            continue;
+        vector<Projetil*> candidates;
+        for (auto& projetil : projeteis) {
+            if (projetil->isActive() && projetil->lifetime >= MIN_DISTANCE / projetil->speed) {
+                candidates.push_back(projetil.get());
+            }
         }
+        if (candidates.empty() || objects.empty()) return false;
 
-        for (auto sceneObject = sceneObjects.begin(); sceneObject != sceneObjects.end();) {
+        // Colisão no próximo frame (não imediatamente): o raio do projétil atinge o objeto dentro do passo
+        auto hits = [&](const Projetil& projetil, const OBJ3D& object) {
             float distance;
-            
-            // Calcular próxima posição do projétil para verificação de colisão
-            glm::vec3 nextPosition = projetil->position + projetil->direction * projetil->speed * deltaTime;
-            
-            if ((*sceneObject)->rayIntersect(projetil->position, projetil->direction, distance)) {
-                // Verificar se a colisão acontecerá no próximo frame (não imediatamente)
-                if (distance <= projetil->speed * deltaTime * 1.1f && distance > 0.0f) {
-                    if ((*sceneObject)->isEliminable()) {
-                        cout << "Objeto \"" << (*sceneObject)->name << "\" eliminado!" << endl;
-                        sceneObject = sceneObjects.erase(sceneObject);
-                        projetil->desativar();
-                    } else {
-                        // Calcular ponto de impacto mais preciso
-                        glm::vec3 hitPoint = projetil->position + projetil->direction * distance;
-                        BoundingBox bbox = (*sceneObject)->getTransformedBoundingBox();
-                        glm::vec3 center = bbox.center();
-                        glm::vec3 normal = glm::normalize(hitPoint - center);
-                        
-                        // Mover projétil para posição de colisão antes de refletir
-                        projetil->position = hitPoint + normal * 0.01f; // Pequeno offset para evitar re-colisão
-                        projetil->reflect(normal);
-                        cout << "Tiro refletiu em \"" << (*sceneObject)->name << "\"!" << endl;
-                        ++sceneObject;
-                    }
+            return object.rayIntersect(projetil.position, projetil.direction, distance) &&
+                   distance <= projetil.speed * deltaTime * 1.1f && distance > 0.0f;
+        };
+
+        // Fase paralela (JobSystem): os objetos são divididos entre as threads e cada projétil guarda o
+        // primeiro objeto, na ordem da cena, que ele atinge - o mesmo que o teste em série encontraria
+        vector<atomic<size_t>> firstHit(candidates.size());
+        for (auto& hit : firstHit) hit.store(NO_HIT, memory_order_relaxed);
+        atomic<unsigned int> tests(0);
+
+        JobSystem::parallelFor(objects.size(), COLLISION_GRAIN, [&](size_t begin, size_t end) {
+            unsigned int chunkTests = 0;
+            for (size_t p = 0; p < candidates.size(); p++) {
+                for (size_t i = begin; i < end && i < firstHit[p].load(memory_order_relaxed); i++) {
+                    chunkTests++;
+                    if (!hits(*candidates[p], *objects[i])) continue;
+
+                    size_t current = firstHit[p].load(memory_order_relaxed);
+                    while (i < current && !firstHit[p].compare_exchange_weak(current, i, memory_order_relaxed)) {}
                     break;
-                } else {
-                    ++sceneObject; // Colisão muito distante, continua verificando
                 }
+            }
+            tests.fetch_add(chunkTests, memory_order_relaxed);
+        });
+        testCount = tests.load();
+
+        // Fase em série, na ordem dos projéteis: eliminações e reflexões (um objeto eliminado por um
+        // projétil anterior sai da disputa; o projétil segue para o próximo objeto que atinge)
+        removed.assign(objects.size(), false);
+        bool anyRemoved = false;
+        for (size_t p = 0; p < candidates.size(); p++) {
+            Projetil* projetil = candidates[p];
+            size_t index = firstHit[p].load(memory_order_relaxed);
+            while (index != NO_HIT && removed[index]) {
+                size_t next = NO_HIT;
+                for (size_t i = index + 1; i < objects.size() && next == NO_HIT; i++) {
+                    if (!removed[i] && hits(*projetil, *objects[i])) next = i;
+                }
+                index = next;
+            }
+            if (index == NO_HIT) continue;
+
+            const OBJ3D& sceneObject = *objects[index];
+            if (sceneObject.isEliminable()) {
+                LOG_INFO("Objeto \"{}\" eliminado!", sceneObject.name);
+                removed[index] = anyRemoved = true;
+                projetil->desativar();
+            } else {
+                // Calcular ponto de impacto mais preciso
+                float distance;
+                sceneObject.rayIntersect(projetil->position, projetil->direction, distance);
+                glm::vec3 hitPoint = projetil->position + projetil->direction * distance;
+                BoundingBox bbox = sceneObject.getTransformedBoundingBox();
+                glm::vec3 center = bbox.center();
+                glm::vec3 normal = glm::normalize(hitPoint - center);
+
+                // Mover projétil para posição de colisão antes de refletir
+                projetil->position = hitPoint + normal * 0.01f; // Pequeno offset para evitar re-colisão
+                projetil->reflect(normal);
+                LOG_INFO("Tiro refletiu em \"{}\"!", sceneObject.name);
+            }
+        }
+        return anyRemoved;
+    }
+
+    // Retira da lista os objetos marcados, mantendo a ordem dos demais
+    template <typename ObjectList>
+    void removeMarked(ObjectList& objects, const vector<bool>& removed) {
+        size_t kept = 0;
+        for (size_t i = 0; i < objects.size(); i++) {
+            if (!removed[i]) objects[kept++] = move(objects[i]);
+        }
+        objects.resize(kept);
+    }
+}
+
+
+// Verifica colisões entre projéteis e objetos da cena - tem problema na reflexão!
+void System::checkCollisions() {
+    PROFILE_SCOPE("System::checkCollisions");
+    vector<bool> removed;
+    unsigned int tests;
+
+    if (resolveCollisions(projeteis, sceneObjects, deltaTime, removed, tests)) {
+        for (size_t i = 0; i < sceneObjects.size(); i++) {
+            if (removed[i]) instanceRenderer.remove(sceneObjects[i].get());   // antes de destruir o objeto
+        }
+        removeMarked(sceneObjects, removed);
+        staticBatch.markDirty();    // o conjunto de objetos mudou
+    }
+
+    Stats::set(STAT_COLLISION_TESTS, tests);
+}
+
+// Estado inicial da simulação (--sim-thread ou --fixed-step). Com a cena completa, objetos e malhas não
+// mudam mais fora dela: a simulação lê as bounding boxes sem trava e a thread principal só destrói um
+// objeto depois que um snapshot sem ele foi publicado
+void System::prepareSimulation() {
+    finishLoading();
+
+    simCamera = camera;
+    simProjeteis.clear();
+    simObjects.clear();
+    for (auto& object : sceneObjects) simObjects.push_back(object.get());
+    simSceneVersion = appliedSceneVersion = 0;
+
+    projetilModel.reset(new Projetil());    // VAO do cubo, compartilhado por todos os projéteis desenhados
+    projetilModel->active = true;
+}
+
+
+// Passa a câmera, os projéteis e as eliminações para a thread da simulação (--sim-thread)
+void System::startSimulation(float tickTime) {
+    prepareSimulation();
+
+    simulation.start(tickTime, [this](const FrameInput& input, float dt, SimulationSnapshot& snapshot) {
+        return simulate(input, dt, snapshot);
+    });
+    cout << "Simulacao em thread propria: " << 1.0f / tickTime << " passos/s" << endl;
+}
+
+
+// Simulação com passo fixo na thread principal (--fixed-step)
+void System::startFixedStep(float stepTime, int stepLimit) {
+    prepareSimulation();
+
+    fixedStep = true;
+    tickTime = stepTime;
+    maxSteps = std::max(1, stepLimit);
+    stepAccumulator = 0.0;
+    stepSnapshot = SimulationSnapshot();
+    cout << "Passo fixo: " << 1.0f / tickTime << " passos/s, no maximo " << maxSteps << " por frame" << endl;
+}
+
+
+// Thread principal, a cada frame: a entrada vai para o próximo passo da simulação e o estado do último
+// passo volta interpolado (câmera, projéteis, objetos eliminados)
+void System::syncSimulation(double frameTime) {
+    PROFILE_SCOPE("System::syncSimulation");
+
+    // na reprodução a simulação lê a gravação: do teclado só vale o ESC (tratado em readInput)
+    if (window) {
+        FrameInput input = readInput();
+        if (!replayingInput) {
+            if (fixedStep) stepInput.push(input);
+            else           simulation.pushInput(input);
+            applyRenderToggles(input);
+        }
+    }
+
+    if (!fixedStep) {
+        float alpha;
+        const SimulationSnapshot& snapshot = simulation.latest(alpha);
+        applySnapshot(snapshot, alpha);
+        return;
+    }
+
+    // acumulador: o tempo do frame é consumido em passos de tickTime; a sobra (< 1 passo) vira a
+    // fração de interpolação entre o início e o fim do último passo
+    stepAccumulator += frameTime;
+    int steps = 0;
+    while (stepAccumulator >= tickTime && steps < maxSteps) {
+        if (!simulate(stepInput.take(), tickTime, stepSnapshot)) {     // fim da gravação
+            stepAccumulator = 0.0;
+            break;
+        }
+        stepSnapshot.tick++;
+        stepAccumulator -= tickTime;
+        steps++;
+    }
+
+    // frame longo demais (ex.: travamento, depurador): os passos além do limite são descartados em vez de
+    // acumular, para que um frame lento não gere frames ainda mais lentos (espiral da morte)
+    if (stepAccumulator >= tickTime) {
+        stepAccumulator = std::fmod(stepAccumulator, (double)tickTime);
+        clampedFrames++;
+    }
+    stepCount += steps;
+    steppedFrames++;
+
+    applySnapshot(stepSnapshot, (float)(stepAccumulator / tickTime));
+}
+
+
+// Um passo da simulação (thread da simulação): mesma ordem do laço principal - entrada, projéteis, colisões
+bool System::simulate(const FrameInput& frameInput, float dt, SimulationSnapshot& snapshot) {
+    FrameInput input = frameInput;
+    if (replayingInput) {
+        if (replayPosition >= inputRecording.size()) return false;
+        input = inputRecording.frames[replayPosition++];
+    } else if (recordingInput) {
+        inputRecording.frames.push_back(input);     // um frame da gravação por passo
+    }
+
+    snapshot.previousCamera = CameraState(simCamera);
+    applySimulationInput(input, simCamera, simProjeteis, dt, false);
+    advanceProjeteis(simProjeteis, dt);
+
+    vector<bool> removed;
+    if (resolveCollisions(simProjeteis, simObjects, dt, removed, snapshot.collisionTests)) {
+        removeMarked(simObjects, removed);
+        simSceneVersion++;
+    }
+
+    // o slot reaproveitado é o de duas publicações atrás: tudo é reescrito
+    snapshot.camera = CameraState(simCamera);
+    snapshot.projectiles.clear();
+    for (const auto& projetil : simProjeteis) {
+        if (projetil->isActive()) snapshot.projectiles.push_back({ projetil->previousPosition, projetil->position });
+    }
+    if (snapshot.sceneVersion != simSceneVersion || snapshot.tick == 0) {
+        snapshot.objects = simObjects;
+        snapshot.sceneVersion = simSceneVersion;
+    }
+    return true;
+}
+
+
+// Estado do frame a partir de um snapshot: "alpha" = 0 no início do passo, 1 no fim
+void System::applySnapshot(const SimulationSnapshot& snapshot, float alpha) {
+    if (snapshot.tick == 0) return;     // nenhum passo ainda: a câmera inicial continua valendo
+
+    camera.Position = mix(snapshot.previousCamera.position, snapshot.camera.position, alpha);
+    camera.Yaw = mix(snapshot.previousCamera.yaw, snapshot.camera.yaw, alpha);
+    camera.Pitch = mix(snapshot.previousCamera.pitch, snapshot.camera.pitch, alpha);
+    camera.Zoom = mix(snapshot.previousCamera.zoom, snapshot.camera.zoom, alpha);
+    camera.updateCameraVectors();
+
+    projectilePositions.clear();
+    for (const auto& projetil : snapshot.projectiles) {
+        projectilePositions.push_back(mix(projetil.previous, projetil.position, alpha));
+    }
+
+    // objetos eliminados: os do snapshot são uma subsequência de sceneObjects, na mesma ordem
+    if (snapshot.sceneVersion != appliedSceneVersion) {
+        vector<bool> removed(sceneObjects.size(), false);
+        size_t next = 0;
+        for (size_t i = 0; i < sceneObjects.size(); i++) {
+            if (next < snapshot.objects.size() && snapshot.objects[next] == sceneObjects[i].get()) {
+                next++;
             } else {
-                ++sceneObject; // Nenhuma colisão, verifica o próximo objeto
+                instanceRenderer.remove(sceneObjects[i].get());     // antes de destruir o objeto
+                removed[i] = true;
             }
         }
+        removeMarked(sceneObjects, removed);
+        staticBatch.markDirty();
+        appliedSceneVersion = snapshot.sceneVersion;
     }
-}
\ No newline at end of file
+
+    Stats::set(STAT_PROJECTILES, (double)projectilePositions.size());
+    Stats::set(STAT_COLLISION_TESTS, snapshot.collisionTests);
+}
+
+// Lê as opções da linha de comando (todas opcionais; sem --headless o visualizador abre a janela normalmente)
+bool System::parseArguments(int argc, char** argv, RunOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (argument == "--headless") {
+            options.headless = true;
+        } else if (argument == "--size" && hasValue) {
+            if (sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2 ||
+                options.width <= 0 || options.height <= 0) {
+                cerr << "Tamanho invalido (use LARGURAxALTURA): " << argv[i] << endl;
+                return false;
+            }
+        } else if (argument == "--frames" && hasValue) {
+            options.frames = atoi(argv[++i]);
+        } else if (argument == "--camera-path" && hasValue) {
+            options.cameraPath = argv[++i];
+        } else if (argument == "--timings" && hasValue) {
+            options.timingsPath = argv[++i];
+        } else if (argument == "--dump" && hasValue) {
+            options.dumpPath = argv[++i];
+        } else if (argument == "--multidraw") {
+            options.multiDraw = true;
+        } else if (argument == "--no-instancing") {
+            options.instancing = false;
+        } else if (argument == "--no-texture-arrays") {
+            options.textureArrays = false;
+        } else if (argument == "--record" && hasValue) {
+            options.recordPath = argv[++i];
+        } else if (argument == "--replay" && hasValue) {
+            options.replayPath = argv[++i];
+        } else if (argument == "--trace" && hasValue) {
+            options.tracePath = argv[++i];
+        } else if (argument == "--overlay") {
+            options.overlay = true;
+        } else if (argument == "--scene" && hasValue) {
+            options.scenePath = argv[++i];
+        } else if (argument == "--scaling-csv" && hasValue) {
+            options.scalingPath = argv[++i];
+        } else if (argument == "--sync-loading") {
+            options.syncLoading = true;
+        } else if (argument == "--loader-threads" && hasValue) {
+            options.loaderThreads = (unsigned int)std::max(0, atoi(argv[++i]));
+        } else if (argument == "--io" && hasValue) {
+            string backend = argv[++i];
+            if (!FileReader::parseBackend(backend, options.readBackend)) {
+                cerr << "Leitura de arquivos invalida (uring, pread ou stream): " << backend << endl;
+                return false;
+            }
+        } else if (argument == "--upload-budget" && hasValue) {
+            options.uploadBudgetKB = (size_t)std::max(1, atoi(argv[++i]));
+        } else if (argument == "--upload-ms" && hasValue) {
+            options.uploadMs = (float)atof(argv[++i]);
+        } else if (argument == "--mips" && hasValue) {
+            string filter = argv[++i];
+            if (!MipChain::parseFilter(filter, options.mipFilter)) {
+                cerr << "Filtro de mipmaps invalido (gpu, box ou kaiser): " << filter << endl;
+                return false;
+            }
+        } else if (argument == "--no-cooked-textures") {
+            options.cookedTextures = false;
+        } else if (argument == "--texture-budget" && hasValue) {
+            options.textureBudgetMB = (size_t)std::max(0, atoi(argv[++i]));
+        } else if (argument == "--texture-tail" && hasValue) {
+            options.textureTail = std::max(1, atoi(argv[++i]));
+        }
+        // cozimento das texturas (ver TextureCooker.h)
+        else if (argument == "--cook-textures") {
+            options.cook.enabled = true;
+        } else if (argument == "--cook-format" && hasValue) {
+            string format = argv[++i];
+            options.cook.autoFormat = format == "auto";
+            if (!options.cook.autoFormat && !BlockCompression::parseFormat(format, options.cook.format)) {
+                cerr << "Formato de textura invalido (auto, bc1, bc3 ou bc7): " << format << endl;
+                return false;
+            }
+        } else if (argument == "--cook-force") {
+            options.cook.force = true;
+        }
+        // pacote de recursos (ver AssetPack.h)
+        else if (argument == "--pack" && hasValue) {
+            options.packPath = argv[++i];
+        } else if (argument == "--pack-assets" && hasValue) {
+            options.packOutput = argv[++i];
+        } else if (argument == "--pack-compress") {
+            options.packCompress = true;
+        }
+        // gerador de cenas de estresse (ver SceneGenerator.h)
+        else if (argument == "--generate-scene" && hasValue) {
+            options.generator.directory = argv[++i];
+        } else if (argument == "--objects" && hasValue) {
+            options.generator.objects = (size_t)strtoull(argv[++i], nullptr, 10);
+        } else if (argument == "--meshes" && hasValue) {
+            options.generator.meshes = (unsigned int)atoi(argv[++i]);
+        } else if (argument == "--mesh-faces" && hasValue) {
+            options.generator.meshFaces = (unsigned int)atoi(argv[++i]);
+        } else if (argument == "--textures" && hasValue) {
+            options.generator.textures = (unsigned int)atoi(argv[++i]);
+        } else if (argument == "--texture-size" && hasValue) {
+            options.generator.textureSize = (unsigned int)std::max(1, atoi(argv[++i]));
+        } else if (argument == "--instancing" && hasValue) {
+            options.generator.instancing = (float)atof(argv[++i]);
+        } else if (argument == "--extent" && hasValue) {
+            options.generator.extent = (float)atof(argv[++i]);
+        } else if (argument == "--seed" && hasValue) {
+            options.generator.seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        } else if (argument == "--distribution" && hasValue) {
+            string distribution = argv[++i];
+            if (distribution == "uniform")        options.generator.distribution = DISTRIBUTION_UNIFORM;
+            else if (distribution == "clustered") options.generator.distribution = DISTRIBUTION_CLUSTERED;
+            else if (distribution == "grid")      options.generator.distribution = DISTRIBUTION_GRID;
+            else {
+                cerr << "Distribuicao invalida (uniform, clustered ou grid): " << distribution << endl;
+                return false;
+            }
+        } else if (argument == "--sim-thread") {
+            options.simThread = true;
+        } else if (argument == "--fixed-step") {
+            options.fixedStep = true;
+        } else if (argument == "--max-steps" && hasValue) {
+            options.maxSteps = std::max(1, atoi(argv[++i]));
+        } else if (argument == "--tick-rate" && hasValue) {
+            options.tickRate = (float)atof(argv[++i]);
+            if (options.tickRate <= 0.0f) {
+                cerr << "Taxa de passos invalida: " << argv[i] << endl;
+                return false;
+            }
+        } else if (argument == "--log-rate" && hasValue) {
+            options.logRate = (uint32_t)std::max(0, atoi(argv[++i]));
+        } else if (argument == "--fixed-dt" && hasValue) {
+            options.fixedDeltaTime = (float)atof(argv[++i]);
+            if (options.fixedDeltaTime <= 0.0f) {
+                cerr << "deltaTime fixo invalido: " << argv[i] << endl;
+                return false;
+            }
+        } else {
+            cerr << "Argumento desconhecido: " << argument << endl;
+            cerr << "Uso: visualizador3d [--headless] [--size LxA] [--frames N] [--camera-path arquivo]"
+                 << " [--timings arquivo.csv] [--dump arquivo.ppm]"
+                 << " [--multidraw] [--no-instancing] [--no-texture-arrays]"
+                 << " [--record arquivo | --replay arquivo [--fixed-dt segundos]] [--trace arquivo.json] [--overlay]"
+                 << " [--scene arquivo] [--scaling-csv arquivo.csv] [--sync-loading] [--loader-threads N]"
+                 << " [--io uring|pread|stream]"
+                 << " [--upload-budget KB] [--upload-ms ms] [--mips gpu|box|kaiser] [--no-cooked-textures]"
+                 << " [--texture-budget MB] [--texture-tail N] [--pack arquivo.pack]"
+                 << " [--sim-thread | --fixed-step [--max-steps N]] [--tick-rate Hz] [--log-rate N]" << endl;
+            cerr << "      visualizador3d --cook-textures [--scene arquivo] [--cook-format auto|bc1|bc3|bc7]"
+                 << " [--mips box|kaiser] [--loader-threads N] [--cook-force]" << endl;
+            cerr << "      visualizador3d --pack-assets arquivo.pack [--scene arquivo] [--pack-compress]" << endl;
+            cerr << "      visualizador3d --generate-scene diretorio [--objects N] [--meshes N] [--mesh-faces N]"
+                 << " [--textures N] [--texture-size N] [--instancing 0..1]"
+                 << " [--distribution uniform|clustered|grid] [--extent L] [--seed N]" << endl;
+            return false;
+        }
+    }
+
+    if (!options.recordPath.empty() && !options.replayPath.empty()) {
+        cerr << "--record e --replay nao podem ser usados juntos" << endl;
+        return false;
+    }
+    if (options.simThread && options.fixedStep) {
+        cerr << "--sim-thread e --fixed-step nao podem ser usados juntos" << endl;
+        return false;
+    }
+    if (!options.recordPath.empty() && options.headless) {
+        cerr << "--record precisa da janela (nao ha entrada no modo headless)" << endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool System::setupInput(const RunOptions& options) {
+    if (!options.replayPath.empty()) {
+        if (!inputRecording.load(options.replayPath)) return false;
+        replayingInput = true;
+        replayPosition = 0;
+        fixedDeltaTime = options.fixedDeltaTime;
+        cout << "Reproduzindo entrada com deltaTime fixo de " << fixedDeltaTime << " s" << endl;
+    } else if (!options.recordPath.empty()) {
+        recordingInput = true;
+        cout << "Gravando entrada em " << options.recordPath << endl;
+    }
+    return true;
+}
+
+
+void System::finishRun(const RunOptions& options) {
+    simulation.stop();  // a gravação pertence à thread da simulação enquanto ela roda
+    if (recordingInput) inputRecording.save(options.recordPath);
+
+    // espera os últimos frames na GPU, para que os tempos e o trace fiquem completos
+    gpuTimer.flush();
+    for (const auto& frame : gpuTimer.newlyResolved()) {
+        timings.setGpuTime(frame.first, (float)frame.second);
+    }
+
+    if (!timings.frames.empty()) {
+        if (!options.timingsPath.empty()) timings.writeCSV(options.timingsPath);
+        timings.printSummary();
+
+        // uma linha por execução: várias cenas geradas no mesmo arquivo formam a curva de escala
+        if (!options.scalingPath.empty()) {
+            timings.appendSummaryCSV(options.scalingPath, sceneFile, sceneObjects.size(), sceneLoadMs, firstFrameMs);
+        }
+    }
+
+    // trace de CPU dos escopos instrumentados (apenas em builds com -DENABLE_PROFILER)
+    if (Profiler::isCompiledIn() && !options.tracePath.empty()) {
+        Profiler::writeChromeTrace(options.tracePath);
+    }
+}
+
+
+// Laço principal do modo headless: sem entrada do usuário, a câmera segue o caminho roteirizado
+// (ou fica parada) e cada frame termina com glFinish, para que o tempo medido inclua a GPU
+void System::runHeadless(const RunOptions& options) {
+    CameraPath cameraPath;
+    bool scripted = !options.cameraPath.empty() && cameraPath.load(options.cameraPath);
+
+    int frameCount = options.frames;
+    if (frameCount <= 0) {
+        if (replayingInput)  frameCount = (int)inputRecording.size();
+        else if (scripted)   frameCount = cameraPath.lastFrame() + 1;
+        else                 frameCount = 300;
+    }
+
+    // Carregamento assíncrono: frames fora da medição enquanto malhas e texturas chegam (o primeiro
+    // deles dá o tempo até o primeiro frame); os frames medidos começam com a cena completa
+    while (sceneLoading) {
+        auto start = chrono::steady_clock::now();
+        updateLoading();
+        updateStreaming();
+        render();
+        auto submitted = chrono::steady_clock::now();
+        headless.finishFrame();
+        recordFrame(chrono::duration<float, milli>(submitted - start).count(),
+                    chrono::duration<float, milli>(chrono::steady_clock::now() - start).count(), false);
+    }
+
+    // as mesmas escolhas das teclas M, I e T
+    useMultiDraw = options.multiDraw && staticBatch.isBuilt();
+    useInstancing = options.instancing;
+    useTextureArrays = options.textureArrays;
+    overlay.visible = options.overlay && overlay.isInitialized();
+
+    cout << "Headless: " << frameCount << " frames, "
+         << (useMultiDraw ? "multi-draw indirect" : "fila de renderizacao")
+         << ", instanciamento " << (useInstancing ? "ativado" : "desativado")
+         << ", " << (useTextureArrays ? "texture arrays" : "texturas individuais") << endl;
+
+    auto previous = chrono::steady_clock::now();
+
+    // com --sim-thread os frames não esperam a simulação: na reprodução, seguem até ela terminar a gravação
+    bool simulated = isSimulated();
+
+    for (int frame = 0; frame < frameCount || (simulated && replayingInput && !replayFinished()); frame++) {
+        PROFILE_SCOPE("Frame");
+        auto start = chrono::steady_clock::now();
+        deltaTime = replayingInput ? fixedDeltaTime : chrono::duration<float>(start - previous).count();
+        previous = start;
+
+        if (simulated) syncSimulation(deltaTime);
+        else if (replayingInput) processInput();
+        if (scripted) cameraPath.apply(frame, camera);
+        updateStreaming();
+
+        if (!simulated) {
+            updateProjeteis();
+            checkCollisions();
+        }
+        render();
+
+        auto submitted = chrono::steady_clock::now();
+        {
+            PROFILE_SCOPE("HeadlessContext::finishFrame");
+            headless.finishFrame();
+        }
+        auto end = chrono::steady_clock::now();
+
+        recordFrame(chrono::duration<float, milli>(submitted - start).count(),
+                    chrono::duration<float, milli>(end - start).count(), true);
+    }
+
+    // frame salvo com o último passo completo (alpha = 1): o mesmo estado da execução sem --sim-thread
+    // ou --fixed-step
+    if (simulated && !options.dumpPath.empty()) {
+        simulation.stop();
+        float alpha;
+        applySnapshot(fixedStep ? stepSnapshot : simulation.latest(alpha), 1.0f);
+        if (scripted) cameraPath.apply(frameCount - 1, camera);
+        render();
+        headless.finishFrame();
+    }
+
+    if (!options.dumpPath.empty()) headless.saveFrame(options.dumpPath);
+}
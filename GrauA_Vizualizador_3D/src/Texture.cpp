@@ -1,39 +1,60 @@
 #include "Texture.h"
+#include "TextureArray.h"
+#include "GLState.h"
+#include "GLExtensions.h"
+#include "Profiler.h"
+#include "Stats.h"
+#include "Log.h"
 #include <iostream>
+#include <algorithm>
+#include "AssetPack.h"
 #include <stb_image.h>
 
-unsigned int Texture::loadTexture(const string& path) {
+unsigned int Texture::loadTexture(const string& path, TextureArray* arrayLayers) {
+    PROFILE_SCOPE("Texture::loadTexture");
+
+    CookedTexture cooked;
+    if (TextureCooker::load(path, cooked) && supportsFormat(cooked.format)) {
+        LOG_INFO("Textura carregada ({}): {}", BlockCompression::formatName(cooked.format), path);
+        unsigned int compressedID = createCompressedTexture(cooked);
+        if (arrayLayers && !cooked.layerLevels.empty()) {
+            arrayLayers->addCompressedLayer(path, cooked.format, move(cooked.layerLevels));
+        }
+        return compressedID;
+    }
+
     unsigned int textureID;
     glGenTextures(1, &textureID);
     
     int width, height, nrComponents;
 
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrComponents, 0);
+    unsigned char* data = AssetPack::loadImage(path, &width, &height, &nrComponents, 0);
     
     if (data) {
-        GLenum format = GL_RGB; // Formato padrão
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
+        GLenum format = formatFor(nrComponents);
         
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        GLState::bindTexture(GL_TEXTURE_2D, textureID);
         glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
         glGenerateMipmap(GL_TEXTURE_2D);
+        Stats::add(STAT_GPU_MEMORY, width * height * nrComponents * 4.0 / 3.0);    // nível 0 + mipmaps
         
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        if (arrayLayers) {
+            vector<unsigned char> pixels;
+            int size = TextureArray::prepareLayer(data, width, height, nrComponents, pixels);
+            arrayLayers->addLayer(path, size, move(pixels));
+        }
         
         stbi_image_free(data);
-        cout << "Textura carregada: " << path << endl;
+        LOG_INFO("Textura carregada: {}", path);
         return textureID;
     } else {
-        cout << "Falha ao carregar textura: " << path << endl;
-        glDeleteTextures(1, &textureID);
+        LOG_WARNING("Falha ao carregar textura: {}", path);
+        GLState::deleteTexture(textureID);
         return 0;
     }
 }
@@ -42,17 +63,12 @@ unsigned int Texture::createTexture(int width, int height, unsigned char* data,
     unsigned int textureID;
     glGenTextures(1, &textureID);
     
-    GLenum format = GL_RGB; // Formato padrão
-    if (channels == 1)
-        format = GL_RED;
-    else if (channels == 3)
-        format = GL_RGB;
-    else if (channels == 4)
-        format = GL_RGBA;
+    GLenum format = formatFor(channels);
     
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    GLState::bindTexture(GL_TEXTURE_2D, textureID);
     glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
     glGenerateMipmap(GL_TEXTURE_2D);
+    Stats::add(STAT_GPU_MEMORY, width * height * channels * 4.0 / 3.0);
     
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -62,6 +78,81 @@ unsigned int Texture::createTexture(int width, int height, unsigned char* data,
     return textureID;
 }
 
+unsigned int Texture::allocateTexture(int width, int height, int channels, bool mipLevels) {
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+
+    GLenum format = formatFor(channels);
+    GLState::bindTexture(GL_TEXTURE_2D, textureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, NULL);
+    Stats::add(STAT_GPU_MEMORY, width * height * channels * 4.0 / 3.0);
+
+    for (int level = 1; mipLevels && (width > 1 || height > 1); level++) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        glTexImage2D(GL_TEXTURE_2D, level, format, width, height, 0, format, GL_UNSIGNED_BYTE, NULL);
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    return textureID;
+}
+
+unsigned int Texture::allocateCompressed(int width, int height, BlockFormat format, int levels) {
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+
+    GLenum internalFormat = compressedFormatFor(format);
+    GLState::bindTexture(GL_TEXTURE_2D, textureID);
+    for (int level = 0; level < levels; level++) {
+        GLsizei size = (GLsizei)BlockCompression::imageSize(format, width, height);
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, width, height, 0, size, NULL);
+        Stats::add(STAT_GPU_MEMORY, size);
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    return textureID;
+}
+
+unsigned int Texture::createCompressedTexture(const CookedTexture& texture) {
+    const MipLevel& base = texture.levels[0];
+    unsigned int textureID = allocateCompressed(base.width, base.height, texture.format, (int)texture.levels.size());
+
+    GLenum internalFormat = compressedFormatFor(texture.format);
+    for (size_t level = 0; level < texture.levels.size(); level++) {
+        const MipLevel& mip = texture.levels[level];
+        glCompressedTexSubImage2D(GL_TEXTURE_2D, (GLint)level, 0, 0, mip.width, mip.height, internalFormat,
+                                  (GLsizei)mip.pixels.size(), mip.pixels.data());
+    }
+    return textureID;
+}
+
+GLenum Texture::formatFor(int channels) {
+    if (channels == 1) return GL_RED;
+    if (channels == 4) return GL_RGBA;
+    return GL_RGB;  // Formato padrão
+}
+
+GLenum Texture::compressedFormatFor(BlockFormat format) {
+    if (format == BLOCK_BC7) return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    if (format == BLOCK_BC3) return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+}
+
+bool Texture::supportsFormat(BlockFormat format) {
+    return format == BLOCK_BC7 ? GLExtensions::textureCompressionBPTC : GLExtensions::textureCompressionS3TC;
+}
+
 void Texture::deleteTexture(unsigned int textureID) {
-    glDeleteTextures(1, &textureID);
+    GLState::deleteTexture(textureID);
 }
\ No newline at end of file
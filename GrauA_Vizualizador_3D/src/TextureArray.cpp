@@ -0,0 +1,244 @@
+#include "TextureArray.h"
+#include "Texture.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include "Stats.h"
+#include <iostream>
+#include <algorithm>
+#include "AssetPack.h"
+#include <stb_image.h>
+
+TextureArray::TextureArray() {}
+
+TextureArray::~TextureArray() { cleanup(); }
+
+
+int TextureArray::bucketSize(int width, int height) {
+    int largest = std::max(width, height);
+    int size = MIN_LAYER_SIZE;
+    while (size < largest && size < MAX_LAYER_SIZE) size *= 2;
+    return size;
+}
+
+
+// Cada pixel de destino cobre um retângulo da imagem de origem: na redução é feita a média
+// de todos os pixels do retângulo (evita aliasing em reduções grandes, ex.: 6016 -> 1024);
+// na ampliação o retângulo tem menos de um pixel e vira amostragem do vizinho mais próximo.
+void TextureArray::resample(const unsigned char* source, int width, int height,
+                            vector<unsigned char>& destination, int size) {
+    destination.assign((size_t)size * size * 4, 0);
+
+    for (int y = 0; y < size; y++) {
+        int sy0 = (int)((long long)y * height / size);
+        int sy1 = std::max(sy0 + 1, (int)((long long)(y + 1) * height / size));
+
+        for (int x = 0; x < size; x++) {
+            int sx0 = (int)((long long)x * width / size);
+            int sx1 = std::max(sx0 + 1, (int)((long long)(x + 1) * width / size));
+
+            unsigned int sum[4] = {0, 0, 0, 0};
+            for (int sy = sy0; sy < sy1; sy++) {
+                const unsigned char* row = source + ((size_t)sy * width + sx0) * 4;
+                for (int sx = sx0; sx < sx1; sx++, row += 4) {
+                    sum[0] += row[0]; sum[1] += row[1]; sum[2] += row[2]; sum[3] += row[3];
+                }
+            }
+
+            unsigned int count = (unsigned int)((sy1 - sy0) * (sx1 - sx0));
+            unsigned char* pixel = &destination[((size_t)y * size + x) * 4];
+            for (int c = 0; c < 4; c++) pixel[c] = (unsigned char)((sum[c] + count / 2) / count);
+        }
+    }
+}
+
+
+bool TextureArray::addTexture(const string& path) {
+    if (layers.count(path)) return true;    // já empacotada
+
+    CookedTexture cooked;
+    if (TextureCooker::load(path, cooked) && !cooked.layerLevels.empty() && Texture::supportsFormat(cooked.format)) {
+        addCompressedLayer(path, cooked.format, move(cooked.layerLevels));
+        return true;
+    }
+
+    int width, height, nrComponents;
+    unsigned char* data = AssetPack::loadImage(path, &width, &height, &nrComponents, 4);  // sempre RGBA
+    if (!data) {
+        cout << "Falha ao carregar textura para o array: " << path << endl;
+        return false;
+    }
+
+    vector<unsigned char> pixels;
+    int size = prepareLayer(data, width, height, 4, pixels);
+    stbi_image_free(data);
+
+    addLayer(path, size, move(pixels));
+    return true;
+}
+
+
+int TextureArray::prepareLayer(const unsigned char* data, int width, int height, int channels,
+                               vector<unsigned char>& pixels) {
+    int size = bucketSize(width, height);
+
+    // expande para RGBA como o stbi_load com 4 componentes (cinza -> RGB, alfa ausente = 255)
+    vector<unsigned char> expanded;
+    if (channels != 4) {
+        expanded.resize((size_t)width * height * 4);
+        for (size_t i = 0; i < (size_t)width * height; i++) {
+            const unsigned char* source = data + i * channels;
+            unsigned char* pixel = &expanded[i * 4];
+            bool gray = channels < 3;
+            pixel[0] = source[0];
+            pixel[1] = gray ? source[0] : source[1];
+            pixel[2] = gray ? source[0] : source[2];
+            pixel[3] = (channels == 2) ? source[1] : 255;
+        }
+        data = expanded.data();
+    }
+
+    if (width == size && height == size) {
+        pixels.assign(data, data + (size_t)size * size * 4);
+    } else {
+        resample(data, width, height, pixels, size);
+    }
+    return size;
+}
+
+
+void TextureArray::addLayer(const string& path, int size, vector<unsigned char>&& pixels,
+                            vector<MipLevel>&& mips) {
+    if (layers.count(path)) return;
+
+    Bucket& bucket = bucketFor(size, -1);
+    bucket.pixels.push_back(move(pixels));
+    bucket.mips.push_back(move(mips));
+
+    layers[path] = make_pair(BucketKey(size, -1), (int)bucket.pixels.size() - 1);
+}
+
+
+void TextureArray::addCompressedLayer(const string& path, BlockFormat format, vector<MipLevel>&& levels) {
+    if (layers.count(path) || levels.empty()) return;
+
+    int size = levels[0].width;
+    Bucket& bucket = bucketFor(size, format);
+    bucket.pixels.push_back(move(levels[0].pixels));
+    bucket.mips.push_back(vector<MipLevel>(make_move_iterator(levels.begin() + 1),
+                                           make_move_iterator(levels.end())));
+
+    layers[path] = make_pair(BucketKey(size, format), (int)bucket.pixels.size() - 1);
+}
+
+
+TextureArray::Bucket& TextureArray::bucketFor(int size, int format) {
+    Bucket& bucket = buckets[BucketKey(size, format)];
+    bucket.size = size;
+    bucket.format = format;
+    bucket.arrayID = 0;
+    return bucket;
+}
+
+
+bool TextureArray::build() {
+    PROFILE_SCOPE("TextureArray::build");
+    for (auto& entry : buckets) {
+        Bucket& bucket = entry.second;
+        if (bucket.pixels.empty()) continue;
+
+        glGenTextures(1, &bucket.arrayID);
+        GLState::bindTexture(GL_TEXTURE_2D_ARRAY, bucket.arrayID);
+
+        if (bucket.format >= 0) buildCompressed(bucket);
+        else buildUncompressed(bucket);
+
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        cout << "Texture array " << bucket.size << "x" << bucket.size;
+        if (bucket.format >= 0) cout << " (" << BlockCompression::formatName((BlockFormat)bucket.format) << ")";
+        cout << ": " << bucket.pixels.size() << " camadas" << endl;
+
+        arrays.push_back(bucket.arrayID);
+        vector<vector<unsigned char>>().swap(bucket.pixels);   // libera a memória da CPU
+        vector<vector<MipLevel>>().swap(bucket.mips);
+    }
+
+    return !arrays.empty();
+}
+
+
+void TextureArray::buildUncompressed(Bucket& bucket) {
+    // mipmaps da CPU só se todas as camadas tiverem a cadeia completa
+    GLsizei layerCount = (GLsizei)bucket.pixels.size();
+    int levels = MipChain::levelCount(bucket.size, bucket.size);
+    bool cpuMips = true;
+    for (const auto& chain : bucket.mips) cpuMips = cpuMips && (int)chain.size() == levels - 1;
+
+    for (int level = 0, size = bucket.size; level < (cpuMips ? levels : 1); level++, size = std::max(1, size / 2)) {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, size, size, layerCount, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    }
+    for (GLsizei layer = 0; layer < layerCount; layer++) {
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, bucket.size, bucket.size, 1,
+                        GL_RGBA, GL_UNSIGNED_BYTE, bucket.pixels[layer].data());
+        for (int level = 1; cpuMips && level < levels; level++) {
+            const MipLevel& mip = bucket.mips[layer][level - 1];
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, mip.width, mip.height, 1,
+                            GL_RGBA, GL_UNSIGNED_BYTE, mip.pixels.data());
+        }
+    }
+    if (!cpuMips) glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    Stats::add(STAT_GPU_MEMORY, 4.0 * bucket.size * bucket.size * bucket.pixels.size() * 4.0 / 3.0);
+}
+
+
+void TextureArray::buildCompressed(Bucket& bucket) {
+    BlockFormat format = (BlockFormat)bucket.format;
+    GLenum internalFormat = Texture::compressedFormatFor(format);
+    GLsizei layerCount = (GLsizei)bucket.pixels.size();
+
+    // a cadeia mais curta entre as camadas define os níveis do array
+    size_t levels = MipChain::levelCount(bucket.size, bucket.size);
+    for (const auto& chain : bucket.mips) levels = std::min(levels, chain.size() + 1);
+
+    for (size_t level = 0, size = bucket.size; level < levels; level++, size = std::max<size_t>(1, size / 2)) {
+        size_t layerBytes = BlockCompression::imageSize(format, (int)size, (int)size);
+        glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, (GLint)level, internalFormat, (GLsizei)size, (GLsizei)size,
+                               layerCount, 0, (GLsizei)(layerBytes * layerCount), NULL);
+        Stats::add(STAT_GPU_MEMORY, (double)layerBytes * layerCount);
+
+        for (GLsizei layer = 0; layer < layerCount; layer++) {
+            const vector<unsigned char>& blocks = level == 0 ? bucket.pixels[layer]
+                                                             : bucket.mips[layer][level - 1].pixels;
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, (GLint)level, 0, 0, layer, (GLsizei)size, (GLsizei)size,
+                                      1, internalFormat, (GLsizei)blocks.size(), blocks.data());
+        }
+    }
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, (GLint)levels - 1);
+}
+
+
+TextureLayer TextureArray::find(const string& path) const {
+    TextureLayer result;
+
+    auto found = layers.find(path);
+    if (found == layers.end()) return result;
+
+    auto bucket = buckets.find(found->second.first);
+    if (bucket == buckets.end() || bucket->second.arrayID == 0) return result;
+
+    result.arrayID = bucket->second.arrayID;
+    result.layer = found->second.second;
+    return result;
+}
+
+
+void TextureArray::cleanup() {
+    for (unsigned int arrayID : arrays) GLState::deleteTexture(arrayID);
+    arrays.clear();
+    buckets.clear();
+    layers.clear();
+}
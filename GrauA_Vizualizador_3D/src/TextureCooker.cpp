@@ -0,0 +1,277 @@
+#include "TextureCooker.h"
+#include "TextureArray.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <filesystem>
+#include <stb_image.h>
+
+string TextureCooker::directory = "texture_cache";
+bool TextureCooker::enabled = true;
+
+namespace {
+    const uint32_t COOKED_MAGIC   = 0x54524743;    // "CGRT"
+    const uint32_t COOKED_VERSION = 1;
+
+    // Cabeçalho do arquivo cozido, seguido dos níveis da textura e dos níveis da camada
+    struct CookedHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t format;            // BlockFormat
+        uint32_t levelCount;
+        uint32_t layerLevelCount;   // 0 = sem camada
+        uint32_t reserved;
+        uint64_t sourceSize;        // tamanho e data da imagem original: arquivo desatualizado se mudarem
+        int64_t  sourceTime;
+    };
+
+    // Cada nível: cabeçalho seguido de "size" bytes de blocos
+    struct LevelHeader {
+        int32_t  width;
+        int32_t  height;
+        uint32_t size;
+    };
+
+    bool sourceIdentity(const string& path, uint64_t& size, int64_t& time) {
+        error_code error;
+        size = (uint64_t)filesystem::file_size(path, error);
+        if (error) return false;
+        time = (int64_t)filesystem::last_write_time(path, error).time_since_epoch().count();
+        return !error;
+    }
+
+    bool readHeader(ifstream& file, const string& source, CookedHeader& header) {
+        file.read((char*)&header, sizeof(header));
+        if (!file || header.magic != COOKED_MAGIC || header.version != COOKED_VERSION || header.format > BLOCK_BC7) {
+            return false;
+        }
+
+        uint64_t size;
+        int64_t time;
+        return sourceIdentity(source, size, time) && size == header.sourceSize && time == header.sourceTime;
+    }
+
+    // Níveis antes de "firstLevel" ficam só com as dimensões (os blocos são pulados no arquivo)
+    bool readLevels(ifstream& file, uint32_t count, BlockFormat format, vector<MipLevel>& levels, uint32_t firstLevel) {
+        levels.resize(count);
+        for (uint32_t i = 0; i < count; i++) {
+            MipLevel& level = levels[i];
+            LevelHeader header;
+            file.read((char*)&header, sizeof(header));
+            if (!file || header.width <= 0 || header.height <= 0 ||
+                header.size != BlockCompression::imageSize(format, header.width, header.height)) {
+                return false;
+            }
+
+            level.width = header.width;
+            level.height = header.height;
+            if (i < firstLevel) {
+                file.seekg(header.size, ios::cur);
+            } else {
+                level.pixels.resize(header.size);
+                file.read((char*)level.pixels.data(), header.size);
+            }
+            if (!file) return false;
+        }
+        return true;
+    }
+
+    void writeLevels(ofstream& file, const vector<MipLevel>& levels) {
+        for (const auto& level : levels) {
+            LevelHeader header = { level.width, level.height, (uint32_t)level.pixels.size() };
+            file.write((const char*)&header, sizeof(header));
+            file.write((const char*)level.pixels.data(), level.pixels.size());
+        }
+    }
+
+    uint64_t fnv1a(const string& text) {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    double megabytes(size_t bytes) { return bytes / (1024.0 * 1024.0); }
+}
+
+
+string TextureCooker::pathFor(const string& path) {
+    ostringstream name;
+    name << directory << "/" << hex << setw(16) << setfill('0') << fnv1a(path) << ".ctex";
+    return name.str();
+}
+
+
+bool TextureCooker::load(const string& path, CookedTexture& texture, int firstLevel) {
+    if (!enabled) return false;
+
+    ifstream file(pathFor(path), ios::binary);
+    if (!file) return false;
+
+    CookedHeader header;
+    if (!readHeader(file, path, header)) return false;  // desatualizado: a imagem é decodificada
+
+    texture.format = (BlockFormat)header.format;
+    uint32_t layerLevels = firstLevel > 0 ? 0 : header.layerLevelCount;   // a camada só interessa na leitura completa
+    if (!readLevels(file, header.levelCount, texture.format, texture.levels, (uint32_t)firstLevel) ||
+        !readLevels(file, layerLevels, texture.format, texture.layerLevels, 0) || texture.levels.empty()) {
+        cerr << "Textura cozida invalida: " << pathFor(path) << endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool TextureCooker::isCurrent(const string& path, bool checkFormat, BlockFormat format) {
+    ifstream file(pathFor(path), ios::binary);
+    CookedHeader header;
+    if (!file || !readHeader(file, path, header)) return false;
+
+    // no modo automático qualquer BC1/BC3 serve; com o formato pedido, só ele
+    return checkFormat ? header.format == (uint32_t)format : header.format != BLOCK_BC7;
+}
+
+
+bool TextureCooker::write(const string& path, const CookedTexture& texture) {
+    CookedHeader header = {};
+    header.magic = COOKED_MAGIC;
+    header.version = COOKED_VERSION;
+    header.format = (uint32_t)texture.format;
+    header.levelCount = (uint32_t)texture.levels.size();
+    header.layerLevelCount = (uint32_t)texture.layerLevels.size();
+    if (!sourceIdentity(path, header.sourceSize, header.sourceTime)) return false;
+
+    error_code error;
+    filesystem::create_directories(directory, error);
+
+    ofstream file(pathFor(path), ios::binary | ios::trunc);
+    if (!file) {
+        cerr << "Falha ao gravar textura cozida: " << pathFor(path) << endl;
+        return false;
+    }
+
+    file.write((const char*)&header, sizeof(header));
+    writeLevels(file, texture.levels);
+    writeLevels(file, texture.layerLevels);
+    return (bool)file;
+}
+
+
+void TextureCooker::encodeChain(const unsigned char* rgba, int width, int height, BlockFormat format,
+                                MipFilter filter, vector<MipLevel>& levels, CookReport& report) {
+    vector<MipLevel> mips;
+    MipChain::build(rgba, width, height, 4, filter, mips);
+
+    levels.resize(mips.size() + 1);
+    for (size_t i = 0; i < levels.size(); i++) {
+        const unsigned char* source = i == 0 ? rgba : mips[i - 1].pixels.data();
+        levels[i].width = i == 0 ? width : mips[i - 1].width;
+        levels[i].height = i == 0 ? height : mips[i - 1].height;
+
+        BlockCompression::encode(source, levels[i].width, levels[i].height, format, levels[i].pixels);
+        report.encodedBytes += (size_t)levels[i].width * levels[i].height * 4;
+        report.cookedBytes += levels[i].pixels.size();
+    }
+}
+
+
+bool TextureCooker::cook(const string& path, const CookOptions& options, MipFilter filter, CookReport& report) {
+    PROFILE_SCOPE("TextureCooker::cook");
+    report.path = path;
+
+    if (!options.force && isCurrent(path, !options.autoFormat, options.format)) {
+        report.cooked = report.skipped = true;
+        return true;
+    }
+
+    int channels;
+    unsigned char* data = stbi_load(path.c_str(), &report.width, &report.height, &channels, 4);
+    if (!data) return false;
+
+    auto start = chrono::steady_clock::now();
+    size_t pixelCount = (size_t)report.width * report.height;
+
+    bool alpha = false;
+    for (size_t i = 0; i < pixelCount && (channels == 2 || channels == 4) && !alpha; i++) {
+        alpha = data[i * 4 + 3] < 255;
+    }
+
+    CookedTexture texture;
+    texture.format = options.autoFormat ? (alpha ? BLOCK_BC3 : BLOCK_BC1) : options.format;
+    if (filter == MIP_FILTER_GPU) filter = MIP_FILTER_BOX;  // a cadeia precisa estar no arquivo
+
+    encodeChain(data, report.width, report.height, texture.format, filter, texture.levels, report);
+
+    // mesma camada que o carregamento montaria a partir da imagem
+    vector<unsigned char> layer;
+    int layerSize = TextureArray::prepareLayer(data, report.width, report.height, 4, layer);
+    encodeChain(layer.data(), layerSize, layerSize, texture.format, filter, texture.layerLevels, report);
+
+    report.encodeMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    vector<unsigned char> decoded;
+    BlockCompression::decode(texture.levels[0].pixels.data(), report.width, report.height, texture.format, decoded);
+    report.psnr = BlockCompression::psnr(data, decoded.data(), pixelCount, alpha ? 4 : 3);
+    stbi_image_free(data);
+
+    report.format = texture.format;
+    report.levelCount = texture.levels.size();
+    report.rawBytes = (size_t)((pixelCount * channels + (size_t)layerSize * layerSize * 4) * 4.0 / 3.0);
+
+    report.cooked = write(path, texture);
+    return report.cooked;
+}
+
+
+bool TextureCooker::cookAll(const vector<string>& paths, const CookOptions& options, MipFilter filter) {
+    auto start = chrono::steady_clock::now();
+    vector<CookReport> reports(paths.size());
+
+    // uma textura por job; a thread principal também cozinha enquanto espera
+    JobSystem::parallelFor(paths.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) cook(paths[i], options, filter, reports[i]);
+    });
+    unsigned int threadCount = JobSystem::threadCount();
+
+    size_t cooked = 0, skipped = 0, failed = 0, rawBytes = 0, cookedBytes = 0, encodedBytes = 0;
+    double encodeMs = 0.0;
+
+    cout << fixed << setprecision(1);
+    for (const auto& report : reports) {
+        if (!report.cooked) {
+            cerr << "Falha ao cozinhar textura: " << report.path << endl;
+            failed++;
+        } else if (report.skipped) {
+            cout << "Textura ja atualizada no cache: " << report.path << endl;
+            skipped++;
+        } else {
+            cout << "Textura cozida: " << report.path << " " << report.width << "x" << report.height << " "
+                 << BlockCompression::formatName(report.format) << ", " << report.levelCount << " niveis: "
+                 << megabytes(report.rawBytes) << " MB -> " << megabytes(report.cookedBytes) << " MB ("
+                 << (double)report.rawBytes / report.cookedBytes << "x), PSNR " << report.psnr << " dB, "
+                 << megabytes(report.encodedBytes) / (report.encodeMs / 1000.0) << " MB/s" << endl;
+            cooked++;
+            rawBytes += report.rawBytes;
+            cookedBytes += report.cookedBytes;
+            encodedBytes += report.encodedBytes;
+            encodeMs += report.encodeMs;
+        }
+    }
+
+    double totalMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << "Cozimento: " << cooked << " texturas em " << totalMs << " ms (" << threadCount << " threads), "
+         << skipped << " ja atualizadas, " << failed << " falhas";
+    if (cooked > 0) {
+        cout << "; " << megabytes(rawBytes) << " MB -> " << megabytes(cookedBytes) << " MB, encoder "
+             << megabytes(encodedBytes) / (encodeMs / 1000.0) << " MB/s por thread";
+    }
+    cout << defaultfloat << setprecision(6) << endl;
+
+    return failed == 0;
+}
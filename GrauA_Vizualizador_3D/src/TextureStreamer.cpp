@@ -0,0 +1,415 @@
+#include "TextureStreamer.h"
+#include "TextureCooker.h"
+#include "Texture.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include "Stats.h"
+#include "Log.h"
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <memory>
+#include "AssetPack.h"
+#include <stb_image.h>
+
+namespace {
+    const size_t MAX_LOADS = 4;     // leituras + envios de níveis em andamento ao mesmo tempo
+    const float LEVEL_BIAS = 1.0f;  // níveis a mais que a estimativa: a textura pode contornar o objeto ou se repetir
+
+    double megabytes(size_t bytes) { return bytes / (1024.0 * 1024.0); }
+}
+
+
+TextureStreamer::TextureStreamer()
+    : budgetBytes(0), tailSize(64), mipFilter(MIP_FILTER_GPU), uploads(nullptr), cancelled(false), frame(1), resident(0),
+      tailsPending(0), loadsInFlight(0), frameEvictions(0), loadedLevels(0), evictedLevels(0), deferredRequests(0),
+      streamedBytes(0), peakResident(0), budgetWarning(false) {}
+
+
+TextureStreamer::~TextureStreamer() { stop(); }
+
+
+void TextureStreamer::add(const string& path) {
+    if (byPath.count(path)) return;
+
+    size_t index = entries.size();
+    Entry entry;
+    entry.path = path;
+    entry.texture = 0;
+    entry.compressed = false;
+    entry.format = BLOCK_BC1;
+    entry.width = entry.height = entry.channels = 0;
+    entry.levelCount = entry.tailLevel = entry.residentLevel = entry.wantedLevel = 0;
+    entry.usedFrame = 0;
+    entry.loading = false;
+    entries.push_back(entry);
+    byPath[path] = index;
+    tailsPending++;
+
+    JobSystem::submitBackground(tasks, [this, index, path]() {
+        if (cancelled) return;
+        Result result;
+        result.index = index;
+        result.tail = true;
+        load(result, path, 0, 0);
+        results.push(move(result));
+    });
+}
+
+
+void TextureStreamer::use(unsigned int textureID, float pixels) {
+    auto found = byTexture.find(textureID);
+    if (found == byTexture.end()) return;
+    Entry& entry = entries[found->second];
+
+    // um texel por pixel: cada nível acima do 0 cobre o dobro da distância
+    float texels = (float)std::max(entry.width, entry.height);
+    int level = (int)std::floor(std::log2(texels / std::max(pixels, 1.0f)) - LEVEL_BIAS);
+    level = std::max(0, std::min(level, entry.tailLevel));
+
+    if (entry.usedFrame != frame) {
+        entry.usedFrame = frame;
+        entry.wantedLevel = level;
+    } else {
+        entry.wantedLevel = std::min(entry.wantedLevel, level);
+    }
+}
+
+
+void TextureStreamer::update(vector<pair<string, unsigned int>>& arrived) {
+    PROFILE_SCOPE("TextureStreamer::update");
+    frameEvictions = 0;
+
+    Result result;
+    while (results.pop(result)) {
+        Entry& entry = entries[result.index];
+        if (result.tail) {
+            tailsPending--;
+            if (!result.ok) {
+                LOG_ERROR("Falha ao carregar textura: {}", entry.path);
+                continue;
+            }
+            createTexture(entry, result);
+            byTexture[entry.texture] = result.index;
+            arrived.push_back(make_pair(entry.path, entry.texture));
+        } else if (!result.ok) {
+            LOG_ERROR("Falha ao ler niveis da textura: {}", entry.path);
+            resident -= rangeBytes(entry, result.firstLevel, entry.residentLevel - 1);
+            entry.loading = false;
+            loadsInFlight--;
+        } else {
+            uploadLevels(result.index, result);
+        }
+    }
+
+    // níveis usados neste frame (uma textura sem objetos na chamada a use só precisa da cauda)
+    vector<size_t> wanting;
+    size_t pending = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        Entry& entry = entries[i];
+        if (entry.texture == 0) continue;
+
+        if (entry.usedFrame != frame) entry.wantedLevel = entry.tailLevel;
+        for (int level = entry.wantedLevel; level < entry.tailLevel; level++) entry.lastUsed[level] = frame;
+
+        if (entry.wantedLevel < entry.residentLevel) {
+            pending++;
+            if (!entry.loading) wanting.push_back(i);
+        }
+    }
+
+    // pedidos: primeiro as texturas mais longe da resolução que a tela pede
+    sort(wanting.begin(), wanting.end(), [this](size_t a, size_t b) {
+        return entries[a].residentLevel - entries[a].wantedLevel > entries[b].residentLevel - entries[b].wantedLevel;
+    });
+    for (size_t index : wanting) {
+        if (loadsInFlight >= MAX_LOADS) break;
+        request(index);
+    }
+
+    if (!budgetWarning && resident > budgetBytes) {
+        LOG_WARNING("Aviso: as caudas das texturas ({} MB) passam do orcamento de {} MB (--texture-budget / --texture-tail)",
+                    megabytes(resident), megabytes(budgetBytes));
+        budgetWarning = true;
+    }
+
+    Stats::set(STAT_TEXTURE_RESIDENT, (double)resident);
+    Stats::set(STAT_TEXTURE_BUDGET, (double)budgetBytes);
+    Stats::set(STAT_TEXTURE_PENDING, (double)pending);
+    Stats::set(STAT_TEXTURE_EVICTIONS, (double)frameEvictions);
+    frame++;
+}
+
+
+void TextureStreamer::load(Result& result, const string& path, int firstLevel, int lastLevel) const {
+    PROFILE_SCOPE("TextureStreamer::load");
+
+    // versão cozida: só os blocos dos níveis pedidos são lidos do arquivo
+    CookedTexture cooked;
+    if (TextureCooker::load(path, cooked, result.tail ? INT_MAX : firstLevel) && Texture::supportsFormat(cooked.format)) {
+        result.compressed = true;
+        result.format = cooked.format;
+        result.width = cooked.levels[0].width;
+        result.height = cooked.levels[0].height;
+        result.channels = 4;
+        result.levelCount = (int)cooked.levels.size();
+
+        if (result.tail) {
+            firstLevel = tailLevelFor(result.width, result.height, result.levelCount);
+            lastLevel = result.levelCount - 1;
+            if (!TextureCooker::load(path, cooked, firstLevel)) return;
+        }
+
+        result.firstLevel = firstLevel;
+        for (int level = firstLevel; level <= lastLevel; level++) result.levels.push_back(move(cooked.levels[level]));
+        result.ok = true;
+        return;
+    }
+
+    // sem versão cozida: decodifica a imagem e refaz a cadeia, mantendo só os níveis pedidos
+    int width, height, channels;
+    unsigned char* data = AssetPack::loadImage(path, &width, &height, &channels, 0);
+    if (!data) return;
+
+    result.width = width;
+    result.height = height;
+    result.channels = channels;
+    result.levelCount = MipChain::levelCount(width, height);
+    if (result.tail) {
+        firstLevel = tailLevelFor(width, height, result.levelCount);
+        lastLevel = result.levelCount - 1;
+    }
+
+    vector<MipLevel> mips;
+    MipChain::build(data, width, height, channels, mipFilter == MIP_FILTER_GPU ? MIP_FILTER_BOX : mipFilter, mips);
+
+    result.firstLevel = firstLevel;
+    for (int level = firstLevel; level <= lastLevel; level++) {
+        if (level == 0) {
+            MipLevel base;
+            base.width = width;
+            base.height = height;
+            base.pixels.assign(data, data + (size_t)width * height * channels);
+            result.levels.push_back(move(base));
+        } else {
+            result.levels.push_back(move(mips[level - 1]));
+        }
+    }
+    stbi_image_free(data);
+    result.ok = true;
+}
+
+
+void TextureStreamer::createTexture(Entry& entry, Result& result) {
+    entry.compressed = result.compressed;
+    entry.format = result.format;
+    entry.width = result.width;
+    entry.height = result.height;
+    entry.channels = result.channels;
+    entry.levelCount = result.levelCount;
+    entry.tailLevel = entry.residentLevel = entry.wantedLevel = result.firstLevel;
+    entry.lastUsed.assign(entry.levelCount, 0);
+
+    glGenTextures(1, &entry.texture);
+    GLState::bindTexture(GL_TEXTURE_2D, entry.texture);
+
+    // a cauda é pequena (poucos KB): enviada de uma vez, sem passar pela UploadQueue
+    GLenum format = entry.compressed ? Texture::compressedFormatFor(entry.format) : Texture::formatFor(entry.channels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t i = 0; i < result.levels.size(); i++) {
+        const MipLevel& mip = result.levels[i];
+        GLint level = result.firstLevel + (GLint)i;
+        if (entry.compressed) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, level, format, mip.width, mip.height, 0, (GLsizei)mip.pixels.size(),
+                                   mip.pixels.data());
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, level, format, mip.width, mip.height, 0, format, GL_UNSIGNED_BYTE,
+                         mip.pixels.data());
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, entry.tailLevel);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, entry.levelCount - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    size_t bytes = rangeBytes(entry, entry.tailLevel, entry.levelCount - 1);
+    resident += bytes;
+    peakResident = std::max(peakResident, resident);
+    Stats::add(STAT_GPU_MEMORY, (double)bytes);
+}
+
+
+void TextureStreamer::uploadLevels(size_t index, Result& result) {
+    Entry& entry = entries[index];
+    GLenum format = entry.compressed ? Texture::compressedFormatFor(entry.format) : Texture::formatFor(entry.channels);
+
+    // níveis alocados agora (abaixo de GL_TEXTURE_BASE_LEVEL, ainda não amostrados) e preenchidos em partes,
+    // do mais grosso ao mais fino; com o último a textura passa a usá-los
+    GLState::bindTexture(GL_TEXTURE_2D, entry.texture);
+    auto levels = make_shared<vector<MipLevel>>(move(result.levels));
+    for (size_t i = levels->size(); i-- > 0;) {
+        const MipLevel& mip = (*levels)[i];
+        GLint level = result.firstLevel + (GLint)i;
+        if (entry.compressed) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, level, format, mip.width, mip.height, 0, (GLsizei)mip.pixels.size(),
+                                   NULL);
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, level, format, mip.width, mip.height, 0, format, GL_UNSIGNED_BYTE, NULL);
+        }
+        Stats::add(STAT_GPU_MEMORY, (double)mip.pixels.size());
+        streamedBytes += mip.pixels.size();
+    }
+
+    int firstLevel = result.firstLevel;
+    function<void()> done = [this, index, firstLevel]() {
+        Entry& entry = entries[index];
+        loadedLevels += entry.residentLevel - firstLevel;
+        entry.residentLevel = firstLevel;
+        GLState::bindTexture(GL_TEXTURE_2D, entry.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, firstLevel);
+        entry.loading = false;
+        loadsInFlight--;
+    };
+
+    for (size_t i = levels->size(); i-- > 0;) {
+        const MipLevel& mip = (*levels)[i];
+        GLint level = firstLevel + (GLint)i;
+        function<void()> complete = i == 0 ? done : nullptr;
+        if (entry.compressed) {
+            uploads->uploadCompressed(entry.texture, level, mip.width, mip.height, format, mip.pixels.data(),
+                                      mip.pixels.size(), levels, complete);
+        } else {
+            uploads->uploadTexture(entry.texture, level, mip.width, mip.height, entry.channels, mip.pixels.data(),
+                                   levels, complete);
+        }
+    }
+}
+
+
+void TextureStreamer::request(size_t index) {
+    Entry& entry = entries[index];
+    int first = entry.wantedLevel, last = entry.residentLevel - 1;
+    size_t bytes = rangeBytes(entry, first, last);
+
+    // sem espaço: descarta níveis sem uso; se ainda não couber, pede só os níveis mais grossos que cabem
+    if (resident + bytes > budgetBytes) evictUnused(resident + bytes - budgetBytes, index);
+    while (first <= last && resident + bytes > budgetBytes) {
+        bytes -= levelBytes(entry, first);
+        first++;
+    }
+    if (first != entry.wantedLevel) deferredRequests++;
+    if (first > last) return;
+
+    resident += bytes;  // reservado até o envio terminar
+    peakResident = std::max(peakResident, resident);
+    entry.loading = true;
+    loadsInFlight++;
+
+    string path = entry.path;
+    JobSystem::submitBackground(tasks, [this, index, path, first, last]() {
+        if (cancelled) return;
+        Result result;
+        result.index = index;
+        result.firstLevel = first;
+        load(result, path, first, last);
+        results.push(move(result));
+    });
+}
+
+
+bool TextureStreamer::evictUnused(size_t bytes, size_t keep) {
+    size_t freed = 0;
+    while (freed < bytes) {
+        // nível mais fino de cada textura, usado há mais tempo (nunca um nível usado neste frame)
+        Entry* oldest = nullptr;
+        for (size_t i = 0; i < entries.size(); i++) {
+            Entry& entry = entries[i];
+            if (i == keep || entry.texture == 0 || entry.loading || entry.residentLevel >= entry.tailLevel) continue;
+            if (entry.lastUsed[entry.residentLevel] >= frame) continue;
+            if (!oldest || entry.lastUsed[entry.residentLevel] < oldest->lastUsed[oldest->residentLevel]) {
+                oldest = &entry;
+            }
+        }
+        if (!oldest) return false;
+
+        freed += levelBytes(*oldest, oldest->residentLevel);
+        evict(*oldest);
+    }
+    return true;
+}
+
+
+void TextureStreamer::evict(Entry& entry) {
+    int level = entry.residentLevel++;
+    size_t bytes = levelBytes(entry, level);
+
+    // o nível deixa de ser amostrado e é reespecificado vazio (libera a memória)
+    GLState::bindTexture(GL_TEXTURE_2D, entry.texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, entry.residentLevel);
+    if (entry.compressed) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, Texture::compressedFormatFor(entry.format), 0, 0, 0, 0, NULL);
+    } else {
+        GLenum format = Texture::formatFor(entry.channels);
+        glTexImage2D(GL_TEXTURE_2D, level, format, 0, 0, 0, format, GL_UNSIGNED_BYTE, NULL);
+    }
+
+    resident -= bytes;
+    Stats::add(STAT_GPU_MEMORY, -(double)bytes);
+    evictedLevels++;
+    frameEvictions++;
+}
+
+
+void TextureStreamer::wait() {
+    JobSystem::wait(tasks);
+}
+
+
+void TextureStreamer::stop() {
+    cancelled = true;
+    JobSystem::wait(tasks);
+    Result result;
+    while (results.pop(result)) {}
+}
+
+
+size_t TextureStreamer::levelBytes(const Entry& entry, int level) const {
+    int width = std::max(1, entry.width >> level);
+    int height = std::max(1, entry.height >> level);
+    if (entry.compressed) return BlockCompression::imageSize(entry.format, width, height);
+    return (size_t)width * height * entry.channels;
+}
+
+
+size_t TextureStreamer::rangeBytes(const Entry& entry, int first, int last) const {
+    size_t bytes = 0;
+    for (int level = first; level <= last; level++) bytes += levelBytes(entry, level);
+    return bytes;
+}
+
+
+int TextureStreamer::tailLevelFor(int width, int height, int levelCount) const {
+    int level = 0;
+    while (level < levelCount - 1 && std::max(width >> level, height >> level) > tailSize) level++;
+    return level;
+}
+
+
+void TextureStreamer::printReport() const {
+    if (!isEnabled()) return;
+
+    size_t full = 0;
+    for (const auto& entry : entries) {
+        if (entry.texture != 0) full += rangeBytes(entry, 0, entry.levelCount - 1);
+    }
+
+    cout << "Streaming de texturas: " << entries.size() << " texturas (" << megabytes(full) << " MB com todos os niveis), "
+         << loadedLevels << " niveis lidos (" << megabytes(streamedBytes) << " MB enviados), " << evictedLevels
+         << " descartados, " << deferredRequests << " pedidos limitados pelo orcamento; pico de "
+         << megabytes(peakResident) << " MB de " << megabytes(budgetBytes) << " MB" << endl;
+}
@@ -0,0 +1,81 @@
+#include "ThreadPool.h"
+#include "Profiler.h"
+
+ThreadPool::ThreadPool() : running(0), stopping(false) {}
+
+ThreadPool::~ThreadPool() { stop(); }
+
+
+void ThreadPool::start(unsigned int threadCount, const string& name) {
+    if (!workers.empty()) return;
+
+    if (threadCount == 0) {
+        unsigned int cores = thread::hardware_concurrency();
+        threadCount = cores > 1 ? cores - 1 : 1;    // um núcleo fica para a thread principal
+    }
+
+    stopping = false;
+    for (unsigned int i = 0; i < threadCount; i++) {
+        workers.emplace_back([this, name, i]() {
+            Profiler::setThreadName(name + " " + to_string(i));
+            workerLoop();
+        });
+    }
+}
+
+
+void ThreadPool::submit(function<void()> task) {
+    if (workers.empty()) {
+        task();
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(queueMutex);
+        tasks.push_back(move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+
+void ThreadPool::wait() {
+    unique_lock<mutex> lock(queueMutex);
+    allDone.wait(lock, [this]() { return tasks.empty() && running == 0; });
+}
+
+
+void ThreadPool::stop() {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+        tasks.clear();
+    }
+    taskAvailable.notify_all();
+
+    for (auto& worker : workers) worker.join();
+    workers.clear();
+}
+
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            taskAvailable.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping) return;
+
+            task = move(tasks.front());
+            tasks.pop_front();
+            running++;
+        }
+
+        task();
+
+        {
+            lock_guard<mutex> lock(queueMutex);
+            running--;
+            if (tasks.empty() && running == 0) allDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,285 @@
+#include "UploadQueue.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+#include "Texture.h"
+#include "Profiler.h"
+#include "Stats.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+    const size_t RING_ALIGNMENT = 256;  // início de cada trecho no anel
+    const double INITIAL_BYTES_PER_MS = 256.0 * 1024.0;    // estimativa conservadora até a primeira medida
+
+    size_t alignUp(size_t value) { return (value + RING_ALIGNMENT - 1) / RING_ALIGNMENT * RING_ALIGNMENT; }
+}
+
+
+UploadQueue::UploadQueue()
+    : frameBytes(4 * 1024 * 1024), frameMs(2.0), ring(0), mapped(nullptr), capacity(0),
+      head(0), used(0), frameRegion(0), frameUploaded(0), bytesPerMs(INITIAL_BYTES_PER_MS) {}
+
+UploadQueue::~UploadQueue() {}  // cleanup() é chamado pelo System enquanto o contexto existe
+
+
+bool UploadQueue::initialize(size_t ringBytes) {
+    if (ring != 0) return true;
+
+    if (!GLExtensions::bufferStorage) {
+        cout << "Upload em partes: envio direto (sem glBufferStorage), " << frameBytes / 1024
+             << " KB / " << frameMs << " ms por frame" << endl;
+        return true;
+    }
+
+    capacity = alignUp(ringBytes > 0 ? ringBytes : 4 * std::max(frameBytes, RING_ALIGNMENT));
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &ring);
+    GLState::bindBuffer(GL_COPY_READ_BUFFER, ring);
+    glBufferStorage(GL_COPY_READ_BUFFER, (GLsizeiptr)capacity, nullptr, flags);
+    mapped = (unsigned char*)glMapBufferRange(GL_COPY_READ_BUFFER, 0, (GLsizeiptr)capacity, flags);
+
+    if (mapped == nullptr) {
+        cerr << "Falha ao mapear o anel de staging; usando envio direto" << endl;
+        GLState::deleteBuffer(ring);
+        ring = 0;
+        capacity = 0;
+        return false;
+    }
+
+    Stats::add(STAT_GPU_MEMORY, (double)capacity);
+    cout << "Upload em partes: anel de staging de " << capacity / 1024 << " KB, " << frameBytes / 1024
+         << " KB / " << frameMs << " ms por frame" << endl;
+    return true;
+}
+
+
+void UploadQueue::uploadBuffer(GLuint buffer, const void* data, size_t size, shared_ptr<void> owner,
+                               function<void()> done) {
+    Job job = {};
+    job.texture = false;
+    job.target = buffer;
+    job.data = (const unsigned char*)data;
+    job.size = size;
+    job.owner = move(owner);
+    job.done = move(done);
+    jobs.push_back(move(job));
+}
+
+
+void UploadQueue::uploadTexture(GLuint texture, int level, int width, int height, int channels,
+                                const unsigned char* data, shared_ptr<void> owner, function<void()> done) {
+    Job job = {};
+    job.texture = true;
+    job.target = texture;
+    job.level = level;
+    job.data = data;
+    job.width = width;
+    job.height = height;
+    job.channels = channels;
+    job.rowHeight = 1;
+    job.rowBytes = (size_t)width * channels;
+    job.size = job.rowBytes * height;
+    job.owner = move(owner);
+    job.done = move(done);
+    jobs.push_back(move(job));
+}
+
+
+void UploadQueue::uploadCompressed(GLuint texture, int level, int width, int height, GLenum format,
+                                   const unsigned char* data, size_t size, shared_ptr<void> owner,
+                                   function<void()> done) {
+    Job job = {};
+    job.texture = true;
+    job.target = texture;
+    job.level = level;
+    job.data = data;
+    job.width = width;
+    job.height = height;
+    job.compressedFormat = format;
+    job.rowHeight = 4;
+    job.rowBytes = size / ((height + 3) / 4);
+    job.size = size;
+    job.owner = move(owner);
+    job.done = move(done);
+    jobs.push_back(move(job));
+}
+
+
+void UploadQueue::update() {
+    frameUploaded = 0;
+    retireRegions();
+    if (jobs.empty()) return;
+
+    PROFILE_SCOPE("UploadQueue::update");
+    auto start = chrono::steady_clock::now();
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);  // linhas das imagens sem preenchimento (ex.: RGB de largura ímpar)
+
+    while (!jobs.empty()) {
+        Job& job = jobs.front();
+
+        if (job.offset < job.size) {
+            if (frameUploaded >= frameBytes) break;
+            auto sliceStart = chrono::steady_clock::now();
+            double elapsed = chrono::duration<double, milli>(sliceStart - start).count();
+            if (elapsed >= frameMs) break;
+
+            // o trecho também é limitado pelo que a vazão medida permite no tempo restante
+            size_t allowance = std::min(frameBytes - frameUploaded,
+                                        std::max(RING_ALIGNMENT, (size_t)((frameMs - elapsed) * bytesPerMs)));
+
+            size_t sent = sendSlice(job, allowance);
+            if (sent == 0) break;   // anel cheio: espera a GPU consumir os frames anteriores
+            frameUploaded += sent;
+
+            double sliceMs = chrono::duration<double, milli>(chrono::steady_clock::now() - sliceStart).count();
+            if (sliceMs > 0.05) bytesPerMs = 0.75 * bytesPerMs + 0.25 * (sent / sliceMs);
+            if (job.offset < job.size) continue;
+        }
+
+        function<void()> done = move(job.done);
+        jobs.pop_front();
+        if (done) done();
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    if (mapped != nullptr) {
+        GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);     // os demais glTexImage2D leem da memória
+        if (frameRegion > 0) {
+            regions.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), frameRegion });
+            frameRegion = 0;
+        }
+    }
+}
+
+
+size_t UploadQueue::sendSlice(Job& job, size_t budget) {
+    size_t remaining = job.size - job.offset;
+
+    // uma linha maior que o anel inteiro (ex.: textura 4K com --upload-budget pequeno) nunca caberia nele:
+    // a textura é enviada direto da memória, uma faixa por vez, com os mesmos limites
+    bool staged = mapped != nullptr && !(job.texture && job.rowBytes > capacity);
+
+    // espaço contíguo disponível no anel: até o fim ou, se maior, a partir do início
+    size_t space = remaining;
+    if (staged) {
+        size_t free = capacity - used;
+        size_t toEnd = capacity - head;
+        space = std::max(std::min(toEnd, free), free > toEnd ? free - toEnd : 0);
+    }
+
+    size_t count = std::min(remaining, budget);
+    if (job.texture) {
+        // faixas de linhas inteiras; ao menos uma linha por frame, mesmo acima do limite
+        size_t rows = std::max<size_t>(1, count / job.rowBytes);
+        rows = std::min(rows, space / job.rowBytes);
+        if (rows == 0) return 0;
+        count = rows * job.rowBytes;
+    } else {
+        count = std::min(count, space);
+        if (count == 0) return 0;
+    }
+
+    const unsigned char* source = job.data + job.offset;
+
+    if (job.texture) {
+        // faixa em texels; a última faixa de blocos pode passar da altura da textura
+        int firstRow = (int)(job.offset / job.rowBytes) * job.rowHeight;
+        int rows = std::min((int)(count / job.rowBytes) * job.rowHeight, job.height - firstRow);
+        const void* pixels = source;
+
+        if (staged) {
+            size_t ringOffset;
+            if (!allocate(count, ringOffset)) return 0;
+            memcpy(mapped + ringOffset, source, count);
+            GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, ring);
+            pixels = (const void*)ringOffset;   // com PBO vinculado, o ponteiro é um deslocamento no buffer
+        } else if (mapped != nullptr) {
+            GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);     // o ponteiro volta a ser da memória
+        }
+
+        GLState::bindTexture(GL_TEXTURE_2D, job.target);
+        if (job.compressedFormat != 0) {
+            glCompressedTexSubImage2D(GL_TEXTURE_2D, job.level, 0, firstRow, job.width, rows, job.compressedFormat,
+                                      (GLsizei)count, pixels);
+        } else {
+            GLenum format = Texture::formatFor(job.channels);
+            glTexSubImage2D(GL_TEXTURE_2D, job.level, 0, firstRow, job.width, rows, format, GL_UNSIGNED_BYTE, pixels);
+        }
+    } else {
+        GLState::bindBuffer(GL_COPY_WRITE_BUFFER, job.target);
+
+        if (mapped != nullptr) {
+            size_t ringOffset;
+            if (!allocate(count, ringOffset)) return 0;
+            memcpy(mapped + ringOffset, source, count);
+            GLState::bindBuffer(GL_COPY_READ_BUFFER, ring);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr)ringOffset,
+                                (GLintptr)job.offset, (GLsizeiptr)count);
+        } else {
+            glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)job.offset, (GLsizeiptr)count, source);
+        }
+    }
+
+    job.offset += count;
+    return count;
+}
+
+
+// Reserva "size" bytes contíguos no anel; o trecho que sobraria no fim é descartado ao voltar ao início
+bool UploadQueue::allocate(size_t size, size_t& offset) {
+    size_t aligned = alignUp(size);
+    size_t waste = head + aligned > capacity ? capacity - head : 0;
+    if (used + waste + aligned > capacity) return false;
+
+    if (waste > 0) head = 0;
+    offset = head;
+    head = (head + aligned) % capacity;
+    used += waste + aligned;
+    frameRegion += waste + aligned;
+    return true;
+}
+
+
+// Libera as regiões cujas cópias a GPU já executou (sem esperar: para na primeira pendente)
+void UploadQueue::retireRegions() {
+    while (!regions.empty()) {
+        GLenum status = glClientWaitSync(regions.front().fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+
+        glDeleteSync(regions.front().fence);
+        used -= regions.front().bytes;
+        regions.pop_front();
+    }
+
+    if (regions.empty() && frameRegion == 0) head = 0;  // anel vazio: recomeça do início
+}
+
+
+size_t UploadQueue::pendingBytes() const {
+    size_t total = 0;
+    for (const auto& job : jobs) total += job.size - job.offset;
+    return total;
+}
+
+
+void UploadQueue::cleanup() {
+    jobs.clear();
+
+    for (auto& region : regions) glDeleteSync(region.fence);
+    regions.clear();
+
+    if (ring != 0) {
+        GLState::bindBuffer(GL_COPY_READ_BUFFER, ring);
+        glUnmapBuffer(GL_COPY_READ_BUFFER);
+        GLState::deleteBuffer(ring);
+        Stats::add(STAT_GPU_MEMORY, -(double)capacity);
+    }
+    ring = 0;
+    mapped = nullptr;
+    capacity = head = used = frameRegion = 0;
+}